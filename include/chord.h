@@ -28,8 +28,24 @@ typedef struct MessageResponse {
     Node node;
     size_t n_successors;
     Node *successors;
+    ChordMessage *message; // The decoded reply, for fields not copied above
 } MessageResponse;
 
+/**
+ * @brief Receives the result of an asynchronous find_successor().
+ *
+ * The node is only valid for the duration of the call, and is NULL if the
+ * lookup could not be carried out.
+ */
+typedef void (*find_successor_callback)(Node *node, void *arg);
+
+/**
+ * @brief Receives the results of find_successors(), nodes[i] owns keys[i].
+ *
+ * Entries are NULL for keys that could not be resolved.
+ */
+typedef void (*find_successors_callback)(size_t n_keys, uint64_t *keys, Node **nodes, void *arg);
+
 void create();
 
 void join();
@@ -44,14 +60,32 @@ void fix_fingers();
 
 void check_predecessor();
 
-Node find_successor(uint64_t id);
+void find_successor(uint64_t id, find_successor_callback callback, void *arg);
+
+/**
+ * @brief Same as find_successor(), with up to alpha walks running at once.
+ *
+ * Each walk starts from a different candidate, the first to resolve the
+ * key answers and the others stop at their next reply. Meant for callers
+ * that care more about latency than about the extra requests.
+ */
+void find_successor_parallel(uint64_t id, int alpha, find_successor_callback callback, void *arg);
+
+void find_successors(uint64_t *keys, size_t n_keys, find_successors_callback callback, void *arg);
 
 Node closest_preceding_node(uint64_t id);
 
-MessageResponse process_chord_msg(int i);
+/**
+ * @brief Handles every datagram one recvmmsg() batch returns.
+ *
+ * Called when select() reports the socket readable.
+ */
+void process_chord_msg(void);
 
 void lookup(uint64_t key);
 
+void lookup_batch(uint64_t *keys, size_t n_keys);
+
 void print_state();
 
 int element_of(uint64_t curr_var, uint64_t r1, uint64_t r2, int is_inclusive);
@@ -72,5 +106,57 @@ void process_input(char *input);
 
 void cleanup();
 
+/*
+ * Lifecycle of the node around the handlers above, for main() and for
+ * programs that embed the node (chord_node.h). The simulator drives the
+ * handlers itself and has none of it.
+ */
+
+/**
+ * @brief Opens the socket and sets up every virtual node from chord_args,
+ *        then creates the ring or starts joining it.
+ *
+ * @return int 0 on success, -1 after printing why not
+ */
+int node_start(void);
+
+/**
+ * @brief Starts workers, the stats endpoint and the maintenance timers,
+ *        once vnode_all_joined().
+ *
+ * @return int 0 on success, -1 after printing why not
+ */
+int node_serve(void);
+
+/**
+ * @brief Runs one reactor iteration, stdin left alone.
+ *
+ * @param max_wait_ms Longest sleep, 0 to not block, -1 until there is something to do
+ * @return int 0 to keep going, -1 on error
+ */
+int node_run_once(int max_wait_ms);
+
+/**
+ * @brief The reactor's epoll instance, readable while node_run_once() has I/O to handle.
+ */
+int node_poll_fd(void);
+
+/**
+ * @brief Stops the workers and maintenance timers, fails every call in
+ *        flight and releases everything the node holds.
+ *
+ * Callbacks of the failed calls run before it returns. Afterwards, or after
+ * a node_start() that failed, node_start() may set up a node again. Only
+ * what was learned about other nodes (round trips, features, replica sets)
+ * and the stats counters carry over.
+ */
+void node_stop(void);
+
+/**
+ * @brief Closes the socket, the checkpoint, the trace log and the streams,
+ *        and frees the virtual nodes. cleanup() does so and exits.
+ */
+void node_release(void);
+
 #endif // CHORD_H
 
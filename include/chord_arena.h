@@ -0,0 +1,73 @@
+#ifndef CHORD_ARENA_H
+#define CHORD_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <protobuf-c/protobuf-c.h>
+
+/**
+ * @brief Bump allocator backing a decoded message and its scratch data.
+ *
+ * Allocations are carved out of one preallocated block and released all at
+ * once by arena_reset(). Requests that do not fit fall back to malloc() and
+ * are freed on the next reset, which also grows the block so the same
+ * message fits next time.
+ */
+struct arena {
+	uint8_t *base;
+	size_t size;
+	size_t used;
+	size_t overflow_size;       // Bytes that went to malloc() since the last reset
+	void *overflow;             // Chain of malloc() fallbacks
+	ProtobufCAllocator allocator;
+};
+
+/**
+ * @brief Allocates the initial block and sets up the protobuf-c allocator.
+ *
+ * @param arena Arena to initialize
+ * @param size Initial block size in bytes
+ * @return int 0 on success, -1 if the block could not be allocated
+ */
+int arena_init(struct arena *arena, size_t size);
+
+/**
+ * @brief Returns size bytes, aligned for any type, valid until arena_reset().
+ */
+void *arena_alloc(struct arena *arena, size_t size);
+
+/**
+ * @brief Releases everything allocated since the last reset.
+ */
+void arena_reset(struct arena *arena);
+
+void arena_destroy(struct arena *arena);
+
+/**
+ * @brief Free list of equally sized objects, for state that lives from a
+ *        request to its reply.
+ *
+ * Released objects are kept for the next pool_get(), up to max_free of
+ * them, so a steady load recycles the same memory. Only an object beyond
+ * that goes back to free(). Not thread-safe.
+ */
+struct pool {
+	size_t size;                // Bytes per object, at least a pointer
+	size_t max_free;            // Released objects kept at most
+	size_t n_free;
+	void *free;                 // Chain of released objects
+};
+
+#define POOL_INIT(object_size, max) { .size = (object_size), .max_free = (max) }
+
+/**
+ * @brief Returns an uninitialised object, NULL if none is free and malloc() fails.
+ */
+void *pool_get(struct pool *pool);
+
+/**
+ * @brief Hands an object from pool_get() back, NULL is ignored.
+ */
+void pool_put(struct pool *pool, void *object);
+
+#endif // CHORD_ARENA_H
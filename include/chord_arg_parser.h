@@ -5,6 +5,13 @@
 #include <arpa/inet.h>
 #include <argp.h>
 
+// How find_successor() resolves keys that are not held by our successor
+enum lookup_mode {
+    LOOKUP_ITERATIVE = 0, // Originator asks every hop itself
+    LOOKUP_RECURSIVE,     // Each hop forwards the request and relays the reply back
+    LOOKUP_TRANSITIVE,    // Each hop forwards the request, the last one replies to the originator
+};
+
 struct chord_arguments {
     uint8_t num_successors;
     uint16_t stablize_period;
@@ -13,6 +20,21 @@ struct chord_arguments {
     struct sockaddr_in my_address;
 	struct sockaddr_in join_address;
     uint64_t id;
+    enum lookup_mode lookup_mode;
+    uint8_t workers;
+    uint8_t replicas;       // Copies of each key kept on the successor list
+    uint8_t write_quorum;   // Copies a put or delete waits for, owner included
+    uint8_t read_quorum;    // Copies a get consults, owner included
+    uint8_t vnodes;         // Ring positions this process owns
+    const char *state_path; // Routing state checkpoint, NULL if not kept
+    uint32_t lookup_deadline; // Milliseconds a lookup may take before it fails
+    uint8_t lookup_hops;    // Requests a lookup may send before it fails
+    uint8_t lookup_alpha;   // Redundant walks behind client lookups
+    uint16_t stats_port;    // Text stats endpoint, network byte order, 0 if not served
+    const char *trace_path; // Binary trace log of sampled lookups, NULL if not kept
+    double trace_rate;      // Fraction of lookups traced
+    uint8_t compact;        // Offer and use compact frames, see chord_wire.h
+    uint8_t stream;         // Offer and use streams for large messages, see chord_stream.h
 };
 
 /**
@@ -25,6 +47,16 @@ struct chord_arguments {
  */
 error_t chord_parser(int key, char *arg, struct argp_state *state);
 
+/**
+ * @brief Validates arguments filled in by hand and resolves their defaults,
+ *        as chord_parseopt() does.
+ *
+ * Port, periods and successor count have no default and must be set.
+ *
+ * @return int 0 if args are usable, -1 after printing why not
+ */
+int chord_check_arguments(struct chord_arguments *args);
+
 /**
  * @brief CLI argument parsing.
  * 
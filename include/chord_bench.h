@@ -0,0 +1,27 @@
+#ifndef CHORD_BENCH_H
+#define CHORD_BENCH_H
+
+#include <inttypes.h>
+#include <stddef.h>
+
+// Lookups a benchmark keeps in flight at most, well inside RPC_MAX_PENDING
+#define BENCH_MAX_CONCURRENCY 64
+
+// Hop counts of at least this many share the last histogram bucket
+#define BENCH_MAX_HOPS 16
+
+/**
+ * @brief Starts timing lookups of Zipf-distributed keys, main thread only.
+ *
+ * Key rank r (1 to n_keys) is drawn with weight 1/r^zipf_s and hashed
+ * from its name like a Lookup command would. Lookups go through
+ * find_successor_parallel() with --alpha walks, concurrency of them at a
+ * time, and a report is printed once all have finished: latency
+ * percentiles, throughput, hops and requests per lookup.
+ *
+ * @return int 0 if started, -1 if a benchmark is already running or the
+ *             parameters are out of range
+ */
+int bench_start(size_t n_lookups, int concurrency, double zipf_s, size_t n_keys);
+
+#endif // CHORD_BENCH_H
@@ -0,0 +1,39 @@
+#ifndef CHORD_CACHE_H
+#define CHORD_CACHE_H
+
+#include <inttypes.h>
+
+#include "chord.pb-c.h"
+
+// Ring intervals remembered at once, the least recently used make room
+#define LOCATION_CACHE_SIZE 1024
+
+// How long a resolved owner is trusted without being confirmed again
+#define LOCATION_CACHE_TTL_MS 10000
+
+/**
+ * @brief Records that owner holds every key in (start, owner.key], main thread only.
+ *
+ * An entry for the same owner is widened and refreshed, entries for nodes
+ * inside the interval contradict it and are dropped.
+ */
+void location_cache_insert(uint64_t start, const Node *owner);
+
+/**
+ * @brief Cached owner of id, main thread only.
+ *
+ * @return int 1 and owner filled in on a hit, 0 on a miss or an expired entry
+ */
+int location_cache_lookup(uint64_t id, Node *owner);
+
+/**
+ * @brief Forgets the interval holding id, after its owner timed out or denied it.
+ */
+void location_cache_invalidate(uint64_t id);
+
+/**
+ * @brief Forgets every interval, for a node about to join some ring afresh.
+ */
+void location_cache_clear(void);
+
+#endif // CHORD_CACHE_H
@@ -0,0 +1,45 @@
+#ifndef CHORD_CHECKPOINT_H
+#define CHORD_CHECKPOINT_H
+
+#include <inttypes.h>
+
+// How often the routing state is copied into the checkpoint file
+#define CHECKPOINT_INTERVAL_MS 1000
+
+// Checkpoints older than this describe a ring that has moved on, they are ignored
+#define CHECKPOINT_MAX_AGE_MS (15 * 60 * 1000)
+
+/**
+ * @brief Maps the checkpoint file, creating it if needed, main thread only.
+ *
+ * Call after vnode_init(). A file from an incompatible build or layout is
+ * reset.
+ *
+ * @return int 0 on success, -1 if the file could not be opened or mapped
+ */
+int checkpoint_open(const char *path);
+
+/**
+ * @brief Loads the checkpointed routing state into the virtual nodes.
+ *
+ * Only virtual nodes whose key matches their checkpoint are restored, which
+ * also loads the measured round-trip times. Every restored entry is then
+ * pinged and forgotten if it does not answer.
+ *
+ * @return int Number of virtual nodes restored
+ */
+int checkpoint_restore(void);
+
+/**
+ * @brief Whether virtual node index came back from the checkpoint.
+ */
+int checkpoint_restored(int index);
+
+/**
+ * @brief Starts copying the routing state to the file every CHECKPOINT_INTERVAL_MS.
+ */
+void checkpoint_start(void);
+
+void checkpoint_close(void);
+
+#endif // CHORD_CHECKPOINT_H
@@ -0,0 +1,65 @@
+#ifndef CHORD_HANDOFF_H
+#define CHORD_HANDOFF_H
+
+#include <inttypes.h>
+#include <arpa/inet.h>
+
+#include "chord.pb-c.h"
+
+// Payload bytes per chunk, a chunk only ends early at a free table slot
+#define HANDOFF_CHUNK_BYTES 16384
+
+// Hard limit on a chunk, keeps a response inside one datagram. A chunk
+// reaching it ends at the last free slot before, unless a single run is larger
+#define HANDOFF_MAX_CHUNK_BYTES 49152
+
+// Pause between chunks, bounds a transfer to roughly 800 KB/s
+#define HANDOFF_INTERVAL_MS 20
+
+// Consecutive unanswered chunk requests before a transfer is abandoned
+#define HANDOFF_MAX_RETRIES 10
+
+// How long a leaving node waits for its successor to take its keys
+#define HANDOFF_LEAVE_TIMEOUT_MS 30000
+
+/**
+ * @brief Pulls the keys in (start, end] from source, main thread only.
+ *
+ * The range moves in chunks of about HANDOFF_CHUNK_BYTES, one in flight
+ * at a time and HANDOFF_INTERVAL_MS apart. Every chunk names the cursor it
+ * continues from, so an unanswered request is simply repeated. Entries only
+ * replace local copies with an older version, tombstones move like values.
+ * Once every chunk is in, source is told to release the range, which it
+ * drops unless it keeps replicas.
+ */
+void handoff_start(Node *source, uint64_t start, uint64_t end);
+
+/**
+ * @brief Node still holding id while it is being pulled here, if any.
+ *
+ * Reads that miss locally consult it, so keys stay readable during a move.
+ */
+Node *handoff_source(uint64_t id);
+
+/**
+ * @brief Leaves the ring gracefully.
+ *
+ * Asks the successor to pull this node's keys and exits once it released
+ * them, or after HANDOFF_LEAVE_TIMEOUT_MS.
+ */
+void handoff_leave(void);
+
+/**
+ * @brief Abandons every transfer and a leave in progress, for a node that
+ *        is shutting down.
+ */
+void handoff_stop(void);
+
+/**
+ * @brief Answers handoff and leave requests.
+ *
+ * @return int 1 if the message was one, 0 otherwise
+ */
+int handoff_handle_request(ChordMessage *message, struct sockaddr_in *from);
+
+#endif // CHORD_HANDOFF_H
@@ -5,7 +5,10 @@
 #include "chord.h"
 #include "chord.pb-c.h"
 
-// External declarations for global variables used by these functions
+// External declarations for global variables used by these functions.
+// Routing state is the main thread's working copy of the active virtual
+// node (chord_vnode.h), other threads read published snapshots instead
+// (chord_routing.h)
 extern uint64_t hash;
 extern Node predecessor;
 extern Node successor;
@@ -16,18 +19,42 @@ extern int sockfd;
 extern struct chord_arguments chord_args;
 extern int succListIndex;
 extern int fixIndex;
+extern int joined;
+extern int stabilize_in_flight;
+extern int fix_fingers_in_flight;
+extern int check_predecessor_in_flight;
+extern Node checked_predecessor;
 
 // External declarations for functions used by these functions
 extern int element_of(uint64_t curr_var, uint64_t r1, uint64_t r2, int is_inclusive);
-extern MessageResponse process_chord_msg(int i);
+extern void process_chord_msg(void);
 extern void notify(void);
 
 // Function declarations
-Node find_successor(uint64_t id);
+void find_successor(uint64_t id, find_successor_callback callback, void *arg);
+void find_successor_parallel(uint64_t id, int alpha, find_successor_callback callback, void *arg);
+/**
+ * @brief Cost of the lookup whose find_successor() callback is running.
+ *
+ * Only requests this node sent count, hops a recursive lookup is forwarded
+ * over are not seen here.
+ *
+ * @param hops Set to the requests the answering walk sent, 0 if answered locally
+ * @param requests Set to the requests all of the lookup's walks sent, retries included
+ */
+void find_successor_cost(int *hops, int *requests);
+void find_successors(uint64_t *keys, size_t n_keys, find_successors_callback callback, void *arg);
 Node closest_preceding_node(uint64_t id);
 void stabilize(void);
 void fix_fingers(void);
+void fix_all_fingers(void);
 void fix_successor_list(void);
 
+/**
+ * @brief Digest of n successor list entries, lets a stabilize exchange
+ *        leave out a list the requester already holds.
+ */
+uint64_t successor_list_digest(const Node *list, size_t n);
+
 #endif // CHORD_IMPL_H
 
@@ -0,0 +1,161 @@
+#ifndef CHORD_KV_H
+#define CHORD_KV_H
+
+#include <stddef.h>
+#include <inttypes.h>
+#include <arpa/inet.h>
+
+#include "chord.pb-c.h"
+
+// Slots the local store starts with (power of two), it doubles as it fills
+#define KV_INITIAL_CAPACITY 1024
+
+// How long a tombstone outlives its delete, a replica that missed the
+// delete is outvoted until then
+#define KV_TOMBSTONE_TTL_MS 600000
+
+// Slots kv_store_collect() looks at per call
+#define KV_COLLECT_SLOTS 256
+
+// Owners whose replica sets are remembered for stale reads, and how many
+// replicas of each
+#define KV_REPLICA_SETS 256
+#define KV_MAX_KNOWN_REPLICAS 8
+
+// How long a reported replica set is trusted
+#define KV_REPLICA_SET_TTL_MS 10000
+
+enum kv_status {
+    KV_OK,
+    KV_NOT_FOUND,
+    KV_FAILED,    // Owner unreachable or quorum not reached
+};
+
+/**
+ * @brief An entry of the local store, key bytes followed by value bytes.
+ */
+struct kv_item {
+    uint64_t id;
+    uint64_t version;   // Assigned by the owner, newer writes win on replicas
+    int deleted;        // Tombstone left by a delete, no value
+    size_t key_len;
+    size_t value_len;
+    uint8_t data[];
+};
+
+static inline const uint8_t *kv_item_key(const struct kv_item *item) {
+    return item->data;
+}
+
+static inline const uint8_t *kv_item_value(const struct kv_item *item) {
+    return item->data + item->key_len;
+}
+
+/**
+ * @brief Receives the outcome of kv_put(), kv_get() or kv_delete().
+ *
+ * value is only set for a successful get and is only valid during the call.
+ */
+typedef void (*kv_callback)(enum kv_status status, const uint8_t *value, size_t value_len, void *arg);
+
+/**
+ * @brief Stores a value in this node's slice of the keyspace (or a replica
+ *        of another node's), replacing any previous value for the key.
+ *
+ * The store is an open addressing table with linear probing, keyed by the
+ * key's ring id and compared on the full key. Main thread only, like
+ * everything in this file.
+ *
+ * @return int 0 on success, -1 if memory ran out
+ */
+int kv_store_put(uint64_t id, const uint8_t *key, size_t key_len, const uint8_t *value, size_t value_len,
+                 uint64_t version);
+
+/**
+ * @brief Replaces any value for the key with a tombstone of the given
+ *        version, which kv_store_collect() drops once it is old enough.
+ *
+ * @return int 0 on success, -1 if memory ran out
+ */
+int kv_store_tombstone(uint64_t id, const uint8_t *key, size_t key_len, uint64_t version);
+
+/**
+ * @brief Looks a key up in the local store.
+ *
+ * @return const struct kv_item* The entry, valid until the store is next
+ *                               modified, or NULL. It may be a tombstone.
+ */
+const struct kv_item *kv_store_get(uint64_t id, const uint8_t *key, size_t key_len);
+
+/**
+ * @brief Removes a key from the local store.
+ *
+ * @return int 1 if the key was present, 0 otherwise
+ */
+int kv_store_delete(uint64_t id, const uint8_t *key, size_t key_len);
+
+size_t kv_store_count(void);
+
+/**
+ * @brief Drops tombstones older than KV_TOMBSTONE_TTL_MS, looking at
+ *        KV_COLLECT_SLOTS slots per call and resuming where it stopped.
+ */
+void kv_store_collect(void);
+
+/**
+ * @brief Frees every entry and the table, the store starts out empty again.
+ */
+void kv_store_clear(void);
+
+/**
+ * @brief Walks the store slot by slot, for scans that span several calls.
+ *
+ * Slot positions hold as long as kv_store_generation() does, a resize
+ * reshuffles every entry. Deletes may shift an entry back by a few slots
+ * within its probe run, never across a free slot.
+ *
+ * @return const struct kv_item* The entry in the slot, NULL if it is free
+ */
+const struct kv_item *kv_store_slot(size_t slot);
+
+size_t kv_store_capacity(void);
+
+uint64_t kv_store_generation(void);
+
+/**
+ * @brief Stores a value on the node owning id.
+ *
+ * The owner is resolved with find_successor(), the value then travels to it
+ * in a single datagram. With --replicas the owner copies it to that many
+ * successors and answers once --wq copies (its own included) are stored.
+ * key and value are copied.
+ */
+void kv_put(uint64_t id, const uint8_t *key, size_t key_len, const uint8_t *value, size_t value_len,
+            kv_callback callback, void *arg);
+
+/**
+ * @brief Reads a value from the node owning id.
+ *
+ * The owner consults --rq copies and returns the newest. With allow_stale
+ * any single replica may answer instead: a local copy if this node holds
+ * one, otherwise the nearest by round trip among the owner and the
+ * replicas the owner reported in an earlier answer.
+ */
+void kv_get(uint64_t id, const uint8_t *key, size_t key_len, int allow_stale, kv_callback callback, void *arg);
+
+void kv_delete(uint64_t id, const uint8_t *key, size_t key_len, kv_callback callback, void *arg);
+
+/**
+ * @brief Answers put, get and delete requests, coordinating replicas for
+ *        keys this node owns.
+ *
+ * Requests for keys outside (predecessor, self] fail, the requester's
+ * lookup was out of date. Replica requests are answered from the local copy.
+ *
+ * @param message Decoded request
+ * @param from Address the request came from, the reply goes there
+ * @return int 1 if the message was a store request, 0 otherwise
+ */
+int kv_handle_request(ChordMessage *message, struct sockaddr_in *from);
+
+#endif // CHORD_KV_H
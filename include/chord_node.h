@@ -0,0 +1,122 @@
+#ifndef CHORD_NODE_H
+#define CHORD_NODE_H
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <arpa/inet.h>
+
+#include "chord_arg_parser.h"
+
+/*
+ * The node as a library (libchord.a), for programs that resolve keys in
+ * process rather than through the command line. The program owns the
+ * loop: it waits on chord_node_fd() for at most chord_node_timeout() and
+ * then calls chord_node_poll(), or simply calls chord_node_poll() with a
+ * timeout of its own. Callbacks run inside chord_node_poll(), or inside the
+ * call that started the lookup if no request was needed.
+ *
+ * The node keeps its routing state in the process, as the command line
+ * does: one node per process at a time, every call from the thread that
+ * created it. Once it is destroyed, or a create failed, another node may be
+ * created.
+ */
+struct chord_node;
+
+// Node a key belongs to
+struct chord_location {
+    uint64_t key;               // The node's position on the ring
+    struct sockaddr_in address; // Where it receives messages
+};
+
+/**
+ * @brief Receives the owner of a key from chord_lookup_async().
+ *
+ * @param owner NULL if the lookup failed, only valid during the call
+ */
+typedef void (*chord_lookup_callback)(struct chord_node *node, uint64_t key, const struct chord_location *owner,
+                                      void *arg);
+
+/**
+ * @brief Receives the owners of a batch from chord_lookup_batch_async(),
+ *        owners[i] owns keys[i].
+ *
+ * Entries are NULL for keys that could not be resolved, everything is only
+ * valid during the call.
+ */
+typedef void (*chord_lookup_batch_callback)(struct chord_node *node, size_t n_keys, const uint64_t *keys,
+                                            const struct chord_location *const *owners, void *arg);
+
+/**
+ * @brief Starts a node and creates or joins its ring, without blocking.
+ *
+ * args is what the command line would have parsed: my_address (port
+ * required), join_address (sin_family AF_INET to join, 0 to create a
+ * ring), the three periods and num_successors must be set. The rest may be
+ * left 0 for the defaults.
+ *
+ * @return struct chord_node* NULL if args are invalid, the node could not
+ *                            be set up or another node of this process has
+ *                            yet to be destroyed
+ */
+struct chord_node *chord_node_create(const struct chord_arguments *args);
+
+/**
+ * @brief Stops the node, it leaves the ring as if it had failed.
+ *
+ * Lookups still in flight fail first, their callbacks run before this
+ * returns.
+ */
+void chord_node_destroy(struct chord_node *node);
+
+/**
+ * @brief Handles whatever I/O is ready and whatever timers are due.
+ *
+ * @param timeout_ms Longest wait for I/O, 0 to return at once, -1 to wait
+ *                   until there is something to do
+ * @return int 0 to keep going, -1 if the node failed
+ */
+int chord_node_poll(struct chord_node *node, int timeout_ms);
+
+/**
+ * @brief File descriptor that is readable while the node has I/O to
+ *        handle, for the program's own poll() or epoll.
+ */
+int chord_node_fd(const struct chord_node *node);
+
+/**
+ * @brief Milliseconds until the node has timers due, -1 if none.
+ */
+int64_t chord_node_timeout(const struct chord_node *node);
+
+/**
+ * @brief Whether the node is part of its ring, lookups fail until it is.
+ */
+int chord_node_joined(const struct chord_node *node);
+
+/**
+ * @brief Key of a name, as the Lookup, Put and Get commands hash it.
+ */
+uint64_t chord_node_key(const void *name, size_t len);
+
+/**
+ * @brief Looks up the node owning key, within --deadline and --hops.
+ *
+ * @return int 0 if started, callback runs exactly once; -1 if the node has
+ *             not joined yet or is out of memory, callback does not run
+ */
+int chord_lookup_async(struct chord_node *node, uint64_t key, chord_lookup_callback callback, void *arg);
+
+/**
+ * @brief Looks up the owners of n_keys keys, those sharing a next hop in
+ *        the same request.
+ *
+ * keys is copied. Every key is held to the same deadline and hop budget as
+ * a single lookup, and one whose next hop fails is looked up on its own. So
+ * once started, callback runs exactly once for the whole batch.
+ *
+ * @return int 0 if started, -1 as for chord_lookup_async()
+ */
+int chord_lookup_batch_async(struct chord_node *node, const uint64_t *keys, size_t n_keys,
+                             chord_lookup_batch_callback callback, void *arg);
+
+#endif // CHORD_NODE_H
@@ -0,0 +1,94 @@
+#ifndef CHORD_PEER_H
+#define CHORD_PEER_H
+
+#include <inttypes.h>
+#include <stddef.h>
+
+// Peers whose round-trip times are tracked at once (power of two)
+#define PEER_TABLE_SIZE 1024
+
+// Slots probed for a peer before the least recently heard of one is replaced
+#define PEER_PROBE_LIMIT 8
+
+// Weight of a new sample in the smoothed round-trip time, 1/8 as in TCP
+#define PEER_RTT_ALPHA_SHIFT 3
+
+// Messages closer together than this count as one heartbeat
+#define PEER_HEARTBEAT_MIN_MS 10
+
+// Heartbeat intervals needed before phi means anything
+#define PEER_MIN_INTERVALS 3
+
+// Floor on the interval deviation, so a very regular peer is not failed for jitter
+#define PEER_MIN_DEVIATION_MS 50
+
+// Suspicion at which a missed reply counts, and at which silence alone does
+#define PEER_PHI_SUSPECT 3.0
+#define PEER_PHI_FAILED 8.0
+
+enum peer_status {
+    PEER_ALIVE,     // Heard from recently, a missed reply is put down to loss
+    PEER_SUSPECT,   // Overdue or never heard from, a missed reply means it is gone
+    PEER_FAILED,    // Silent for far longer than it has ever been
+};
+
+// One peer's estimate as exported for a checkpoint
+struct peer_record {
+    uint32_t address;
+    uint32_t port;
+    uint64_t srtt_us;
+};
+
+/**
+ * @brief Folds one measured round trip into a peer's estimate, main thread only.
+ *
+ * @param address Peer address, network byte order as in Node
+ * @param port Peer port, network byte order as in Node
+ * @param rtt_us Time from sending the request to receiving its reply
+ */
+void peer_rtt_sample(uint32_t address, uint32_t port, uint64_t rtt_us);
+
+/**
+ * @brief Smoothed round-trip time to a peer in microseconds, main thread only.
+ *
+ * @return uint64_t 0 if nothing was ever measured
+ */
+uint64_t peer_rtt(uint32_t address, uint32_t port);
+
+/**
+ * @brief Records that a peer sent something, main thread only.
+ *
+ * Every received message counts, so requests it serves double as
+ * heartbeats and quiet links are the only ones that get probed.
+ */
+void peer_heard(uint32_t address, uint32_t port);
+
+/**
+ * @brief Phi-accrual suspicion of a peer, main thread only.
+ *
+ * -log10 of the chance that a live peer stays silent this long, given the
+ * mean and deviation of the intervals it has been heard at so far.
+ *
+ * @return double 0 until PEER_MIN_INTERVALS intervals were seen
+ */
+double peer_phi(uint32_t address, uint32_t port);
+
+/**
+ * @brief What peer_phi() says about a peer, PEER_SUSPECT if it has no history.
+ */
+enum peer_status peer_status(uint32_t address, uint32_t port);
+
+/**
+ * @brief Copies out every tracked peer, main thread only.
+ *
+ * @param records Room for PEER_TABLE_SIZE entries
+ * @return size_t Number of entries written
+ */
+size_t peer_export(struct peer_record *records);
+
+/**
+ * @brief Seeds estimates from a checkpoint, measured peers keep theirs.
+ */
+void peer_import(const struct peer_record *records, size_t n_records);
+
+#endif // CHORD_PEER_H
@@ -0,0 +1,110 @@
+#ifndef CHORD_ROUTING_H
+#define CHORD_ROUTING_H
+
+#include <inttypes.h>
+#include <arpa/inet.h>
+
+#include "chord.pb-c.h"
+
+// Finger table size (M) and the largest successor list (-r) a snapshot holds
+#define ROUTING_FINGERS 64
+#define ROUTING_MAX_SUCCESSORS 32
+
+// Routing candidates per snapshot: every finger plus the successor list
+#define ROUTING_CANDIDATES (ROUTING_FINGERS + ROUTING_MAX_SUCCESSORS)
+
+// Threads that may read snapshots concurrently with the main thread
+#define ROUTING_MAX_READERS 64
+
+/**
+ * @brief Immutable copy of the routing state requests are answered from.
+ *
+ * The main thread owns the live globals and publishes a new snapshot
+ * whenever they change. A published snapshot is never modified, it is freed
+ * once no reader can still hold it.
+ */
+struct routing_snapshot {
+    uint64_t hash;
+    Node self;
+    Node predecessor;
+    Node successor;
+    int num_successors;
+    Node finger_table[ROUTING_FINGERS];
+    Node successor_list[ROUTING_MAX_SUCCESSORS];
+
+    // Structure-of-arrays copy of the candidates for the closest preceding
+    // node scan, empty entries hold hash so they never qualify
+    uint64_t candidate_keys[ROUTING_CANDIDATES];
+    uint32_t candidate_addresses[ROUTING_CANDIDATES];
+    uint32_t candidate_ports[ROUTING_CANDIDATES];
+
+    // Reclamation bookkeeping, not part of the routing state
+    uint64_t retire_epoch;
+    struct routing_snapshot *next_retired;
+};
+
+/**
+ * @brief Publishes the live routing state of every virtual node that
+ *        changed, main thread only.
+ *
+ * Swaps the current snapshot with one atomic store and frees retired
+ * snapshots no reader can still see.
+ */
+void routing_publish(void);
+
+/**
+ * @brief The active virtual node's current snapshot, main thread only.
+ *
+ * Needs no protection, snapshots are only freed from routing_publish().
+ */
+const struct routing_snapshot *routing_current(void);
+
+/**
+ * @brief Registers the calling thread as a snapshot reader.
+ *
+ * @return int 0 on success, -1 if ROUTING_MAX_READERS are registered
+ */
+int routing_reader_register(void);
+
+/**
+ * @brief Frees every snapshot and forgets the readers, main thread only,
+ *        once no other thread reads them.
+ */
+void routing_reset(void);
+
+/**
+ * @brief Pins the current snapshots for a registered reader.
+ *
+ * Lock-free, snapshots loaded with routing_pinned() stay valid until
+ * routing_release().
+ */
+void routing_acquire(void);
+
+/**
+ * @brief A virtual node's snapshot, between routing_acquire() and routing_release().
+ */
+const struct routing_snapshot *routing_pinned(int vnode);
+
+void routing_release(void);
+
+/**
+ * @brief Closest finger or successor list entry preceding id, or self if
+ *        there is none.
+ */
+Node routing_closest_preceding_node(const struct routing_snapshot *snapshot, uint64_t id);
+
+/**
+ * @brief Answers a request that only reads routing state.
+ *
+ * Covers find successor (unless it has to be forwarded), find successors,
+ * get predecessor, get successor list and check predecessor requests. It is
+ * safe to call from any thread holding a snapshot.
+ *
+ * @param message Decoded request
+ * @param from Address the request came from, replies go there
+ * @param snapshot Routing state to answer from
+ * @return int 1 if the request was answered, 0 if it needs the main thread
+ */
+int answer_query(ChordMessage *message, struct sockaddr_in *from, const struct routing_snapshot *snapshot);
+
+#endif // CHORD_ROUTING_H
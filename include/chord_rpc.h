@@ -0,0 +1,273 @@
+#ifndef CHORD_RPC_H
+#define CHORD_RPC_H
+
+#include <inttypes.h>
+#include <arpa/inet.h>
+#include <sys/uio.h>
+
+#include "chord.h"
+#include "chord.pb-c.h"
+
+// Maximum number of RPCs that may be in flight at once (power of two)
+#ifndef RPC_MAX_PENDING
+#define RPC_MAX_PENDING 256
+#endif
+
+// Largest datagram the node sends or accepts, length prefix included
+#define MAX_DATAGRAM_SIZE 65507
+
+// Datagrams received per recvmmsg() call
+#define RECV_BATCH 32
+
+// Milliseconds to wait for a reply before an RPC is considered timed out
+#define RPC_TIMEOUT_MS 1000
+
+// Client requests that waited this long in the socket buffer are turned
+// down with a BusyResponse, their caller still has time for another hop
+#define RPC_BUSY_AFTER_MS (RPC_TIMEOUT_MS / 4)
+
+// Client requests older than this are dropped unanswered, their caller
+// has given up on them
+#define RPC_DEADLINE_MS RPC_TIMEOUT_MS
+
+/*
+ * Received messages are served by class, a whole batch of one class before
+ * the next, so ring maintenance and the replies to our own calls are never
+ * stuck behind a backlog of lookups. Only client requests are ever shed.
+ */
+enum rpc_class {
+    RPC_CLASS_MAINTENANCE,      // Replies and ring maintenance
+    RPC_CLASS_CLIENT,           // Lookups and key-value requests
+    RPC_CLASSES
+};
+
+/**
+ * @brief Completion callback for an outgoing RPC.
+ *
+ * Invoked exactly once per call: with the decoded reply, with a response
+ * whose type is CHORD_MESSAGE__MSG_BUSY_RESPONSE if the peer was too
+ * backlogged to serve it, or with one whose type is
+ * CHORD_MESSAGE__MSG__NOT_SET if the peer did not answer in time.
+ * The response (and anything it points to) is only valid during the callback.
+ */
+typedef void (*rpc_callback)(MessageResponse *response, void *arg);
+
+/**
+ * @brief Carries one datagram in place of the socket.
+ *
+ * @param from The sending node's address
+ * @param to Destination address
+ * @param frames Length-prefixed frames making up the datagram, only valid during the call
+ */
+typedef void (*rpc_transport)(const struct sockaddr_in *from, const struct sockaddr_in *to,
+                              const struct iovec *frames, size_t n_frames);
+
+/**
+ * @brief Sets up the calling thread's buffers for sending and receiving on fd.
+ *
+ * Every thread doing I/O calls this once with its own socket. Sends,
+ * receives and message arenas are per thread. The pending-RPC table
+ * (rpc_call(), rpc_complete()) and the timers behind it belong to the main
+ * thread only.
+ *
+ * @return int 0 on success, -1 if the buffers could not be allocated
+ */
+int rpc_init(int fd);
+
+void rpc_destroy(void);
+
+/**
+ * @brief Hands every datagram rpc_flush() sends to deliver instead of the socket.
+ *
+ * For the simulator, which runs many nodes over one main thread: each
+ * datagram is sent from the node that was active when it was queued.
+ */
+void rpc_use_transport(rpc_transport deliver);
+
+/**
+ * @brief Makes the next recv_batch() return this one datagram instead of reading the socket.
+ */
+void rpc_inject(const struct sockaddr_in *from, const uint8_t *data, size_t len);
+
+/**
+ * @brief Drains up to RECV_BATCH datagrams from sockfd with one recvmmsg().
+ *
+ * The datagrams stay in their receive slots until the next call.
+ *
+ * @return size_t Number of datagrams received, 0 if none were waiting
+ */
+size_t recv_batch(void);
+
+/**
+ * @brief Locates the next frame in a receive slot, length-prefixed
+ *        protobuf or compact.
+ *
+ * @param slot Index below the count recv_batch() returned
+ * @param offset Position of the next frame, advanced past it
+ * @param from Set to the sender's address
+ * @param frame Set to the encoded message, valid until the next recv_batch()
+ * @param frame_len Set to its length
+ * @return int 1 if a frame was found, 0 at the end of the datagram or if
+ *             the rest of it is malformed
+ */
+int recv_frame(size_t slot, size_t *offset, struct sockaddr_in *from, const uint8_t **frame, size_t *frame_len);
+
+/**
+ * @brief Decodes an encoded message into the calling thread's arena.
+ *
+ * @return ChordMessage* Valid until release_message(), NULL if malformed
+ */
+ChordMessage *decode_message(const uint8_t *data, size_t len);
+
+/**
+ * @brief Accounts for a message decode_message() returned from a receive
+ *        slot, recv_message() does so itself.
+ *
+ * Counts it and notes the features from advertised.
+ */
+void rpc_received(const ChordMessage *message, const struct sockaddr_in *from);
+
+/**
+ * @brief Features a peer advertised, any thread.
+ *
+ * @return uint32_t WIRE_FEATURE_* bits, 0 if the peer never advertised any
+ *                  or was evicted by another
+ */
+uint32_t rpc_peer_features(uint32_t address, uint32_t port);
+
+/**
+ * @brief Stops assuming a peer accepts features, until it advertises them again.
+ */
+void rpc_forget_features(uint32_t address, uint32_t port, uint32_t features);
+
+/**
+ * @brief Decodes the next message of a class in a receive slot filled by
+ *        recv_batch().
+ *
+ * A datagram carries one or more messages back to back, length-prefixed or
+ * compact, offset tracks the position within it and starts at 0 for each
+ * slot and class. Messages of other classes are skipped, those rpc_shed()
+ * turns down are answered or dropped on the way.
+ * The message is decoded into a reusable arena rather than the heap and
+ * stays valid until release_message(), which must be called before the
+ * next message is decoded.
+ *
+ * @param slot Index below the count recv_batch() returned
+ * @param offset Position of the next message, advanced past it
+ * @param from Set to the sender's address
+ * @return ChordMessage* Decoded message, NULL at the end of the datagram or
+ *                       if the rest of it is malformed
+ */
+ChordMessage *recv_message(size_t slot, size_t *offset, struct sockaddr_in *from, enum rpc_class class);
+
+/**
+ * @brief Class of an encoded message, read without decoding it.
+ */
+enum rpc_class rpc_frame_class(const uint8_t *frame, size_t len);
+
+/**
+ * @brief Turns down a client request that waited too long in the socket
+ *        buffer: past RPC_BUSY_AFTER_MS with a BusyResponse, past
+ *        RPC_DEADLINE_MS silently.
+ *
+ * Waiting is measured from the kernel's receive time of the datagram.
+ *
+ * @param slot Receive slot message was decoded from
+ * @return int 1 if the message was shed and must not be served, 0 otherwise
+ */
+int rpc_shed(size_t slot, ChordMessage *message, const struct sockaddr_in *from);
+
+/**
+ * @brief Scratch memory that lives as long as the current received message.
+ */
+void *message_scratch(size_t size);
+
+/**
+ * @brief Releases the current received message and its scratch memory.
+ */
+void release_message(void);
+
+/**
+ * @brief Packs a one-way message (notify, replies) and queues it for an address.
+ *
+ * Nothing is sent until rpc_flush(). Notify, get predecessor, get successor
+ * list and check predecessor requests to the same peer share a datagram
+ * where they fit.
+ *
+ * @return int 0 if queued, -1 if the message was dropped because the send
+ *             queue is full (the socket is applying backpressure) or it is
+ *             too large for a datagram
+ */
+int send_message(struct sockaddr_in *addr, ChordMessage *msg, const char *error_msg);
+
+/**
+ * @brief Same as send_message(), addressed to a node (and tagged with its
+ *        key, so the right virtual node gets it).
+ */
+int send_message_to_node(Node *node, ChordMessage *msg, const char *error_msg);
+
+/**
+ * @brief Sends everything queued with sendmmsg().
+ *
+ * Called once per event-loop iteration. Datagrams the socket cannot take
+ * right now stay queued for the next flush, a datagram that fails outright
+ * is reported and dropped.
+ */
+void rpc_flush(void);
+
+/**
+ * @brief Whether datagrams are still queued after the last flush.
+ *
+ * The event loop then also waits for the socket to become writable.
+ */
+int rpc_output_pending(void);
+
+/**
+ * @brief Sends a request to a node and registers a callback for its reply.
+ *
+ * Assigns msg a fresh query_id and records it in the pending-request table.
+ * The callback runs from the event loop once the reply arrives or
+ * RPC_TIMEOUT_MS passes, with the calling virtual node active again.
+ * Replies to requests the peer answers by itself also feed its round-trip
+ * estimate (chord_peer.h).
+ *
+ * @param node Destination node
+ * @param msg Request to send, query_id and target are overwritten
+ * @param expected_type Response type that completes the call
+ * @param callback Completion callback
+ * @param arg Opaque argument passed to callback
+ * @return int 0 if the call was queued, -1 if the pending table or send
+ *             queue is full, in which case the callback will never run
+ */
+int rpc_call(Node *node, ChordMessage *msg, ChordMessage__MsgCase expected_type,
+             rpc_callback callback, void *arg);
+
+/**
+ * @brief Same as rpc_call(), for a destination that is only known by address.
+ */
+int rpc_call_addr(struct sockaddr_in *addr, ChordMessage *msg, ChordMessage__MsgCase expected_type,
+                  rpc_callback callback, void *arg);
+
+/**
+ * @brief Hands a received response to the RPC waiting for it.
+ *
+ * Matches on query_id, or for peers that do not echo it, on the oldest call
+ * to the same address expecting this response type.
+ *
+ * @param message The decoded message as received
+ * @param from Address the message came from
+ * @param response Decoded response passed to the callback
+ * @return int 1 if a pending call was completed, 0 if the reply was unsolicited
+ */
+int rpc_complete(ChordMessage *message, struct sockaddr_in *from, MessageResponse *response);
+
+/**
+ * @brief Fails every pending call as if it had timed out, for a node that
+ *        is shutting down.
+ *
+ * Callbacks run before this returns, calls they try to make meanwhile fail
+ * at once.
+ */
+void rpc_cancel_all(void);
+
+#endif // CHORD_RPC_H
@@ -0,0 +1,127 @@
+#ifndef CHORD_STATS_H
+#define CHORD_STATS_H
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <arpa/inet.h>
+
+#include "chord.pb-c.h"
+
+// Threads with counters of their own, every I/O thread is the main thread or
+// a routing reader. Threads beyond that share one last shard.
+#define STATS_MAX_SHARDS 66
+
+// Message types counted apart, above the largest ChordMessage field number
+#define STATS_MESSAGE_TYPES 64
+
+// Histogram buckets, log2 buckets reach past half an hour in microseconds
+#define STATS_BUCKETS 32
+
+// How long stats_serve() waits on a client that connected but sent nothing
+#define STATS_SCRAPE_TIMEOUT_MS 100
+
+enum stats_counter {
+    STATS_DATAGRAMS_IN,
+    STATS_DATAGRAMS_OUT,
+    STATS_BYTES_IN,
+    STATS_BYTES_OUT,
+    STATS_RPC_CALLS,
+    STATS_RPC_TIMEOUTS,
+    STATS_LOOKUPS,
+    STATS_LOOKUPS_FAILED,
+    STATS_STABILIZE_ROUNDS,
+    STATS_FIX_FINGERS_ROUNDS,
+    STATS_SUCCESSOR_CHANGES,    // Published snapshots whose successor differs from the last
+    STATS_PREDECESSOR_CHANGES,
+    STATS_FINGER_CHANGES,       // Finger entries that differ from the last published snapshot
+    STATS_REQUESTS_BUSY,        // Requests turned down with a busy reply, see rpc_shed()
+    STATS_REQUESTS_DROPPED,     // Requests dropped unanswered, past their deadline
+    STATS_COUNTERS
+};
+
+enum stats_histogram {
+    STATS_RPC_LATENCY_US,       // Replies only, timeouts are counted apart
+    STATS_LOOKUP_LATENCY_US,    // Lookups that found the owner
+    STATS_LOOKUP_HOPS,          // Linear, bucket i is i hops
+    STATS_HISTOGRAMS
+};
+
+struct stats_histogram_totals {
+    uint64_t buckets[STATS_BUCKETS];
+    uint64_t count;
+    uint64_t sum;
+};
+
+// Everything counted so far, summed over all threads
+struct stats_totals {
+    uint64_t counters[STATS_COUNTERS];
+    uint64_t messages_in[STATS_MESSAGE_TYPES];
+    uint64_t messages_out[STATS_MESSAGE_TYPES];
+    struct stats_histogram_totals histograms[STATS_HISTOGRAMS];
+};
+
+/**
+ * @brief Adds n to a counter, any thread.
+ *
+ * Every thread counts into a cache-line aligned shard of its own with plain
+ * relaxed stores, so counting costs no locked instruction and no shared
+ * cache line. Readers sum the shards.
+ */
+void stats_add(enum stats_counter counter, uint64_t n);
+
+/**
+ * @brief Counts one decoded or one sent message by its type, any thread.
+ */
+void stats_message_in(ChordMessage__MsgCase type);
+
+void stats_message_out(ChordMessage__MsgCase type);
+
+/**
+ * @brief Records one value in a histogram, any thread.
+ */
+void stats_observe(enum stats_histogram histogram, uint64_t value);
+
+/**
+ * @brief Sums every thread's shard, any thread.
+ *
+ * Shards are read without stopping their writers, so each total is
+ * consistent on its own but not across counters.
+ */
+void stats_collect(struct stats_totals *totals);
+
+/**
+ * @brief Formats the totals as Prometheus text exposition.
+ *
+ * @param buffer Where the text goes, NUL-terminated
+ * @param size Room in buffer, output that does not fit is cut short
+ * @return size_t Length of the whole text, as snprintf() counts it
+ */
+size_t stats_format(char *buffer, size_t size);
+
+/**
+ * @brief Answers a StatsRequest with this node's totals.
+ *
+ * @param message Decoded request
+ * @param from Address the request came from, the reply goes there
+ * @return int 1 if the message was a stats request, 0 otherwise
+ */
+int stats_handle_request(ChordMessage *message, struct sockaddr_in *from);
+
+/**
+ * @brief Opens the text scrape endpoint, a TCP listener answering any
+ *        HTTP request with stats_format().
+ *
+ * @param addr Address and port to listen on
+ * @return int The listening socket, -1 on error
+ */
+int stats_listen(struct sockaddr_in *addr);
+
+/**
+ * @brief Serves one scrape once the listener is readable, main thread only.
+ *
+ * Waits at most STATS_SCRAPE_TIMEOUT_MS for the request, scrapers send it
+ * together with the connection.
+ */
+void stats_serve(int listen_fd);
+
+#endif // CHORD_STATS_H
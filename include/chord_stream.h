@@ -0,0 +1,91 @@
+#ifndef CHORD_STREAM_H
+#define CHORD_STREAM_H
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <arpa/inet.h>
+
+#include "chord.pb-c.h"
+
+// Messages larger than this go over a stream to peers that accept one,
+// a datagram of this size still crosses a typical path unfragmented
+#define STREAM_MIN_FRAME 1400
+
+// Largest message a stream carries, a peer announcing more is disconnected
+#define STREAM_MAX_FRAME (16 * 1024 * 1024)
+
+// Bytes one connection may have queued before further sends are refused
+#define STREAM_MAX_QUEUED (32 * 1024 * 1024)
+
+// Connections kept open at once, the least recently used idle one makes room
+#define STREAM_MAX_CONNS 64
+
+// Connections unused for this long are closed
+#define STREAM_IDLE_MS 60000
+
+// Bytes read from one connection per wakeup, so a bulk transfer cannot
+// hold up the datagrams and timers in between
+#define STREAM_READ_BUDGET (256 * 1024)
+
+/*
+ * A stream is a TCP connection to the port the peer's datagrams use. The
+ * connecting side first sends STREAM_HELLO_SIZE bytes: STREAM_HELLO_MAGIC,
+ * then the port it receives datagrams on (2 bytes, network byte order) and
+ * 2 bytes of padding, so replies reach it as if it had sent a datagram.
+ * Length-prefixed protobuf frames follow in both directions, exactly as in
+ * a datagram.
+ */
+#define STREAM_HELLO_MAGIC "CHS1"
+#define STREAM_HELLO_SIZE 8
+
+typedef void (*stream_handler)(ChordMessage *message, struct sockaddr_in from);
+
+/**
+ * @brief Listens for streams on addr and registers with the reactor,
+ *        main thread only.
+ *
+ * Streams are only used by the thread that called this.
+ *
+ * @param epfd epoll instance of the reactor, the module adds its own fds
+ * @return int 0 on success, -1 if the port could not be opened
+ */
+int stream_init(const struct sockaddr_in *addr, int epfd);
+
+/**
+ * @brief Closes every connection and the listener.
+ */
+void stream_destroy(void);
+
+/**
+ * @brief Whether the calling thread may call stream_send().
+ */
+int stream_available(void);
+
+/**
+ * @brief Queues msg on the connection to addr, opening one if needed.
+ *
+ * Nothing is written until stream_flush().
+ *
+ * @param size chord_message__get_packed_size(msg)
+ * @return int 0 if queued, -1 if the message is too large, the connection
+ *             is backlogged or could not be opened
+ */
+int stream_send(const struct sockaddr_in *addr, ChordMessage *msg, size_t size);
+
+/**
+ * @brief Writes what every connection has queued without blocking, the
+ *        rest waits for the connection to become writable.
+ */
+void stream_flush(void);
+
+/**
+ * @brief Handles readiness of one of the reactor's fds.
+ *
+ * Every message completely received is decoded and passed to handler, then
+ * released.
+ *
+ * @return int 1 if fd belongs to the stream module, 0 otherwise
+ */
+int stream_handle(int fd, uint32_t events, stream_handler handler);
+
+#endif // CHORD_STREAM_H
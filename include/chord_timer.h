@@ -0,0 +1,68 @@
+#ifndef CHORD_TIMER_H
+#define CHORD_TIMER_H
+
+#include <inttypes.h>
+
+typedef void (*timer_callback)(void *arg);
+
+/**
+ * @brief One-shot timer, embedded in whatever owns it.
+ *
+ * Timers live on a hierarchical wheel with 1 ms ticks driven by
+ * CLOCK_MONOTONIC, so wall clock jumps do not fire or stall them.
+ */
+struct timer {
+	uint64_t expires;       // Monotonic ms
+	timer_callback callback;
+	void *arg;
+	int level, slot;        // Position on the wheel, level < 0 when not scheduled
+	struct timer *next, *prev;
+};
+
+/**
+ * @brief Milliseconds on the monotonic clock.
+ */
+uint64_t monotonic_ms(void);
+
+/**
+ * @brief Microseconds on the monotonic clock, for measuring round trips.
+ */
+uint64_t monotonic_us(void);
+
+/**
+ * @brief Takes the time from now_us instead of CLOCK_MONOTONIC, call before any timer is scheduled.
+ *
+ * For the simulator, whose clock only moves when it says so. The clock
+ * must never go backwards.
+ */
+void timer_use_clock(uint64_t (*now_us)(void));
+
+void timer_init(struct timer *timer, timer_callback callback, void *arg);
+
+/**
+ * @brief (Re)arms a timer to fire delay_ms from now.
+ */
+void timer_schedule(struct timer *timer, uint64_t delay_ms);
+
+/**
+ * @brief Disarms a timer, harmless if it is not scheduled.
+ */
+void timer_cancel(struct timer *timer);
+
+int timer_pending(struct timer *timer);
+
+/**
+ * @brief Fires every timer that is due.
+ *
+ * Callbacks may schedule or cancel any timer, including their own.
+ */
+void timers_run(void);
+
+/**
+ * @brief Milliseconds until the next timer is due.
+ *
+ * @return int64_t 0 if one is already due, -1 if no timer is scheduled
+ */
+int64_t timers_next_timeout(void);
+
+#endif // CHORD_TIMER_H
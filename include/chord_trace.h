@@ -0,0 +1,85 @@
+#ifndef CHORD_TRACE_H
+#define CHORD_TRACE_H
+
+#include <inttypes.h>
+#include <arpa/inet.h>
+
+#include "chord.pb-c.h"
+
+// First bytes of every trace log, the records follow
+#define TRACE_MAGIC "CHTRACE1"
+#define TRACE_MAGIC_LEN 8
+
+enum trace_event {
+    TRACE_LOOKUP_START = 1, // Logged by the originator
+    TRACE_HOP_SENT,         // Request of hop sent to peer
+    TRACE_HOP_REPLY,        // Peer answered the request of hop
+    TRACE_HOP_TIMEOUT,      // Peer did not answer the request of hop
+    TRACE_RECEIVED,         // Logged by the peer a request reached, peer is its sender
+    TRACE_FORWARDED,        // Routed request passed on to peer
+    TRACE_LOOKUP_DONE,      // Peer is the owner found
+    TRACE_LOOKUP_FAILED,
+    TRACE_HOP_BUSY,         // Peer turned the request of hop down, overloaded
+};
+
+/**
+ * @brief One event of a sampled lookup as stored in the log, 48 bytes with
+ *        every integer little-endian.
+ */
+struct trace_record {
+    uint64_t trace_id;
+    uint64_t time_us;       // Wall clock of the node that logged it
+    uint64_t key;           // Key being looked up
+    uint64_t node;          // Key of the node that logged it
+    uint64_t sent_us;       // Sender's wall clock, TRACE_RECEIVED only
+    uint32_t peer_address;  // Network byte order as in Node, 0 if none
+    uint16_t peer_port;
+    uint8_t event;
+    uint8_t hop;
+};
+
+/**
+ * @brief Opens the trace log for appending, main thread only.
+ *
+ * Every node keeps a log of its own, trace_stitch merges several into
+ * per-lookup timelines.
+ *
+ * @param rate Fraction of lookups trace_sample() picks
+ * @return int 0 on success, -1 if the file could not be opened
+ */
+int trace_open(const char *path, double rate);
+
+void trace_close(void);
+
+/**
+ * @brief Decides whether a new lookup is traced, main thread only.
+ *
+ * @return uint64_t A fresh trace id, 0 if the lookup is not traced
+ */
+uint64_t trace_sample(void);
+
+/**
+ * @brief Marks a request as part of a traced lookup.
+ *
+ * @param context Storage for the context, must outlive the send
+ */
+void trace_attach(ChordMessage *msg, TraceContext *context, uint64_t trace_id, int hop);
+
+/**
+ * @brief Logs an event of a traced lookup as seen by the active virtual
+ *        node, main thread only.
+ *
+ * @param peer Node the event concerns, NULL if none
+ */
+void trace_log(uint64_t trace_id, enum trace_event event, int hop, uint64_t key, const Node *peer);
+
+/**
+ * @brief Logs the arrival of a traced request, any thread.
+ *
+ * Messages without a trace context are ignored.
+ *
+ * @param node Key of the virtual node that received it
+ */
+void trace_received(ChordMessage *message, const struct sockaddr_in *from, uint64_t node);
+
+#endif // CHORD_TRACE_H
@@ -0,0 +1,120 @@
+#ifndef CHORD_VNODE_H
+#define CHORD_VNODE_H
+
+#include <inttypes.h>
+#include <arpa/inet.h>
+
+#include "chord.pb-c.h"
+
+// Most ring positions one process may own (--vnodes), the simulator raises it
+#ifndef VNODE_MAX
+#define VNODE_MAX 64
+#endif
+
+/**
+ * @brief Routing state of one virtual node.
+ *
+ * The routing globals (hash, self, predecessor, ...) always belong to the
+ * active virtual node. Activating another one saves them here and loads
+ * its own, so the Chord code itself only ever sees a single node. Finger
+ * table and successor list are swapped by pointer.
+ */
+struct vnode_state {
+    uint64_t hash;
+    Node self;
+    Node predecessor;
+    Node successor;
+    Node *finger_table;
+    Node *successor_list;
+    int fixIndex;
+    int succListIndex;
+    int joined;
+    int stabilize_in_flight;
+    int fix_fingers_in_flight;
+    int check_predecessor_in_flight;
+    Node checked_predecessor;
+};
+
+/**
+ * @brief Sets up n_vnodes ring positions for the address, main thread only.
+ *
+ * Virtual node 0 takes key, the others hash the address salted with their
+ * index. All of them share the socket, the event loop and the store. Leaves
+ * virtual node 0 active.
+ *
+ * @param n_vnodes Ring positions to own, 1 to VNODE_MAX
+ * @param addr Address the node is reachable at
+ * @param key Ring id of virtual node 0
+ * @return int 0 on success, -1 if memory ran out
+ */
+int vnode_init(int n_vnodes, struct sockaddr_in *addr, uint64_t key);
+
+/**
+ * @brief Sets up n_vnodes ring positions each as a host of its own, main thread only.
+ *
+ * For the simulator: virtual node i is reachable at addrs[i] and takes
+ * get_hash() of it as its key, as a separate process there would.
+ *
+ * @return int 0 on success, -1 if memory ran out
+ */
+int vnode_init_hosts(int n_vnodes, const struct sockaddr_in *addrs);
+
+/**
+ * @brief Frees the routing tables, the keys stay for threads that may still
+ *        look them up while the process exits.
+ */
+void vnode_destroy(void);
+
+/**
+ * @brief Frees everything vnode_destroy() left, once no other thread reads
+ *        it, so that vnode_init() can run again.
+ */
+void vnode_reset(void);
+
+int vnode_count(void);
+
+int vnode_active(void);
+
+/**
+ * @brief Makes a virtual node's routing state the globals, main thread only.
+ */
+void vnode_activate(int index);
+
+/**
+ * @brief Index of the virtual node with this key, -1 if it is not ours.
+ *
+ * Keys are fixed once vnode_init() returns, any thread may call this.
+ */
+int vnode_find(uint64_t key);
+
+/**
+ * @brief Virtual node a received message is for, 0 if it names none of ours.
+ */
+int vnode_for_message(ChordMessage *message);
+
+/**
+ * @brief Whether a node lives in this process, as any of its virtual nodes.
+ */
+int vnode_is_local(const Node *node);
+
+int vnode_all_joined(void);
+
+/**
+ * @brief Virtual nodes activated since the last call, main thread only.
+ *
+ * Only these can have changed their routing state. The active one is
+ * always included.
+ *
+ * @param n Set to the number of indices
+ * @return const int* The indices, valid until the next call
+ */
+const int *vnode_take_touched(int *n);
+
+/**
+ * @brief Routing state of a virtual node as of now, main thread only.
+ *
+ * Valid until the next vnode_activate().
+ */
+const struct vnode_state *vnode_get(int index);
+
+#endif // CHORD_VNODE_H
@@ -0,0 +1,95 @@
+#ifndef CHORD_WIRE_H
+#define CHORD_WIRE_H
+
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "chord_arena.h"
+#include "chord.pb-c.h"
+
+/*
+ * Compact frames: the hot control messages in a fixed layout, parsed by
+ * offset instead of by chord_message__unpack(). A datagram may mix them
+ * with length-prefixed protobuf frames. Since a length prefix never starts
+ * with a non-zero byte, compact frames start with WIRE_COMPACT_MAGIC, and
+ * their type fixes their size, so they need no prefix of their own.
+ *
+ *   0  magic       1 byte
+ *   1  type        1 byte, the ChordMessage msg case
+ *   2  flags       1 byte, WIRE_FLAG_*
+ *   3  features    1 byte, WIRE_FEATURE_* the sender accepts
+ *   4  query_id    4 bytes, big-endian
+ *   8  target      8 bytes, big-endian
+ *  16  body        by type, every Node as key (8, big-endian), address
+ *                  (4) and port (2) in network byte order
+ *
+ * Bodies: notify request and get predecessor response are a Node, find
+ * successor request a key then the requester, find successor response the
+ * node then the key. The other types have none. The version field is
+ * implied by the magic.
+ */
+
+// First byte of a compact frame, stands for version 417 of the messages
+#define WIRE_COMPACT_MAGIC 0xC5
+
+#define WIRE_HEADER_SIZE 16
+#define WIRE_NODE_SIZE 14
+
+// Bits of the flags byte
+#define WIRE_FLAG_QUERY_ID 0x01
+#define WIRE_FLAG_TARGET 0x02
+#define WIRE_FLAG_REQUESTER 0x04 // Find successor request is routed
+#define WIRE_FLAG_PROBE 0x08
+#define WIRE_FLAG_KEY 0x10       // Find successor response names its key
+
+// Bits of ChordMessage.features, what the sender accepts
+#define WIRE_FEATURE_COMPACT 0x01
+#define WIRE_FEATURE_STABILIZE 0x02 // Answers StabilizeRequest
+#define WIRE_FEATURE_STREAM 0x04    // Takes large messages over a stream, see chord_stream.h
+#define WIRE_FEATURE_COALESCE 0x08  // Reads every frame of a datagram, not just the first
+
+/**
+ * @brief Whether msg has a compact layout, only plain control messages do.
+ */
+int wire_compact_encodable(const ChordMessage *msg);
+
+/**
+ * @brief Size of msg's compact frame, 0 if it has none.
+ */
+size_t wire_compact_size(ChordMessage__MsgCase type);
+
+/**
+ * @brief Writes msg as a compact frame, wire_compact_size() bytes.
+ *
+ * Only for messages wire_compact_encodable() accepts.
+ */
+void wire_compact_pack(const ChordMessage *msg, uint8_t *out);
+
+/**
+ * @brief Size of the compact frame at the start of data.
+ *
+ * @return size_t The frame size, 0 if data does not start with a whole
+ *                compact frame of a known type
+ */
+size_t wire_compact_frame(const uint8_t *data, size_t len);
+
+/**
+ * @brief Builds the message of a compact frame in arena.
+ *
+ * The result looks like an unpacked message, features included.
+ *
+ * @return ChordMessage* NULL if the frame is malformed or arena is out of memory
+ */
+ChordMessage *wire_compact_unpack(const uint8_t *frame, size_t len, struct arena *arena);
+
+/**
+ * @brief Type of an encoded message, compact or protobuf, without decoding it.
+ *
+ * Reads no further into a protobuf frame than the tag of its message.
+ *
+ * @return ChordMessage__MsgCase CHORD_MESSAGE__MSG__NOT_SET if the frame
+ *                               names no type it could find
+ */
+ChordMessage__MsgCase wire_peek_type(const uint8_t *frame, size_t len);
+
+#endif // CHORD_WIRE_H
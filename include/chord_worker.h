@@ -0,0 +1,47 @@
+#ifndef CHORD_WORKER_H
+#define CHORD_WORKER_H
+
+#include <arpa/inet.h>
+
+#include "chord.pb-c.h"
+
+/**
+ * @brief Hands a message that needs the main thread to its handler.
+ */
+typedef void (*handoff_handler)(ChordMessage *message, struct sockaddr_in from);
+
+/**
+ * @brief Starts worker threads, each on its own SO_REUSEPORT socket.
+ *
+ * The kernel spreads incoming datagrams across the main socket and the
+ * workers' sockets. Workers answer read-only requests from the routing
+ * snapshot the main thread publishes, and hand everything else (replies,
+ * notifies, routed lookups) to the main thread.
+ *
+ * @param n_workers Number of threads to start
+ * @param addr Address to bind, same as the main socket's
+ * @return int 0 on success, -1 if a socket or thread could not be set up
+ */
+int workers_start(int n_workers, struct sockaddr_in *addr);
+
+/**
+ * @brief Stops the workers and closes their sockets, main thread only.
+ *
+ * Returns once every worker has exited, so the routing and RPC state they
+ * read can be freed. Safe to call if none were started.
+ */
+void workers_stop(void);
+
+/**
+ * @brief eventfd that becomes readable when workers have handed off messages.
+ *
+ * @return int The fd, -1 if no workers are running
+ */
+int workers_wake_fd(void);
+
+/**
+ * @brief Decodes and handles every message workers handed off, main thread only.
+ */
+void workers_drain(handoff_handler handler);
+
+#endif // CHORD_WORKER_H
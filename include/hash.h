@@ -43,4 +43,16 @@ int sha1sum_destroy(struct sha1sum_ctx*);
  */
 uint64_t sha1sum_truncated_head(uint8_t *sha1_hash);
 
+/* Hash a payload straight to its truncated head, the same value
+ * sha1sum_finish() followed by sha1sum_truncated_head() gives for an
+ * unsalted context. Needs no context and allocates nothing, so any thread
+ * may call it. Uses the SHA extensions when the CPU has them.
+ */
+uint64_t sha1sum_head(const uint8_t *payload, size_t len);
+
+/* Batch form of sha1sum_head(): out[i] receives the head of payloads[i],
+ * which is lens[i] bytes long.
+ */
+void sha1sum_heads(const uint8_t *const *payloads, const size_t *lens, size_t n, uint64_t *out);
+
 #endif
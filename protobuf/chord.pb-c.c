@@ -232,6 +232,96 @@ void   find_successor_response__free_unpacked
   assert(message->base.descriptor == &find_successor_response__descriptor);
   protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
 }
+void   find_successors_request__init
+                     (FindSuccessorsRequest         *message)
+{
+  static const FindSuccessorsRequest init_value = FIND_SUCCESSORS_REQUEST__INIT;
+  *message = init_value;
+}
+size_t find_successors_request__get_packed_size
+                     (const FindSuccessorsRequest *message)
+{
+  assert(message->base.descriptor == &find_successors_request__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t find_successors_request__pack
+                     (const FindSuccessorsRequest *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &find_successors_request__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t find_successors_request__pack_to_buffer
+                     (const FindSuccessorsRequest *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &find_successors_request__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+FindSuccessorsRequest *
+       find_successors_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (FindSuccessorsRequest *)
+     protobuf_c_message_unpack (&find_successors_request__descriptor,
+                                allocator, len, data);
+}
+void   find_successors_request__free_unpacked
+                     (FindSuccessorsRequest *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &find_successors_request__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   find_successors_response__init
+                     (FindSuccessorsResponse         *message)
+{
+  static const FindSuccessorsResponse init_value = FIND_SUCCESSORS_RESPONSE__INIT;
+  *message = init_value;
+}
+size_t find_successors_response__get_packed_size
+                     (const FindSuccessorsResponse *message)
+{
+  assert(message->base.descriptor == &find_successors_response__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t find_successors_response__pack
+                     (const FindSuccessorsResponse *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &find_successors_response__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t find_successors_response__pack_to_buffer
+                     (const FindSuccessorsResponse *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &find_successors_response__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+FindSuccessorsResponse *
+       find_successors_response__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (FindSuccessorsResponse *)
+     protobuf_c_message_unpack (&find_successors_response__descriptor,
+                                allocator, len, data);
+}
+void   find_successors_response__free_unpacked
+                     (FindSuccessorsResponse *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &find_successors_response__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
 void   start_find_successor_request__init
                      (StartFindSuccessorRequest         *message)
 {
@@ -592,232 +682,1848 @@ void   get_successor_list_response__free_unpacked
   assert(message->base.descriptor == &get_successor_list_response__descriptor);
   protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
 }
-void   chord_message__init
-                     (ChordMessage         *message)
+void   stabilize_request__init
+                     (StabilizeRequest         *message)
 {
-  static const ChordMessage init_value = CHORD_MESSAGE__INIT;
+  static const StabilizeRequest init_value = STABILIZE_REQUEST__INIT;
   *message = init_value;
 }
-size_t chord_message__get_packed_size
-                     (const ChordMessage *message)
+size_t stabilize_request__get_packed_size
+                     (const StabilizeRequest *message)
 {
-  assert(message->base.descriptor == &chord_message__descriptor);
+  assert(message->base.descriptor == &stabilize_request__descriptor);
   return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
 }
-size_t chord_message__pack
-                     (const ChordMessage *message,
+size_t stabilize_request__pack
+                     (const StabilizeRequest *message,
                       uint8_t       *out)
 {
-  assert(message->base.descriptor == &chord_message__descriptor);
+  assert(message->base.descriptor == &stabilize_request__descriptor);
   return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
 }
-size_t chord_message__pack_to_buffer
-                     (const ChordMessage *message,
+size_t stabilize_request__pack_to_buffer
+                     (const StabilizeRequest *message,
                       ProtobufCBuffer *buffer)
 {
-  assert(message->base.descriptor == &chord_message__descriptor);
+  assert(message->base.descriptor == &stabilize_request__descriptor);
   return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
 }
-ChordMessage *
-       chord_message__unpack
+StabilizeRequest *
+       stabilize_request__unpack
                      (ProtobufCAllocator  *allocator,
                       size_t               len,
                       const uint8_t       *data)
 {
-  return (ChordMessage *)
-     protobuf_c_message_unpack (&chord_message__descriptor,
+  return (StabilizeRequest *)
+     protobuf_c_message_unpack (&stabilize_request__descriptor,
                                 allocator, len, data);
 }
-void   chord_message__free_unpacked
-                     (ChordMessage *message,
+void   stabilize_request__free_unpacked
+                     (StabilizeRequest *message,
                       ProtobufCAllocator *allocator)
 {
   if(!message)
     return;
-  assert(message->base.descriptor == &chord_message__descriptor);
+  assert(message->base.descriptor == &stabilize_request__descriptor);
   protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
 }
-static const ProtobufCFieldDescriptor node__field_descriptors[3] =
+void   stabilize_response__init
+                     (StabilizeResponse         *message)
 {
-  {
-    "key",
-    1,
-    PROTOBUF_C_LABEL_REQUIRED,
-    PROTOBUF_C_TYPE_FIXED64,
-    0,   /* quantifier_offset */
-    offsetof(Node, key),
-    NULL,
-    NULL,
-    0,             /* flags */
-    0,NULL,NULL    /* reserved1,reserved2, etc */
-  },
-  {
-    "address",
-    2,
-    PROTOBUF_C_LABEL_REQUIRED,
-    PROTOBUF_C_TYPE_FIXED32,
-    0,   /* quantifier_offset */
-    offsetof(Node, address),
-    NULL,
-    NULL,
-    0,             /* flags */
-    0,NULL,NULL    /* reserved1,reserved2, etc */
-  },
-  {
-    "port",
-    3,
-    PROTOBUF_C_LABEL_REQUIRED,
-    PROTOBUF_C_TYPE_UINT32,
-    0,   /* quantifier_offset */
-    offsetof(Node, port),
-    NULL,
-    NULL,
-    0,             /* flags */
-    0,NULL,NULL    /* reserved1,reserved2, etc */
-  },
-};
-static const unsigned node__field_indices_by_name[] = {
-  1,   /* field[1] = address */
-  0,   /* field[0] = key */
-  2,   /* field[2] = port */
-};
-static const ProtobufCIntRange node__number_ranges[1 + 1] =
+  static const StabilizeResponse init_value = STABILIZE_RESPONSE__INIT;
+  *message = init_value;
+}
+size_t stabilize_response__get_packed_size
+                     (const StabilizeResponse *message)
 {
-  { 1, 0 },
-  { 0, 3 }
-};
-const ProtobufCMessageDescriptor node__descriptor =
+  assert(message->base.descriptor == &stabilize_response__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t stabilize_response__pack
+                     (const StabilizeResponse *message,
+                      uint8_t       *out)
 {
-  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
-  "Node",
-  "Node",
-  "Node",
-  "",
-  sizeof(Node),
-  3,
-  node__field_descriptors,
-  node__field_indices_by_name,
-  1,  node__number_ranges,
-  (ProtobufCMessageInit) node__init,
-  NULL,NULL,NULL    /* reserved[123] */
-};
-static const ProtobufCFieldDescriptor notify_request__field_descriptors[1] =
+  assert(message->base.descriptor == &stabilize_response__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t stabilize_response__pack_to_buffer
+                     (const StabilizeResponse *message,
+                      ProtobufCBuffer *buffer)
 {
-  {
-    "node",
-    1,
-    PROTOBUF_C_LABEL_REQUIRED,
-    PROTOBUF_C_TYPE_MESSAGE,
-    0,   /* quantifier_offset */
-    offsetof(NotifyRequest, node),
-    &node__descriptor,
-    NULL,
-    0,             /* flags */
-    0,NULL,NULL    /* reserved1,reserved2, etc */
-  },
-};
-static const unsigned notify_request__field_indices_by_name[] = {
-  0,   /* field[0] = node */
-};
-static const ProtobufCIntRange notify_request__number_ranges[1 + 1] =
+  assert(message->base.descriptor == &stabilize_response__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+StabilizeResponse *
+       stabilize_response__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
 {
-  { 1, 0 },
-  { 0, 1 }
-};
-const ProtobufCMessageDescriptor notify_request__descriptor =
+  return (StabilizeResponse *)
+     protobuf_c_message_unpack (&stabilize_response__descriptor,
+                                allocator, len, data);
+}
+void   stabilize_response__free_unpacked
+                     (StabilizeResponse *message,
+                      ProtobufCAllocator *allocator)
 {
-  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
-  "NotifyRequest",
-  "NotifyRequest",
-  "NotifyRequest",
-  "",
-  sizeof(NotifyRequest),
-  1,
-  notify_request__field_descriptors,
-  notify_request__field_indices_by_name,
-  1,  notify_request__number_ranges,
-  (ProtobufCMessageInit) notify_request__init,
-  NULL,NULL,NULL    /* reserved[123] */
-};
-#define notify_response__field_descriptors NULL
-#define notify_response__field_indices_by_name NULL
-#define notify_response__number_ranges NULL
-const ProtobufCMessageDescriptor notify_response__descriptor =
+  if(!message)
+    return;
+  assert(message->base.descriptor == &stabilize_response__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   put_request__init
+                     (PutRequest         *message)
 {
-  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
-  "NotifyResponse",
-  "NotifyResponse",
-  "NotifyResponse",
-  "",
-  sizeof(NotifyResponse),
-  0,
-  notify_response__field_descriptors,
-  notify_response__field_indices_by_name,
-  0,  notify_response__number_ranges,
-  (ProtobufCMessageInit) notify_response__init,
-  NULL,NULL,NULL    /* reserved[123] */
-};
-static const ProtobufCFieldDescriptor find_successor_request__field_descriptors[2] =
+  static const PutRequest init_value = PUT_REQUEST__INIT;
+  *message = init_value;
+}
+size_t put_request__get_packed_size
+                     (const PutRequest *message)
 {
-  {
-    "key",
-    1,
-    PROTOBUF_C_LABEL_REQUIRED,
-    PROTOBUF_C_TYPE_FIXED64,
-    0,   /* quantifier_offset */
-    offsetof(FindSuccessorRequest, key),
-    NULL,
-    NULL,
-    0,             /* flags */
-    0,NULL,NULL    /* reserved1,reserved2, etc */
-  },
-  {
-    "requester",
-    2,
-    PROTOBUF_C_LABEL_OPTIONAL,
-    PROTOBUF_C_TYPE_MESSAGE,
-    0,   /* quantifier_offset */
-    offsetof(FindSuccessorRequest, requester),
-    &node__descriptor,
-    NULL,
-    0,             /* flags */
-    0,NULL,NULL    /* reserved1,reserved2, etc */
-  },
-};
-static const unsigned find_successor_request__field_indices_by_name[] = {
-  0,   /* field[0] = key */
-  1,   /* field[1] = requester */
-};
-static const ProtobufCIntRange find_successor_request__number_ranges[1 + 1] =
+  assert(message->base.descriptor == &put_request__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t put_request__pack
+                     (const PutRequest *message,
+                      uint8_t       *out)
 {
-  { 1, 0 },
-  { 0, 2 }
-};
-const ProtobufCMessageDescriptor find_successor_request__descriptor =
+  assert(message->base.descriptor == &put_request__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t put_request__pack_to_buffer
+                     (const PutRequest *message,
+                      ProtobufCBuffer *buffer)
 {
-  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
-  "FindSuccessorRequest",
-  "FindSuccessorRequest",
-  "FindSuccessorRequest",
-  "",
-  sizeof(FindSuccessorRequest),
-  2,
-  find_successor_request__field_descriptors,
-  find_successor_request__field_indices_by_name,
-  1,  find_successor_request__number_ranges,
+  assert(message->base.descriptor == &put_request__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+PutRequest *
+       put_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (PutRequest *)
+     protobuf_c_message_unpack (&put_request__descriptor,
+                                allocator, len, data);
+}
+void   put_request__free_unpacked
+                     (PutRequest *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &put_request__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   put_response__init
+                     (PutResponse         *message)
+{
+  static const PutResponse init_value = PUT_RESPONSE__INIT;
+  *message = init_value;
+}
+size_t put_response__get_packed_size
+                     (const PutResponse *message)
+{
+  assert(message->base.descriptor == &put_response__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t put_response__pack
+                     (const PutResponse *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &put_response__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t put_response__pack_to_buffer
+                     (const PutResponse *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &put_response__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+PutResponse *
+       put_response__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (PutResponse *)
+     protobuf_c_message_unpack (&put_response__descriptor,
+                                allocator, len, data);
+}
+void   put_response__free_unpacked
+                     (PutResponse *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &put_response__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   get_request__init
+                     (GetRequest         *message)
+{
+  static const GetRequest init_value = GET_REQUEST__INIT;
+  *message = init_value;
+}
+size_t get_request__get_packed_size
+                     (const GetRequest *message)
+{
+  assert(message->base.descriptor == &get_request__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t get_request__pack
+                     (const GetRequest *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &get_request__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t get_request__pack_to_buffer
+                     (const GetRequest *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &get_request__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+GetRequest *
+       get_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (GetRequest *)
+     protobuf_c_message_unpack (&get_request__descriptor,
+                                allocator, len, data);
+}
+void   get_request__free_unpacked
+                     (GetRequest *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &get_request__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   get_response__init
+                     (GetResponse         *message)
+{
+  static const GetResponse init_value = GET_RESPONSE__INIT;
+  *message = init_value;
+}
+size_t get_response__get_packed_size
+                     (const GetResponse *message)
+{
+  assert(message->base.descriptor == &get_response__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t get_response__pack
+                     (const GetResponse *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &get_response__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t get_response__pack_to_buffer
+                     (const GetResponse *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &get_response__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+GetResponse *
+       get_response__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (GetResponse *)
+     protobuf_c_message_unpack (&get_response__descriptor,
+                                allocator, len, data);
+}
+void   get_response__free_unpacked
+                     (GetResponse *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &get_response__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   delete_request__init
+                     (DeleteRequest         *message)
+{
+  static const DeleteRequest init_value = DELETE_REQUEST__INIT;
+  *message = init_value;
+}
+size_t delete_request__get_packed_size
+                     (const DeleteRequest *message)
+{
+  assert(message->base.descriptor == &delete_request__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t delete_request__pack
+                     (const DeleteRequest *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &delete_request__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t delete_request__pack_to_buffer
+                     (const DeleteRequest *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &delete_request__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+DeleteRequest *
+       delete_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (DeleteRequest *)
+     protobuf_c_message_unpack (&delete_request__descriptor,
+                                allocator, len, data);
+}
+void   delete_request__free_unpacked
+                     (DeleteRequest *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &delete_request__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   delete_response__init
+                     (DeleteResponse         *message)
+{
+  static const DeleteResponse init_value = DELETE_RESPONSE__INIT;
+  *message = init_value;
+}
+size_t delete_response__get_packed_size
+                     (const DeleteResponse *message)
+{
+  assert(message->base.descriptor == &delete_response__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t delete_response__pack
+                     (const DeleteResponse *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &delete_response__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t delete_response__pack_to_buffer
+                     (const DeleteResponse *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &delete_response__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+DeleteResponse *
+       delete_response__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (DeleteResponse *)
+     protobuf_c_message_unpack (&delete_response__descriptor,
+                                allocator, len, data);
+}
+void   delete_response__free_unpacked
+                     (DeleteResponse *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &delete_response__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   key_value__init
+                     (KeyValue         *message)
+{
+  static const KeyValue init_value = KEY_VALUE__INIT;
+  *message = init_value;
+}
+size_t key_value__get_packed_size
+                     (const KeyValue *message)
+{
+  assert(message->base.descriptor == &key_value__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t key_value__pack
+                     (const KeyValue *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &key_value__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t key_value__pack_to_buffer
+                     (const KeyValue *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &key_value__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+KeyValue *
+       key_value__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (KeyValue *)
+     protobuf_c_message_unpack (&key_value__descriptor,
+                                allocator, len, data);
+}
+void   key_value__free_unpacked
+                     (KeyValue *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &key_value__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   handoff_request__init
+                     (HandoffRequest         *message)
+{
+  static const HandoffRequest init_value = HANDOFF_REQUEST__INIT;
+  *message = init_value;
+}
+size_t handoff_request__get_packed_size
+                     (const HandoffRequest *message)
+{
+  assert(message->base.descriptor == &handoff_request__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t handoff_request__pack
+                     (const HandoffRequest *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &handoff_request__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t handoff_request__pack_to_buffer
+                     (const HandoffRequest *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &handoff_request__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+HandoffRequest *
+       handoff_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (HandoffRequest *)
+     protobuf_c_message_unpack (&handoff_request__descriptor,
+                                allocator, len, data);
+}
+void   handoff_request__free_unpacked
+                     (HandoffRequest *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &handoff_request__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   handoff_response__init
+                     (HandoffResponse         *message)
+{
+  static const HandoffResponse init_value = HANDOFF_RESPONSE__INIT;
+  *message = init_value;
+}
+size_t handoff_response__get_packed_size
+                     (const HandoffResponse *message)
+{
+  assert(message->base.descriptor == &handoff_response__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t handoff_response__pack
+                     (const HandoffResponse *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &handoff_response__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t handoff_response__pack_to_buffer
+                     (const HandoffResponse *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &handoff_response__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+HandoffResponse *
+       handoff_response__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (HandoffResponse *)
+     protobuf_c_message_unpack (&handoff_response__descriptor,
+                                allocator, len, data);
+}
+void   handoff_response__free_unpacked
+                     (HandoffResponse *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &handoff_response__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   leave_request__init
+                     (LeaveRequest         *message)
+{
+  static const LeaveRequest init_value = LEAVE_REQUEST__INIT;
+  *message = init_value;
+}
+size_t leave_request__get_packed_size
+                     (const LeaveRequest *message)
+{
+  assert(message->base.descriptor == &leave_request__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t leave_request__pack
+                     (const LeaveRequest *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &leave_request__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t leave_request__pack_to_buffer
+                     (const LeaveRequest *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &leave_request__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+LeaveRequest *
+       leave_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (LeaveRequest *)
+     protobuf_c_message_unpack (&leave_request__descriptor,
+                                allocator, len, data);
+}
+void   leave_request__free_unpacked
+                     (LeaveRequest *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &leave_request__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   leave_response__init
+                     (LeaveResponse         *message)
+{
+  static const LeaveResponse init_value = LEAVE_RESPONSE__INIT;
+  *message = init_value;
+}
+size_t leave_response__get_packed_size
+                     (const LeaveResponse *message)
+{
+  assert(message->base.descriptor == &leave_response__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t leave_response__pack
+                     (const LeaveResponse *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &leave_response__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t leave_response__pack_to_buffer
+                     (const LeaveResponse *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &leave_response__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+LeaveResponse *
+       leave_response__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (LeaveResponse *)
+     protobuf_c_message_unpack (&leave_response__descriptor,
+                                allocator, len, data);
+}
+void   leave_response__free_unpacked
+                     (LeaveResponse *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &leave_response__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   histogram__init
+                     (Histogram         *message)
+{
+  static const Histogram init_value = HISTOGRAM__INIT;
+  *message = init_value;
+}
+size_t histogram__get_packed_size
+                     (const Histogram *message)
+{
+  assert(message->base.descriptor == &histogram__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t histogram__pack
+                     (const Histogram *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &histogram__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t histogram__pack_to_buffer
+                     (const Histogram *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &histogram__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+Histogram *
+       histogram__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (Histogram *)
+     protobuf_c_message_unpack (&histogram__descriptor,
+                                allocator, len, data);
+}
+void   histogram__free_unpacked
+                     (Histogram *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &histogram__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   stats__init
+                     (Stats         *message)
+{
+  static const Stats init_value = STATS__INIT;
+  *message = init_value;
+}
+size_t stats__get_packed_size
+                     (const Stats *message)
+{
+  assert(message->base.descriptor == &stats__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t stats__pack
+                     (const Stats *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &stats__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t stats__pack_to_buffer
+                     (const Stats *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &stats__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+Stats *
+       stats__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (Stats *)
+     protobuf_c_message_unpack (&stats__descriptor,
+                                allocator, len, data);
+}
+void   stats__free_unpacked
+                     (Stats *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &stats__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   stats_request__init
+                     (StatsRequest         *message)
+{
+  static const StatsRequest init_value = STATS_REQUEST__INIT;
+  *message = init_value;
+}
+size_t stats_request__get_packed_size
+                     (const StatsRequest *message)
+{
+  assert(message->base.descriptor == &stats_request__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t stats_request__pack
+                     (const StatsRequest *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &stats_request__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t stats_request__pack_to_buffer
+                     (const StatsRequest *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &stats_request__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+StatsRequest *
+       stats_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (StatsRequest *)
+     protobuf_c_message_unpack (&stats_request__descriptor,
+                                allocator, len, data);
+}
+void   stats_request__free_unpacked
+                     (StatsRequest *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &stats_request__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   stats_response__init
+                     (StatsResponse         *message)
+{
+  static const StatsResponse init_value = STATS_RESPONSE__INIT;
+  *message = init_value;
+}
+size_t stats_response__get_packed_size
+                     (const StatsResponse *message)
+{
+  assert(message->base.descriptor == &stats_response__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t stats_response__pack
+                     (const StatsResponse *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &stats_response__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t stats_response__pack_to_buffer
+                     (const StatsResponse *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &stats_response__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+StatsResponse *
+       stats_response__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (StatsResponse *)
+     protobuf_c_message_unpack (&stats_response__descriptor,
+                                allocator, len, data);
+}
+void   stats_response__free_unpacked
+                     (StatsResponse *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &stats_response__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   busy_response__init
+                     (BusyResponse         *message)
+{
+  static const BusyResponse init_value = BUSY_RESPONSE__INIT;
+  *message = init_value;
+}
+size_t busy_response__get_packed_size
+                     (const BusyResponse *message)
+{
+  assert(message->base.descriptor == &busy_response__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t busy_response__pack
+                     (const BusyResponse *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &busy_response__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t busy_response__pack_to_buffer
+                     (const BusyResponse *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &busy_response__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+BusyResponse *
+       busy_response__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (BusyResponse *)
+     protobuf_c_message_unpack (&busy_response__descriptor,
+                                allocator, len, data);
+}
+void   busy_response__free_unpacked
+                     (BusyResponse *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &busy_response__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   trace_context__init
+                     (TraceContext         *message)
+{
+  static const TraceContext init_value = TRACE_CONTEXT__INIT;
+  *message = init_value;
+}
+size_t trace_context__get_packed_size
+                     (const TraceContext *message)
+{
+  assert(message->base.descriptor == &trace_context__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t trace_context__pack
+                     (const TraceContext *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &trace_context__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t trace_context__pack_to_buffer
+                     (const TraceContext *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &trace_context__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+TraceContext *
+       trace_context__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (TraceContext *)
+     protobuf_c_message_unpack (&trace_context__descriptor,
+                                allocator, len, data);
+}
+void   trace_context__free_unpacked
+                     (TraceContext *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &trace_context__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   chord_message__init
+                     (ChordMessage         *message)
+{
+  static const ChordMessage init_value = CHORD_MESSAGE__INIT;
+  *message = init_value;
+}
+size_t chord_message__get_packed_size
+                     (const ChordMessage *message)
+{
+  assert(message->base.descriptor == &chord_message__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t chord_message__pack
+                     (const ChordMessage *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &chord_message__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t chord_message__pack_to_buffer
+                     (const ChordMessage *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &chord_message__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+ChordMessage *
+       chord_message__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (ChordMessage *)
+     protobuf_c_message_unpack (&chord_message__descriptor,
+                                allocator, len, data);
+}
+void   chord_message__free_unpacked
+                     (ChordMessage *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &chord_message__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+static const ProtobufCFieldDescriptor node__field_descriptors[3] =
+{
+  {
+    "key",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_FIXED64,
+    0,   /* quantifier_offset */
+    offsetof(Node, key),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "address",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_FIXED32,
+    0,   /* quantifier_offset */
+    offsetof(Node, address),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "port",
+    3,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(Node, port),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned node__field_indices_by_name[] = {
+  1,   /* field[1] = address */
+  0,   /* field[0] = key */
+  2,   /* field[2] = port */
+};
+static const ProtobufCIntRange node__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 3 }
+};
+const ProtobufCMessageDescriptor node__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "Node",
+  "Node",
+  "Node",
+  "",
+  sizeof(Node),
+  3,
+  node__field_descriptors,
+  node__field_indices_by_name,
+  1,  node__number_ranges,
+  (ProtobufCMessageInit) node__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor notify_request__field_descriptors[1] =
+{
+  {
+    "node",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    0,   /* quantifier_offset */
+    offsetof(NotifyRequest, node),
+    &node__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned notify_request__field_indices_by_name[] = {
+  0,   /* field[0] = node */
+};
+static const ProtobufCIntRange notify_request__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 1 }
+};
+const ProtobufCMessageDescriptor notify_request__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "NotifyRequest",
+  "NotifyRequest",
+  "NotifyRequest",
+  "",
+  sizeof(NotifyRequest),
+  1,
+  notify_request__field_descriptors,
+  notify_request__field_indices_by_name,
+  1,  notify_request__number_ranges,
+  (ProtobufCMessageInit) notify_request__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+#define notify_response__field_descriptors NULL
+#define notify_response__field_indices_by_name NULL
+#define notify_response__number_ranges NULL
+const ProtobufCMessageDescriptor notify_response__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "NotifyResponse",
+  "NotifyResponse",
+  "NotifyResponse",
+  "",
+  sizeof(NotifyResponse),
+  0,
+  notify_response__field_descriptors,
+  notify_response__field_indices_by_name,
+  0,  notify_response__number_ranges,
+  (ProtobufCMessageInit) notify_response__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor find_successor_request__field_descriptors[3] =
+{
+  {
+    "key",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_FIXED64,
+    0,   /* quantifier_offset */
+    offsetof(FindSuccessorRequest, key),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "requester",
+    2,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    0,   /* quantifier_offset */
+    offsetof(FindSuccessorRequest, requester),
+    &node__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "probe",
+    3,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_BOOL,
+    offsetof(FindSuccessorRequest, has_probe),
+    offsetof(FindSuccessorRequest, probe),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned find_successor_request__field_indices_by_name[] = {
+  0,   /* field[0] = key */
+  2,   /* field[2] = probe */
+  1,   /* field[1] = requester */
+};
+static const ProtobufCIntRange find_successor_request__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 3 }
+};
+const ProtobufCMessageDescriptor find_successor_request__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "FindSuccessorRequest",
+  "FindSuccessorRequest",
+  "FindSuccessorRequest",
+  "",
+  sizeof(FindSuccessorRequest),
+  3,
+  find_successor_request__field_descriptors,
+  find_successor_request__field_indices_by_name,
+  1,  find_successor_request__number_ranges,
   (ProtobufCMessageInit) find_successor_request__init,
   NULL,NULL,NULL    /* reserved[123] */
 };
-static const ProtobufCFieldDescriptor find_successor_response__field_descriptors[2] =
+static const ProtobufCFieldDescriptor find_successor_response__field_descriptors[2] =
+{
+  {
+    "node",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    0,   /* quantifier_offset */
+    offsetof(FindSuccessorResponse, node),
+    &node__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "key",
+    2,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_FIXED64,
+    offsetof(FindSuccessorResponse, has_key),
+    offsetof(FindSuccessorResponse, key),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned find_successor_response__field_indices_by_name[] = {
+  1,   /* field[1] = key */
+  0,   /* field[0] = node */
+};
+static const ProtobufCIntRange find_successor_response__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 2 }
+};
+const ProtobufCMessageDescriptor find_successor_response__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "FindSuccessorResponse",
+  "FindSuccessorResponse",
+  "FindSuccessorResponse",
+  "",
+  sizeof(FindSuccessorResponse),
+  2,
+  find_successor_response__field_descriptors,
+  find_successor_response__field_indices_by_name,
+  1,  find_successor_response__number_ranges,
+  (ProtobufCMessageInit) find_successor_response__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor find_successors_request__field_descriptors[1] =
+{
+  {
+    "keys",
+    1,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_FIXED64,
+    offsetof(FindSuccessorsRequest, n_keys),
+    offsetof(FindSuccessorsRequest, keys),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned find_successors_request__field_indices_by_name[] = {
+  0,   /* field[0] = keys */
+};
+static const ProtobufCIntRange find_successors_request__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 1 }
+};
+const ProtobufCMessageDescriptor find_successors_request__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "FindSuccessorsRequest",
+  "FindSuccessorsRequest",
+  "FindSuccessorsRequest",
+  "",
+  sizeof(FindSuccessorsRequest),
+  1,
+  find_successors_request__field_descriptors,
+  find_successors_request__field_indices_by_name,
+  1,  find_successors_request__number_ranges,
+  (ProtobufCMessageInit) find_successors_request__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor find_successors_response__field_descriptors[2] =
+{
+  {
+    "keys",
+    1,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_FIXED64,
+    offsetof(FindSuccessorsResponse, n_keys),
+    offsetof(FindSuccessorsResponse, keys),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "nodes",
+    2,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(FindSuccessorsResponse, n_nodes),
+    offsetof(FindSuccessorsResponse, nodes),
+    &node__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned find_successors_response__field_indices_by_name[] = {
+  0,   /* field[0] = keys */
+  1,   /* field[1] = nodes */
+};
+static const ProtobufCIntRange find_successors_response__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 2 }
+};
+const ProtobufCMessageDescriptor find_successors_response__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "FindSuccessorsResponse",
+  "FindSuccessorsResponse",
+  "FindSuccessorsResponse",
+  "",
+  sizeof(FindSuccessorsResponse),
+  2,
+  find_successors_response__field_descriptors,
+  find_successors_response__field_indices_by_name,
+  1,  find_successors_response__number_ranges,
+  (ProtobufCMessageInit) find_successors_response__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor start_find_successor_request__field_descriptors[1] =
+{
+  {
+    "key",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_FIXED64,
+    0,   /* quantifier_offset */
+    offsetof(StartFindSuccessorRequest, key),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned start_find_successor_request__field_indices_by_name[] = {
+  0,   /* field[0] = key */
+};
+static const ProtobufCIntRange start_find_successor_request__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 1 }
+};
+const ProtobufCMessageDescriptor start_find_successor_request__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "StartFindSuccessorRequest",
+  "StartFindSuccessorRequest",
+  "StartFindSuccessorRequest",
+  "",
+  sizeof(StartFindSuccessorRequest),
+  1,
+  start_find_successor_request__field_descriptors,
+  start_find_successor_request__field_indices_by_name,
+  1,  start_find_successor_request__number_ranges,
+  (ProtobufCMessageInit) start_find_successor_request__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor start_find_successor_response__field_descriptors[1] =
+{
+  {
+    "node",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    0,   /* quantifier_offset */
+    offsetof(StartFindSuccessorResponse, node),
+    &node__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned start_find_successor_response__field_indices_by_name[] = {
+  0,   /* field[0] = node */
+};
+static const ProtobufCIntRange start_find_successor_response__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 1 }
+};
+const ProtobufCMessageDescriptor start_find_successor_response__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "StartFindSuccessorResponse",
+  "StartFindSuccessorResponse",
+  "StartFindSuccessorResponse",
+  "",
+  sizeof(StartFindSuccessorResponse),
+  1,
+  start_find_successor_response__field_descriptors,
+  start_find_successor_response__field_indices_by_name,
+  1,  start_find_successor_response__number_ranges,
+  (ProtobufCMessageInit) start_find_successor_response__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+#define get_predecessor_request__field_descriptors NULL
+#define get_predecessor_request__field_indices_by_name NULL
+#define get_predecessor_request__number_ranges NULL
+const ProtobufCMessageDescriptor get_predecessor_request__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "GetPredecessorRequest",
+  "GetPredecessorRequest",
+  "GetPredecessorRequest",
+  "",
+  sizeof(GetPredecessorRequest),
+  0,
+  get_predecessor_request__field_descriptors,
+  get_predecessor_request__field_indices_by_name,
+  0,  get_predecessor_request__number_ranges,
+  (ProtobufCMessageInit) get_predecessor_request__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor get_predecessor_response__field_descriptors[1] =
+{
+  {
+    "node",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    0,   /* quantifier_offset */
+    offsetof(GetPredecessorResponse, node),
+    &node__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned get_predecessor_response__field_indices_by_name[] = {
+  0,   /* field[0] = node */
+};
+static const ProtobufCIntRange get_predecessor_response__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 1 }
+};
+const ProtobufCMessageDescriptor get_predecessor_response__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "GetPredecessorResponse",
+  "GetPredecessorResponse",
+  "GetPredecessorResponse",
+  "",
+  sizeof(GetPredecessorResponse),
+  1,
+  get_predecessor_response__field_descriptors,
+  get_predecessor_response__field_indices_by_name,
+  1,  get_predecessor_response__number_ranges,
+  (ProtobufCMessageInit) get_predecessor_response__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+#define check_predecessor_request__field_descriptors NULL
+#define check_predecessor_request__field_indices_by_name NULL
+#define check_predecessor_request__number_ranges NULL
+const ProtobufCMessageDescriptor check_predecessor_request__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "CheckPredecessorRequest",
+  "CheckPredecessorRequest",
+  "CheckPredecessorRequest",
+  "",
+  sizeof(CheckPredecessorRequest),
+  0,
+  check_predecessor_request__field_descriptors,
+  check_predecessor_request__field_indices_by_name,
+  0,  check_predecessor_request__number_ranges,
+  (ProtobufCMessageInit) check_predecessor_request__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+#define check_predecessor_response__field_descriptors NULL
+#define check_predecessor_response__field_indices_by_name NULL
+#define check_predecessor_response__number_ranges NULL
+const ProtobufCMessageDescriptor check_predecessor_response__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "CheckPredecessorResponse",
+  "CheckPredecessorResponse",
+  "CheckPredecessorResponse",
+  "",
+  sizeof(CheckPredecessorResponse),
+  0,
+  check_predecessor_response__field_descriptors,
+  check_predecessor_response__field_indices_by_name,
+  0,  check_predecessor_response__number_ranges,
+  (ProtobufCMessageInit) check_predecessor_response__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+#define get_successor_list_request__field_descriptors NULL
+#define get_successor_list_request__field_indices_by_name NULL
+#define get_successor_list_request__number_ranges NULL
+const ProtobufCMessageDescriptor get_successor_list_request__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "GetSuccessorListRequest",
+  "GetSuccessorListRequest",
+  "GetSuccessorListRequest",
+  "",
+  sizeof(GetSuccessorListRequest),
+  0,
+  get_successor_list_request__field_descriptors,
+  get_successor_list_request__field_indices_by_name,
+  0,  get_successor_list_request__number_ranges,
+  (ProtobufCMessageInit) get_successor_list_request__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor get_successor_list_response__field_descriptors[1] =
+{
+  {
+    "successors",
+    1,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(GetSuccessorListResponse, n_successors),
+    offsetof(GetSuccessorListResponse, successors),
+    &node__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned get_successor_list_response__field_indices_by_name[] = {
+  0,   /* field[0] = successors */
+};
+static const ProtobufCIntRange get_successor_list_response__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 1 }
+};
+const ProtobufCMessageDescriptor get_successor_list_response__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "GetSuccessorListResponse",
+  "GetSuccessorListResponse",
+  "GetSuccessorListResponse",
+  "",
+  sizeof(GetSuccessorListResponse),
+  1,
+  get_successor_list_response__field_descriptors,
+  get_successor_list_response__field_indices_by_name,
+  1,  get_successor_list_response__number_ranges,
+  (ProtobufCMessageInit) get_successor_list_response__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor stabilize_request__field_descriptors[2] =
+{
+  {
+    "node",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    0,   /* quantifier_offset */
+    offsetof(StabilizeRequest, node),
+    &node__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "successors_digest",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_FIXED64,
+    0,   /* quantifier_offset */
+    offsetof(StabilizeRequest, successors_digest),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned stabilize_request__field_indices_by_name[] = {
+  0,   /* field[0] = node */
+  1,   /* field[1] = successors_digest */
+};
+static const ProtobufCIntRange stabilize_request__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 2 }
+};
+const ProtobufCMessageDescriptor stabilize_request__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "StabilizeRequest",
+  "StabilizeRequest",
+  "StabilizeRequest",
+  "",
+  sizeof(StabilizeRequest),
+  2,
+  stabilize_request__field_descriptors,
+  stabilize_request__field_indices_by_name,
+  1,  stabilize_request__number_ranges,
+  (ProtobufCMessageInit) stabilize_request__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor stabilize_response__field_descriptors[3] =
+{
+  {
+    "predecessor",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    0,   /* quantifier_offset */
+    offsetof(StabilizeResponse, predecessor),
+    &node__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "successors",
+    2,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(StabilizeResponse, n_successors),
+    offsetof(StabilizeResponse, successors),
+    &node__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "unchanged",
+    3,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_BOOL,
+    offsetof(StabilizeResponse, has_unchanged),
+    offsetof(StabilizeResponse, unchanged),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned stabilize_response__field_indices_by_name[] = {
+  0,   /* field[0] = predecessor */
+  1,   /* field[1] = successors */
+  2,   /* field[2] = unchanged */
+};
+static const ProtobufCIntRange stabilize_response__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 3 }
+};
+const ProtobufCMessageDescriptor stabilize_response__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "StabilizeResponse",
+  "StabilizeResponse",
+  "StabilizeResponse",
+  "",
+  sizeof(StabilizeResponse),
+  3,
+  stabilize_response__field_descriptors,
+  stabilize_response__field_indices_by_name,
+  1,  stabilize_response__number_ranges,
+  (ProtobufCMessageInit) stabilize_response__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor put_request__field_descriptors[4] =
+{
+  {
+    "id",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_FIXED64,
+    0,   /* quantifier_offset */
+    offsetof(PutRequest, id),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "key",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_BYTES,
+    0,   /* quantifier_offset */
+    offsetof(PutRequest, key),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "value",
+    3,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_BYTES,
+    0,   /* quantifier_offset */
+    offsetof(PutRequest, value),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "version",
+    4,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(PutRequest, has_version),
+    offsetof(PutRequest, version),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned put_request__field_indices_by_name[] = {
+  0,   /* field[0] = id */
+  1,   /* field[1] = key */
+  2,   /* field[2] = value */
+  3,   /* field[3] = version */
+};
+static const ProtobufCIntRange put_request__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 4 }
+};
+const ProtobufCMessageDescriptor put_request__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "PutRequest",
+  "PutRequest",
+  "PutRequest",
+  "",
+  sizeof(PutRequest),
+  4,
+  put_request__field_descriptors,
+  put_request__field_indices_by_name,
+  1,  put_request__number_ranges,
+  (ProtobufCMessageInit) put_request__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor put_response__field_descriptors[1] =
+{
+  {
+    "failed",
+    1,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_BOOL,
+    offsetof(PutResponse, has_failed),
+    offsetof(PutResponse, failed),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned put_response__field_indices_by_name[] = {
+  0,   /* field[0] = failed */
+};
+static const ProtobufCIntRange put_response__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 1 }
+};
+const ProtobufCMessageDescriptor put_response__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "PutResponse",
+  "PutResponse",
+  "PutResponse",
+  "",
+  sizeof(PutResponse),
+  1,
+  put_response__field_descriptors,
+  put_response__field_indices_by_name,
+  1,  put_response__number_ranges,
+  (ProtobufCMessageInit) put_response__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor get_request__field_descriptors[3] =
+{
+  {
+    "id",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_FIXED64,
+    0,   /* quantifier_offset */
+    offsetof(GetRequest, id),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "key",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_BYTES,
+    0,   /* quantifier_offset */
+    offsetof(GetRequest, key),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "replica",
+    3,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_BOOL,
+    offsetof(GetRequest, has_replica),
+    offsetof(GetRequest, replica),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned get_request__field_indices_by_name[] = {
+  0,   /* field[0] = id */
+  1,   /* field[1] = key */
+  2,   /* field[2] = replica */
+};
+static const ProtobufCIntRange get_request__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 3 }
+};
+const ProtobufCMessageDescriptor get_request__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "GetRequest",
+  "GetRequest",
+  "GetRequest",
+  "",
+  sizeof(GetRequest),
+  3,
+  get_request__field_descriptors,
+  get_request__field_indices_by_name,
+  1,  get_request__number_ranges,
+  (ProtobufCMessageInit) get_request__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor get_response__field_descriptors[5] =
+{
+  {
+    "found",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_BOOL,
+    0,   /* quantifier_offset */
+    offsetof(GetResponse, found),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "value",
+    2,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_BYTES,
+    offsetof(GetResponse, has_value),
+    offsetof(GetResponse, value),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "version",
+    3,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(GetResponse, has_version),
+    offsetof(GetResponse, version),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "failed",
+    4,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_BOOL,
+    offsetof(GetResponse, has_failed),
+    offsetof(GetResponse, failed),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "replicas",
+    5,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(GetResponse, n_replicas),
+    offsetof(GetResponse, replicas),
+    &node__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned get_response__field_indices_by_name[] = {
+  3,   /* field[3] = failed */
+  0,   /* field[0] = found */
+  4,   /* field[4] = replicas */
+  1,   /* field[1] = value */
+  2,   /* field[2] = version */
+};
+static const ProtobufCIntRange get_response__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 5 }
+};
+const ProtobufCMessageDescriptor get_response__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "GetResponse",
+  "GetResponse",
+  "GetResponse",
+  "",
+  sizeof(GetResponse),
+  5,
+  get_response__field_descriptors,
+  get_response__field_indices_by_name,
+  1,  get_response__number_ranges,
+  (ProtobufCMessageInit) get_response__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor delete_request__field_descriptors[4] =
 {
   {
-    "node",
+    "id",
     1,
     PROTOBUF_C_LABEL_REQUIRED,
-    PROTOBUF_C_TYPE_MESSAGE,
+    PROTOBUF_C_TYPE_FIXED64,
     0,   /* quantifier_offset */
-    offsetof(FindSuccessorResponse, node),
-    &node__descriptor,
+    offsetof(DeleteRequest, id),
+    NULL,
     NULL,
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
@@ -825,266 +2531,919 @@ static const ProtobufCFieldDescriptor find_successor_response__field_descriptors
   {
     "key",
     2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_BYTES,
+    0,   /* quantifier_offset */
+    offsetof(DeleteRequest, key),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "replica",
+    3,
     PROTOBUF_C_LABEL_OPTIONAL,
-    PROTOBUF_C_TYPE_FIXED64,
-    offsetof(FindSuccessorResponse, has_key),
-    offsetof(FindSuccessorResponse, key),
+    PROTOBUF_C_TYPE_BOOL,
+    offsetof(DeleteRequest, has_replica),
+    offsetof(DeleteRequest, replica),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "version",
+    4,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(DeleteRequest, has_version),
+    offsetof(DeleteRequest, version),
     NULL,
     NULL,
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
 };
-static const unsigned find_successor_response__field_indices_by_name[] = {
+static const unsigned delete_request__field_indices_by_name[] = {
+  0,   /* field[0] = id */
   1,   /* field[1] = key */
-  0,   /* field[0] = node */
+  2,   /* field[2] = replica */
+  3,   /* field[3] = version */
 };
-static const ProtobufCIntRange find_successor_response__number_ranges[1 + 1] =
+static const ProtobufCIntRange delete_request__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 4 }
+};
+const ProtobufCMessageDescriptor delete_request__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "DeleteRequest",
+  "DeleteRequest",
+  "DeleteRequest",
+  "",
+  sizeof(DeleteRequest),
+  4,
+  delete_request__field_descriptors,
+  delete_request__field_indices_by_name,
+  1,  delete_request__number_ranges,
+  (ProtobufCMessageInit) delete_request__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor delete_response__field_descriptors[2] =
+{
+  {
+    "found",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_BOOL,
+    0,   /* quantifier_offset */
+    offsetof(DeleteResponse, found),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "failed",
+    2,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_BOOL,
+    offsetof(DeleteResponse, has_failed),
+    offsetof(DeleteResponse, failed),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned delete_response__field_indices_by_name[] = {
+  1,   /* field[1] = failed */
+  0,   /* field[0] = found */
+};
+static const ProtobufCIntRange delete_response__number_ranges[1 + 1] =
 {
   { 1, 0 },
   { 0, 2 }
 };
-const ProtobufCMessageDescriptor find_successor_response__descriptor =
+const ProtobufCMessageDescriptor delete_response__descriptor =
 {
   PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
-  "FindSuccessorResponse",
-  "FindSuccessorResponse",
-  "FindSuccessorResponse",
+  "DeleteResponse",
+  "DeleteResponse",
+  "DeleteResponse",
   "",
-  sizeof(FindSuccessorResponse),
+  sizeof(DeleteResponse),
   2,
-  find_successor_response__field_descriptors,
-  find_successor_response__field_indices_by_name,
-  1,  find_successor_response__number_ranges,
-  (ProtobufCMessageInit) find_successor_response__init,
+  delete_response__field_descriptors,
+  delete_response__field_indices_by_name,
+  1,  delete_response__number_ranges,
+  (ProtobufCMessageInit) delete_response__init,
   NULL,NULL,NULL    /* reserved[123] */
 };
-static const ProtobufCFieldDescriptor start_find_successor_request__field_descriptors[1] =
+static const ProtobufCFieldDescriptor key_value__field_descriptors[5] =
 {
+  {
+    "id",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_FIXED64,
+    0,   /* quantifier_offset */
+    offsetof(KeyValue, id),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
   {
     "key",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_BYTES,
+    0,   /* quantifier_offset */
+    offsetof(KeyValue, key),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "value",
+    3,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_BYTES,
+    0,   /* quantifier_offset */
+    offsetof(KeyValue, value),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "version",
+    4,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(KeyValue, version),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "deleted",
+    5,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_BOOL,
+    offsetof(KeyValue, has_deleted),
+    offsetof(KeyValue, deleted),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned key_value__field_indices_by_name[] = {
+  4,   /* field[4] = deleted */
+  0,   /* field[0] = id */
+  1,   /* field[1] = key */
+  2,   /* field[2] = value */
+  3,   /* field[3] = version */
+};
+static const ProtobufCIntRange key_value__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 5 }
+};
+const ProtobufCMessageDescriptor key_value__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "KeyValue",
+  "KeyValue",
+  "KeyValue",
+  "",
+  sizeof(KeyValue),
+  5,
+  key_value__field_descriptors,
+  key_value__field_indices_by_name,
+  1,  key_value__number_ranges,
+  (ProtobufCMessageInit) key_value__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor handoff_request__field_descriptors[5] =
+{
+  {
+    "start",
     1,
     PROTOBUF_C_LABEL_REQUIRED,
     PROTOBUF_C_TYPE_FIXED64,
     0,   /* quantifier_offset */
-    offsetof(StartFindSuccessorRequest, key),
+    offsetof(HandoffRequest, start),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "end",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_FIXED64,
+    0,   /* quantifier_offset */
+    offsetof(HandoffRequest, end),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "cursor",
+    3,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(HandoffRequest, has_cursor),
+    offsetof(HandoffRequest, cursor),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "generation",
+    4,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(HandoffRequest, has_generation),
+    offsetof(HandoffRequest, generation),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "release",
+    5,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_BOOL,
+    offsetof(HandoffRequest, has_release),
+    offsetof(HandoffRequest, release),
     NULL,
     NULL,
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
 };
-static const unsigned start_find_successor_request__field_indices_by_name[] = {
-  0,   /* field[0] = key */
+static const unsigned handoff_request__field_indices_by_name[] = {
+  2,   /* field[2] = cursor */
+  1,   /* field[1] = end */
+  3,   /* field[3] = generation */
+  4,   /* field[4] = release */
+  0,   /* field[0] = start */
 };
-static const ProtobufCIntRange start_find_successor_request__number_ranges[1 + 1] =
+static const ProtobufCIntRange handoff_request__number_ranges[1 + 1] =
 {
   { 1, 0 },
-  { 0, 1 }
+  { 0, 5 }
 };
-const ProtobufCMessageDescriptor start_find_successor_request__descriptor =
+const ProtobufCMessageDescriptor handoff_request__descriptor =
 {
   PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
-  "StartFindSuccessorRequest",
-  "StartFindSuccessorRequest",
-  "StartFindSuccessorRequest",
+  "HandoffRequest",
+  "HandoffRequest",
+  "HandoffRequest",
   "",
-  sizeof(StartFindSuccessorRequest),
-  1,
-  start_find_successor_request__field_descriptors,
-  start_find_successor_request__field_indices_by_name,
-  1,  start_find_successor_request__number_ranges,
-  (ProtobufCMessageInit) start_find_successor_request__init,
+  sizeof(HandoffRequest),
+  5,
+  handoff_request__field_descriptors,
+  handoff_request__field_indices_by_name,
+  1,  handoff_request__number_ranges,
+  (ProtobufCMessageInit) handoff_request__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor handoff_response__field_descriptors[4] =
+{
+  {
+    "items",
+    1,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(HandoffResponse, n_items),
+    offsetof(HandoffResponse, items),
+    &key_value__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "cursor",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(HandoffResponse, cursor),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "generation",
+    3,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(HandoffResponse, generation),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "done",
+    4,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_BOOL,
+    0,   /* quantifier_offset */
+    offsetof(HandoffResponse, done),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned handoff_response__field_indices_by_name[] = {
+  1,   /* field[1] = cursor */
+  3,   /* field[3] = done */
+  2,   /* field[2] = generation */
+  0,   /* field[0] = items */
+};
+static const ProtobufCIntRange handoff_response__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 4 }
+};
+const ProtobufCMessageDescriptor handoff_response__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "HandoffResponse",
+  "HandoffResponse",
+  "HandoffResponse",
+  "",
+  sizeof(HandoffResponse),
+  4,
+  handoff_response__field_descriptors,
+  handoff_response__field_indices_by_name,
+  1,  handoff_response__number_ranges,
+  (ProtobufCMessageInit) handoff_response__init,
   NULL,NULL,NULL    /* reserved[123] */
 };
-static const ProtobufCFieldDescriptor start_find_successor_response__field_descriptors[1] =
+static const ProtobufCFieldDescriptor leave_request__field_descriptors[1] =
 {
   {
-    "node",
+    "predecessor",
     1,
-    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_LABEL_OPTIONAL,
     PROTOBUF_C_TYPE_MESSAGE,
     0,   /* quantifier_offset */
-    offsetof(StartFindSuccessorResponse, node),
+    offsetof(LeaveRequest, predecessor),
     &node__descriptor,
     NULL,
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
 };
-static const unsigned start_find_successor_response__field_indices_by_name[] = {
-  0,   /* field[0] = node */
+static const unsigned leave_request__field_indices_by_name[] = {
+  0,   /* field[0] = predecessor */
 };
-static const ProtobufCIntRange start_find_successor_response__number_ranges[1 + 1] =
+static const ProtobufCIntRange leave_request__number_ranges[1 + 1] =
 {
   { 1, 0 },
   { 0, 1 }
 };
-const ProtobufCMessageDescriptor start_find_successor_response__descriptor =
+const ProtobufCMessageDescriptor leave_request__descriptor =
 {
   PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
-  "StartFindSuccessorResponse",
-  "StartFindSuccessorResponse",
-  "StartFindSuccessorResponse",
+  "LeaveRequest",
+  "LeaveRequest",
+  "LeaveRequest",
   "",
-  sizeof(StartFindSuccessorResponse),
+  sizeof(LeaveRequest),
   1,
-  start_find_successor_response__field_descriptors,
-  start_find_successor_response__field_indices_by_name,
-  1,  start_find_successor_response__number_ranges,
-  (ProtobufCMessageInit) start_find_successor_response__init,
+  leave_request__field_descriptors,
+  leave_request__field_indices_by_name,
+  1,  leave_request__number_ranges,
+  (ProtobufCMessageInit) leave_request__init,
   NULL,NULL,NULL    /* reserved[123] */
 };
-#define get_predecessor_request__field_descriptors NULL
-#define get_predecessor_request__field_indices_by_name NULL
-#define get_predecessor_request__number_ranges NULL
-const ProtobufCMessageDescriptor get_predecessor_request__descriptor =
+#define leave_response__field_descriptors NULL
+#define leave_response__field_indices_by_name NULL
+#define leave_response__number_ranges NULL
+const ProtobufCMessageDescriptor leave_response__descriptor =
 {
   PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
-  "GetPredecessorRequest",
-  "GetPredecessorRequest",
-  "GetPredecessorRequest",
+  "LeaveResponse",
+  "LeaveResponse",
+  "LeaveResponse",
   "",
-  sizeof(GetPredecessorRequest),
+  sizeof(LeaveResponse),
   0,
-  get_predecessor_request__field_descriptors,
-  get_predecessor_request__field_indices_by_name,
-  0,  get_predecessor_request__number_ranges,
-  (ProtobufCMessageInit) get_predecessor_request__init,
+  leave_response__field_descriptors,
+  leave_response__field_indices_by_name,
+  0,  leave_response__number_ranges,
+  (ProtobufCMessageInit) leave_response__init,
   NULL,NULL,NULL    /* reserved[123] */
 };
-static const ProtobufCFieldDescriptor get_predecessor_response__field_descriptors[1] =
+static const ProtobufCFieldDescriptor histogram__field_descriptors[3] =
 {
   {
-    "node",
+    "buckets",
     1,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(Histogram, n_buckets),
+    offsetof(Histogram, buckets),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "count",
+    2,
     PROTOBUF_C_LABEL_REQUIRED,
-    PROTOBUF_C_TYPE_MESSAGE,
+    PROTOBUF_C_TYPE_UINT64,
     0,   /* quantifier_offset */
-    offsetof(GetPredecessorResponse, node),
-    &node__descriptor,
+    offsetof(Histogram, count),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "sum",
+    3,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Histogram, sum),
+    NULL,
     NULL,
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
 };
-static const unsigned get_predecessor_response__field_indices_by_name[] = {
-  0,   /* field[0] = node */
+static const unsigned histogram__field_indices_by_name[] = {
+  0,   /* field[0] = buckets */
+  1,   /* field[1] = count */
+  2,   /* field[2] = sum */
 };
-static const ProtobufCIntRange get_predecessor_response__number_ranges[1 + 1] =
+static const ProtobufCIntRange histogram__number_ranges[1 + 1] =
 {
   { 1, 0 },
-  { 0, 1 }
+  { 0, 3 }
 };
-const ProtobufCMessageDescriptor get_predecessor_response__descriptor =
+const ProtobufCMessageDescriptor histogram__descriptor =
 {
   PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
-  "GetPredecessorResponse",
-  "GetPredecessorResponse",
-  "GetPredecessorResponse",
+  "Histogram",
+  "Histogram",
+  "Histogram",
   "",
-  sizeof(GetPredecessorResponse),
-  1,
-  get_predecessor_response__field_descriptors,
-  get_predecessor_response__field_indices_by_name,
-  1,  get_predecessor_response__number_ranges,
-  (ProtobufCMessageInit) get_predecessor_response__init,
+  sizeof(Histogram),
+  3,
+  histogram__field_descriptors,
+  histogram__field_indices_by_name,
+  1,  histogram__number_ranges,
+  (ProtobufCMessageInit) histogram__init,
   NULL,NULL,NULL    /* reserved[123] */
 };
-#define check_predecessor_request__field_descriptors NULL
-#define check_predecessor_request__field_indices_by_name NULL
-#define check_predecessor_request__number_ranges NULL
-const ProtobufCMessageDescriptor check_predecessor_request__descriptor =
+static const ProtobufCFieldDescriptor stats__field_descriptors[20] =
 {
-  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
-  "CheckPredecessorRequest",
-  "CheckPredecessorRequest",
-  "CheckPredecessorRequest",
-  "",
-  sizeof(CheckPredecessorRequest),
-  0,
-  check_predecessor_request__field_descriptors,
-  check_predecessor_request__field_indices_by_name,
-  0,  check_predecessor_request__number_ranges,
-  (ProtobufCMessageInit) check_predecessor_request__init,
-  NULL,NULL,NULL    /* reserved[123] */
+  {
+    "messages_in",
+    1,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(Stats, n_messages_in),
+    offsetof(Stats, messages_in),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "messages_out",
+    2,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(Stats, n_messages_out),
+    offsetof(Stats, messages_out),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "datagrams_in",
+    3,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Stats, datagrams_in),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "datagrams_out",
+    4,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Stats, datagrams_out),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "bytes_in",
+    5,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Stats, bytes_in),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "bytes_out",
+    6,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Stats, bytes_out),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "rpc_calls",
+    7,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Stats, rpc_calls),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "rpc_timeouts",
+    8,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Stats, rpc_timeouts),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "rpc_latency_us",
+    9,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    0,   /* quantifier_offset */
+    offsetof(Stats, rpc_latency_us),
+    &histogram__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "lookups",
+    10,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Stats, lookups),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "lookups_failed",
+    11,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Stats, lookups_failed),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "lookup_latency_us",
+    12,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    0,   /* quantifier_offset */
+    offsetof(Stats, lookup_latency_us),
+    &histogram__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "lookup_hops",
+    13,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    0,   /* quantifier_offset */
+    offsetof(Stats, lookup_hops),
+    &histogram__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "stabilize_rounds",
+    14,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Stats, stabilize_rounds),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "fix_fingers_rounds",
+    15,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Stats, fix_fingers_rounds),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "successor_changes",
+    16,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Stats, successor_changes),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "predecessor_changes",
+    17,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Stats, predecessor_changes),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "finger_changes",
+    18,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(Stats, finger_changes),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "requests_busy",
+    19,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(Stats, has_requests_busy),
+    offsetof(Stats, requests_busy),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "requests_dropped",
+    20,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(Stats, has_requests_dropped),
+    offsetof(Stats, requests_dropped),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned stats__field_indices_by_name[] = {
+  4,   /* field[4] = bytes_in */
+  5,   /* field[5] = bytes_out */
+  2,   /* field[2] = datagrams_in */
+  3,   /* field[3] = datagrams_out */
+  17,   /* field[17] = finger_changes */
+  14,   /* field[14] = fix_fingers_rounds */
+  12,   /* field[12] = lookup_hops */
+  11,   /* field[11] = lookup_latency_us */
+  9,   /* field[9] = lookups */
+  10,   /* field[10] = lookups_failed */
+  0,   /* field[0] = messages_in */
+  1,   /* field[1] = messages_out */
+  16,   /* field[16] = predecessor_changes */
+  18,   /* field[18] = requests_busy */
+  19,   /* field[19] = requests_dropped */
+  6,   /* field[6] = rpc_calls */
+  8,   /* field[8] = rpc_latency_us */
+  7,   /* field[7] = rpc_timeouts */
+  13,   /* field[13] = stabilize_rounds */
+  15,   /* field[15] = successor_changes */
+};
+static const ProtobufCIntRange stats__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 20 }
 };
-#define check_predecessor_response__field_descriptors NULL
-#define check_predecessor_response__field_indices_by_name NULL
-#define check_predecessor_response__number_ranges NULL
-const ProtobufCMessageDescriptor check_predecessor_response__descriptor =
+const ProtobufCMessageDescriptor stats__descriptor =
 {
   PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
-  "CheckPredecessorResponse",
-  "CheckPredecessorResponse",
-  "CheckPredecessorResponse",
+  "Stats",
+  "Stats",
+  "Stats",
   "",
-  sizeof(CheckPredecessorResponse),
-  0,
-  check_predecessor_response__field_descriptors,
-  check_predecessor_response__field_indices_by_name,
-  0,  check_predecessor_response__number_ranges,
-  (ProtobufCMessageInit) check_predecessor_response__init,
+  sizeof(Stats),
+  20,
+  stats__field_descriptors,
+  stats__field_indices_by_name,
+  1,  stats__number_ranges,
+  (ProtobufCMessageInit) stats__init,
   NULL,NULL,NULL    /* reserved[123] */
 };
-#define get_successor_list_request__field_descriptors NULL
-#define get_successor_list_request__field_indices_by_name NULL
-#define get_successor_list_request__number_ranges NULL
-const ProtobufCMessageDescriptor get_successor_list_request__descriptor =
+#define stats_request__field_descriptors NULL
+#define stats_request__field_indices_by_name NULL
+#define stats_request__number_ranges NULL
+const ProtobufCMessageDescriptor stats_request__descriptor =
 {
   PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
-  "GetSuccessorListRequest",
-  "GetSuccessorListRequest",
-  "GetSuccessorListRequest",
+  "StatsRequest",
+  "StatsRequest",
+  "StatsRequest",
   "",
-  sizeof(GetSuccessorListRequest),
+  sizeof(StatsRequest),
   0,
-  get_successor_list_request__field_descriptors,
-  get_successor_list_request__field_indices_by_name,
-  0,  get_successor_list_request__number_ranges,
-  (ProtobufCMessageInit) get_successor_list_request__init,
+  stats_request__field_descriptors,
+  stats_request__field_indices_by_name,
+  0,  stats_request__number_ranges,
+  (ProtobufCMessageInit) stats_request__init,
   NULL,NULL,NULL    /* reserved[123] */
 };
-static const ProtobufCFieldDescriptor get_successor_list_response__field_descriptors[1] =
+static const ProtobufCFieldDescriptor stats_response__field_descriptors[1] =
 {
   {
-    "successors",
+    "stats",
     1,
-    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_LABEL_REQUIRED,
     PROTOBUF_C_TYPE_MESSAGE,
-    offsetof(GetSuccessorListResponse, n_successors),
-    offsetof(GetSuccessorListResponse, successors),
-    &node__descriptor,
+    0,   /* quantifier_offset */
+    offsetof(StatsResponse, stats),
+    &stats__descriptor,
     NULL,
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
 };
-static const unsigned get_successor_list_response__field_indices_by_name[] = {
-  0,   /* field[0] = successors */
+static const unsigned stats_response__field_indices_by_name[] = {
+  0,   /* field[0] = stats */
 };
-static const ProtobufCIntRange get_successor_list_response__number_ranges[1 + 1] =
+static const ProtobufCIntRange stats_response__number_ranges[1 + 1] =
 {
   { 1, 0 },
   { 0, 1 }
 };
-const ProtobufCMessageDescriptor get_successor_list_response__descriptor =
+const ProtobufCMessageDescriptor stats_response__descriptor =
 {
   PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
-  "GetSuccessorListResponse",
-  "GetSuccessorListResponse",
-  "GetSuccessorListResponse",
+  "StatsResponse",
+  "StatsResponse",
+  "StatsResponse",
   "",
-  sizeof(GetSuccessorListResponse),
+  sizeof(StatsResponse),
   1,
-  get_successor_list_response__field_descriptors,
-  get_successor_list_response__field_indices_by_name,
-  1,  get_successor_list_response__number_ranges,
-  (ProtobufCMessageInit) get_successor_list_response__init,
+  stats_response__field_descriptors,
+  stats_response__field_indices_by_name,
+  1,  stats_response__number_ranges,
+  (ProtobufCMessageInit) stats_response__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+#define busy_response__field_descriptors NULL
+#define busy_response__field_indices_by_name NULL
+#define busy_response__number_ranges NULL
+const ProtobufCMessageDescriptor busy_response__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "BusyResponse",
+  "BusyResponse",
+  "BusyResponse",
+  "",
+  sizeof(BusyResponse),
+  0,
+  busy_response__field_descriptors,
+  busy_response__field_indices_by_name,
+  0,  busy_response__number_ranges,
+  (ProtobufCMessageInit) busy_response__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor trace_context__field_descriptors[3] =
+{
+  {
+    "trace_id",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_FIXED64,
+    0,   /* quantifier_offset */
+    offsetof(TraceContext, trace_id),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "hop",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(TraceContext, hop),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "sent_us",
+    3,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_FIXED64,
+    0,   /* quantifier_offset */
+    offsetof(TraceContext, sent_us),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned trace_context__field_indices_by_name[] = {
+  1,   /* field[1] = hop */
+  2,   /* field[2] = sent_us */
+  0,   /* field[0] = trace_id */
+};
+static const ProtobufCIntRange trace_context__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 3 }
+};
+const ProtobufCMessageDescriptor trace_context__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "TraceContext",
+  "TraceContext",
+  "TraceContext",
+  "",
+  sizeof(TraceContext),
+  3,
+  trace_context__field_descriptors,
+  trace_context__field_indices_by_name,
+  1,  trace_context__number_ranges,
+  (ProtobufCMessageInit) trace_context__init,
   NULL,NULL,NULL    /* reserved[123] */
 };
 static const uint32_t chord_message__version__default_value = 417u;
-static const ProtobufCFieldDescriptor chord_message__field_descriptors[14] =
+static const ProtobufCFieldDescriptor chord_message__field_descriptors[34] =
 {
   {
     "version",
@@ -1254,28 +3613,288 @@ static const ProtobufCFieldDescriptor chord_message__field_descriptors[14] =
     0 | PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
+  {
+    "find_successors_request",
+    17,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ChordMessage, msg_case),
+    offsetof(ChordMessage, find_successors_request),
+    &find_successors_request__descriptor,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "find_successors_response",
+    18,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ChordMessage, msg_case),
+    offsetof(ChordMessage, find_successors_response),
+    &find_successors_response__descriptor,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "put_request",
+    19,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ChordMessage, msg_case),
+    offsetof(ChordMessage, put_request),
+    &put_request__descriptor,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "put_response",
+    20,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ChordMessage, msg_case),
+    offsetof(ChordMessage, put_response),
+    &put_response__descriptor,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "get_request",
+    21,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ChordMessage, msg_case),
+    offsetof(ChordMessage, get_request),
+    &get_request__descriptor,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "get_response",
+    22,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ChordMessage, msg_case),
+    offsetof(ChordMessage, get_response),
+    &get_response__descriptor,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "delete_request",
+    23,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ChordMessage, msg_case),
+    offsetof(ChordMessage, delete_request),
+    &delete_request__descriptor,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "delete_response",
+    24,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ChordMessage, msg_case),
+    offsetof(ChordMessage, delete_response),
+    &delete_response__descriptor,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "handoff_request",
+    25,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ChordMessage, msg_case),
+    offsetof(ChordMessage, handoff_request),
+    &handoff_request__descriptor,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "handoff_response",
+    26,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ChordMessage, msg_case),
+    offsetof(ChordMessage, handoff_response),
+    &handoff_response__descriptor,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "leave_request",
+    27,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ChordMessage, msg_case),
+    offsetof(ChordMessage, leave_request),
+    &leave_request__descriptor,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "leave_response",
+    28,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ChordMessage, msg_case),
+    offsetof(ChordMessage, leave_response),
+    &leave_response__descriptor,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "target",
+    29,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_FIXED64,
+    offsetof(ChordMessage, has_target),
+    offsetof(ChordMessage, target),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "stats_request",
+    30,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ChordMessage, msg_case),
+    offsetof(ChordMessage, stats_request),
+    &stats_request__descriptor,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "stats_response",
+    31,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ChordMessage, msg_case),
+    offsetof(ChordMessage, stats_response),
+    &stats_response__descriptor,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "trace",
+    32,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    0,   /* quantifier_offset */
+    offsetof(ChordMessage, trace),
+    &trace_context__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "features",
+    33,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(ChordMessage, has_features),
+    offsetof(ChordMessage, features),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "stabilize_request",
+    34,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ChordMessage, msg_case),
+    offsetof(ChordMessage, stabilize_request),
+    &stabilize_request__descriptor,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "stabilize_response",
+    35,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ChordMessage, msg_case),
+    offsetof(ChordMessage, stabilize_response),
+    &stabilize_response__descriptor,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "busy_response",
+    36,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ChordMessage, msg_case),
+    offsetof(ChordMessage, busy_response),
+    &busy_response__descriptor,
+    NULL,
+    0 | PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
 };
 static const unsigned chord_message__field_indices_by_name[] = {
+  33,   /* field[33] = busy_response */
   7,   /* field[7] = check_predecessor_request */
   8,   /* field[8] = check_predecessor_response */
+  20,   /* field[20] = delete_request */
+  21,   /* field[21] = delete_response */
+  30,   /* field[30] = features */
   3,   /* field[3] = find_successor_request */
   4,   /* field[4] = find_successor_response */
+  14,   /* field[14] = find_successors_request */
+  15,   /* field[15] = find_successors_response */
   5,   /* field[5] = get_predecessor_request */
   6,   /* field[6] = get_predecessor_response */
+  18,   /* field[18] = get_request */
+  19,   /* field[19] = get_response */
   9,   /* field[9] = get_successor_list_request */
   10,   /* field[10] = get_successor_list_response */
+  22,   /* field[22] = handoff_request */
+  23,   /* field[23] = handoff_response */
+  24,   /* field[24] = leave_request */
+  25,   /* field[25] = leave_response */
   1,   /* field[1] = notify_request */
   2,   /* field[2] = notify_response */
+  16,   /* field[16] = put_request */
+  17,   /* field[17] = put_response */
   11,   /* field[11] = query_id */
+  31,   /* field[31] = stabilize_request */
+  32,   /* field[32] = stabilize_response */
   12,   /* field[12] = start_find_successor_request */
   13,   /* field[13] = start_find_successor_response */
+  27,   /* field[27] = stats_request */
+  28,   /* field[28] = stats_response */
+  26,   /* field[26] = target */
+  29,   /* field[29] = trace */
   0,   /* field[0] = version */
 };
 static const ProtobufCIntRange chord_message__number_ranges[2 + 1] =
 {
   { 1, 0 },
   { 14, 11 },
-  { 0, 14 }
+  { 0, 34 }
 };
 const ProtobufCMessageDescriptor chord_message__descriptor =
 {
@@ -1285,7 +3904,7 @@ const ProtobufCMessageDescriptor chord_message__descriptor =
   "ChordMessage",
   "",
   sizeof(ChordMessage),
-  14,
+  34,
   chord_message__field_descriptors,
   chord_message__field_indices_by_name,
   2,  chord_message__number_ranges,
@@ -20,6 +20,8 @@ typedef struct _NotifyRequest NotifyRequest;
 typedef struct _NotifyResponse NotifyResponse;
 typedef struct _FindSuccessorRequest FindSuccessorRequest;
 typedef struct _FindSuccessorResponse FindSuccessorResponse;
+typedef struct _FindSuccessorsRequest FindSuccessorsRequest;
+typedef struct _FindSuccessorsResponse FindSuccessorsResponse;
 typedef struct _StartFindSuccessorRequest StartFindSuccessorRequest;
 typedef struct _StartFindSuccessorResponse StartFindSuccessorResponse;
 typedef struct _GetPredecessorRequest GetPredecessorRequest;
@@ -28,6 +30,25 @@ typedef struct _CheckPredecessorRequest CheckPredecessorRequest;
 typedef struct _CheckPredecessorResponse CheckPredecessorResponse;
 typedef struct _GetSuccessorListRequest GetSuccessorListRequest;
 typedef struct _GetSuccessorListResponse GetSuccessorListResponse;
+typedef struct _StabilizeRequest StabilizeRequest;
+typedef struct _StabilizeResponse StabilizeResponse;
+typedef struct _PutRequest PutRequest;
+typedef struct _PutResponse PutResponse;
+typedef struct _GetRequest GetRequest;
+typedef struct _GetResponse GetResponse;
+typedef struct _DeleteRequest DeleteRequest;
+typedef struct _DeleteResponse DeleteResponse;
+typedef struct _KeyValue KeyValue;
+typedef struct _HandoffRequest HandoffRequest;
+typedef struct _HandoffResponse HandoffResponse;
+typedef struct _LeaveRequest LeaveRequest;
+typedef struct _LeaveResponse LeaveResponse;
+typedef struct _Histogram Histogram;
+typedef struct _Stats Stats;
+typedef struct _StatsRequest StatsRequest;
+typedef struct _StatsResponse StatsResponse;
+typedef struct _BusyResponse BusyResponse;
+typedef struct _TraceContext TraceContext;
 typedef struct _ChordMessage ChordMessage;
 
 
@@ -84,10 +105,15 @@ struct  _FindSuccessorRequest
    * allows recursive to actually be more efficient
    */
   Node *requester;
+  /*
+   * sent to a cached owner, which answers for itself if it still holds the key
+   */
+  protobuf_c_boolean has_probe;
+  protobuf_c_boolean probe;
 };
 #define FIND_SUCCESSOR_REQUEST__INIT \
  { PROTOBUF_C_MESSAGE_INIT (&find_successor_request__descriptor) \
-    , 0, NULL }
+    , 0, NULL, 0, 0 }
 
 
 struct  _FindSuccessorResponse
@@ -105,6 +131,36 @@ struct  _FindSuccessorResponse
     , NULL, 0, 0 }
 
 
+/*
+ * Find Successors, many keys routed through the same hop in one datagram
+ */
+struct  _FindSuccessorsRequest
+{
+  ProtobufCMessage base;
+  size_t n_keys;
+  uint64_t *keys;
+};
+#define FIND_SUCCESSORS_REQUEST__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&find_successors_request__descriptor) \
+    , 0,NULL }
+
+
+struct  _FindSuccessorsResponse
+{
+  ProtobufCMessage base;
+  size_t n_keys;
+  uint64_t *keys;
+  /*
+   * nodes[i] answers keys[i]
+   */
+  size_t n_nodes;
+  Node **nodes;
+};
+#define FIND_SUCCESSORS_RESPONSE__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&find_successors_response__descriptor) \
+    , 0,NULL, 0,NULL }
+
+
 struct  _StartFindSuccessorRequest
 {
   ProtobufCMessage base;
@@ -191,6 +247,353 @@ struct  _GetSuccessorListResponse
     , 0,NULL }
 
 
+/*
+ * Stabilize, get predecessor, notify and get successor list in one exchange,
+ * sent to peers whose features include it
+ */
+struct  _StabilizeRequest
+{
+  ProtobufCMessage base;
+  /*
+   * Notifies the successor of the sender
+   */
+  Node *node;
+  /*
+   * Of the successor list the sender holds, see successor_list_digest()
+   */
+  uint64_t successors_digest;
+};
+#define STABILIZE_REQUEST__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&stabilize_request__descriptor) \
+    , NULL, 0 }
+
+
+struct  _StabilizeResponse
+{
+  ProtobufCMessage base;
+  /*
+   * After the notify, key 0 if none
+   */
+  Node *predecessor;
+  size_t n_successors;
+  Node **successors;
+  /*
+   * Successors left out, they match the digest
+   */
+  protobuf_c_boolean has_unchanged;
+  protobuf_c_boolean unchanged;
+};
+#define STABILIZE_RESPONSE__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&stabilize_response__descriptor) \
+    , NULL, 0,NULL, 0, 0 }
+
+
+/*
+ * Key-value store, sent straight to the owner once find_successor() found it.
+ * id is the key's position on the ring, key the application's own bytes.
+ * The owner copies writes to its replicas with the same messages, marked
+ * replica (and carrying the version the owner assigned), which replicas
+ * apply locally without coordinating further. A delete leaves a tombstone
+ * with its own version, so a replica that missed it is outvoted by newer
+ * copies rather than bringing the value back.
+ */
+struct  _PutRequest
+{
+  ProtobufCMessage base;
+  uint64_t id;
+  ProtobufCBinaryData key;
+  ProtobufCBinaryData value;
+  /*
+   * Set on replica writes
+   */
+  protobuf_c_boolean has_version;
+  uint64_t version;
+};
+#define PUT_REQUEST__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&put_request__descriptor) \
+    , 0, {0,NULL}, {0,NULL}, 0, 0 }
+
+
+struct  _PutResponse
+{
+  ProtobufCMessage base;
+  /*
+   * Write quorum not reached
+   */
+  protobuf_c_boolean has_failed;
+  protobuf_c_boolean failed;
+};
+#define PUT_RESPONSE__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&put_response__descriptor) \
+    , 0, 0 }
+
+
+struct  _GetRequest
+{
+  ProtobufCMessage base;
+  uint64_t id;
+  ProtobufCBinaryData key;
+  /*
+   * Answer from the local copy only
+   */
+  protobuf_c_boolean has_replica;
+  protobuf_c_boolean replica;
+};
+#define GET_REQUEST__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&get_request__descriptor) \
+    , 0, {0,NULL}, 0, 0 }
+
+
+struct  _GetResponse
+{
+  ProtobufCMessage base;
+  protobuf_c_boolean found;
+  protobuf_c_boolean has_value;
+  ProtobufCBinaryData value;
+  /*
+   * Also set when not found because of a tombstone
+   */
+  protobuf_c_boolean has_version;
+  uint64_t version;
+  /*
+   * Read quorum not reached
+   */
+  protobuf_c_boolean has_failed;
+  protobuf_c_boolean failed;
+  /*
+   * The owner's, when the owner answers, for later stale reads
+   */
+  size_t n_replicas;
+  Node **replicas;
+};
+#define GET_RESPONSE__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&get_response__descriptor) \
+    , 0, 0, {0,NULL}, 0, 0, 0, 0, 0,NULL }
+
+
+struct  _DeleteRequest
+{
+  ProtobufCMessage base;
+  uint64_t id;
+  ProtobufCBinaryData key;
+  protobuf_c_boolean has_replica;
+  protobuf_c_boolean replica;
+  /*
+   * Of the tombstone, set on replica deletes
+   */
+  protobuf_c_boolean has_version;
+  uint64_t version;
+};
+#define DELETE_REQUEST__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&delete_request__descriptor) \
+    , 0, {0,NULL}, 0, 0, 0, 0 }
+
+
+struct  _DeleteResponse
+{
+  ProtobufCMessage base;
+  protobuf_c_boolean found;
+  protobuf_c_boolean has_failed;
+  protobuf_c_boolean failed;
+};
+#define DELETE_RESPONSE__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&delete_response__descriptor) \
+    , 0, 0, 0 }
+
+
+/*
+ * Key handoff, the new owner of a range pulls it from the old one in chunks.
+ * The cursor is a position in the sender's table, only meaningful for the
+ * generation it was issued in
+ */
+struct  _KeyValue
+{
+  ProtobufCMessage base;
+  uint64_t id;
+  ProtobufCBinaryData key;
+  ProtobufCBinaryData value;
+  uint64_t version;
+  /*
+   * A tombstone, value is empty
+   */
+  protobuf_c_boolean has_deleted;
+  protobuf_c_boolean deleted;
+};
+#define KEY_VALUE__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&key_value__descriptor) \
+    , 0, {0,NULL}, {0,NULL}, 0, 0, 0 }
+
+
+struct  _HandoffRequest
+{
+  ProtobufCMessage base;
+  /*
+   * Range (start, end]
+   */
+  uint64_t start;
+  uint64_t end;
+  protobuf_c_boolean has_cursor;
+  uint64_t cursor;
+  protobuf_c_boolean has_generation;
+  uint64_t generation;
+  /*
+   * Transfer complete, the sender may drop the range
+   */
+  protobuf_c_boolean has_release;
+  protobuf_c_boolean release;
+};
+#define HANDOFF_REQUEST__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&handoff_request__descriptor) \
+    , 0, 0, 0, 0, 0, 0, 0, 0 }
+
+
+struct  _HandoffResponse
+{
+  ProtobufCMessage base;
+  size_t n_items;
+  KeyValue **items;
+  uint64_t cursor;
+  uint64_t generation;
+  protobuf_c_boolean done;
+};
+#define HANDOFF_RESPONSE__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&handoff_response__descriptor) \
+    , 0,NULL, 0, 0, 0 }
+
+
+/*
+ * Graceful leave, the leaving node hands its range to its successor
+ */
+struct  _LeaveRequest
+{
+  ProtobufCMessage base;
+  Node *predecessor;
+};
+#define LEAVE_REQUEST__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&leave_request__descriptor) \
+    , NULL }
+
+
+struct  _LeaveResponse
+{
+  ProtobufCMessage base;
+};
+#define LEAVE_RESPONSE__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&leave_response__descriptor) \
+     }
+
+
+/*
+ * Counters since the node started, summed over all of its threads
+ */
+struct  _Histogram
+{
+  ProtobufCMessage base;
+  /*
+   * Log2 unless said otherwise: [0] counts 0, [i] counts [2^(i-1), 2^i)
+   */
+  size_t n_buckets;
+  uint64_t *buckets;
+  uint64_t count;
+  uint64_t sum;
+};
+#define HISTOGRAM__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&histogram__descriptor) \
+    , 0,NULL, 0, 0 }
+
+
+struct  _Stats
+{
+  ProtobufCMessage base;
+  /*
+   * Indexed by the ChordMessage field number of the message
+   */
+  size_t n_messages_in;
+  uint64_t *messages_in;
+  size_t n_messages_out;
+  uint64_t *messages_out;
+  uint64_t datagrams_in;
+  uint64_t datagrams_out;
+  uint64_t bytes_in;
+  uint64_t bytes_out;
+  uint64_t rpc_calls;
+  uint64_t rpc_timeouts;
+  Histogram *rpc_latency_us;
+  uint64_t lookups;
+  uint64_t lookups_failed;
+  Histogram *lookup_latency_us;
+  /*
+   * Linear, [i] counts lookups answered after i hops
+   */
+  Histogram *lookup_hops;
+  uint64_t stabilize_rounds;
+  uint64_t fix_fingers_rounds;
+  uint64_t successor_changes;
+  uint64_t predecessor_changes;
+  uint64_t finger_changes;
+  protobuf_c_boolean has_requests_busy;
+  uint64_t requests_busy;
+  protobuf_c_boolean has_requests_dropped;
+  uint64_t requests_dropped;
+};
+#define STATS__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&stats__descriptor) \
+    , 0,NULL, 0,NULL, 0, 0, 0, 0, 0, 0, NULL, 0, 0, NULL, NULL, 0, 0, 0, 0, 0, 0, 0, 0, 0 }
+
+
+struct  _StatsRequest
+{
+  ProtobufCMessage base;
+};
+#define STATS_REQUEST__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&stats_request__descriptor) \
+     }
+
+
+struct  _StatsResponse
+{
+  ProtobufCMessage base;
+  Stats *stats;
+};
+#define STATS_RESPONSE__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&stats_response__descriptor) \
+    , NULL }
+
+
+/*
+ * Answers a request the node is too backlogged to serve in time, the
+ * requester tries another hop instead of waiting out its timeout
+ */
+struct  _BusyResponse
+{
+  ProtobufCMessage base;
+};
+#define BUSY_RESPONSE__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&busy_response__descriptor) \
+     }
+
+
+/*
+ * Carried by every request of a sampled lookup, hop by hop
+ */
+struct  _TraceContext
+{
+  ProtobufCMessage base;
+  uint64_t trace_id;
+  /*
+   * Requests sent for the lookup before this one
+   */
+  uint32_t hop;
+  /*
+   * Sender's wall clock, microseconds
+   */
+  uint64_t sent_us;
+};
+#define TRACE_CONTEXT__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&trace_context__descriptor) \
+    , 0, 0, 0 }
+
+
 typedef enum {
   CHORD_MESSAGE__MSG__NOT_SET = 0,
   CHORD_MESSAGE__MSG_NOTIFY_REQUEST = 2,
@@ -204,7 +607,24 @@ typedef enum {
   CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_REQUEST = 10,
   CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_RESPONSE = 11,
   CHORD_MESSAGE__MSG_START_FIND_SUCCESSOR_REQUEST = 15,
-  CHORD_MESSAGE__MSG_START_FIND_SUCCESSOR_RESPONSE = 16
+  CHORD_MESSAGE__MSG_START_FIND_SUCCESSOR_RESPONSE = 16,
+  CHORD_MESSAGE__MSG_FIND_SUCCESSORS_REQUEST = 17,
+  CHORD_MESSAGE__MSG_FIND_SUCCESSORS_RESPONSE = 18,
+  CHORD_MESSAGE__MSG_PUT_REQUEST = 19,
+  CHORD_MESSAGE__MSG_PUT_RESPONSE = 20,
+  CHORD_MESSAGE__MSG_GET_REQUEST = 21,
+  CHORD_MESSAGE__MSG_GET_RESPONSE = 22,
+  CHORD_MESSAGE__MSG_DELETE_REQUEST = 23,
+  CHORD_MESSAGE__MSG_DELETE_RESPONSE = 24,
+  CHORD_MESSAGE__MSG_HANDOFF_REQUEST = 25,
+  CHORD_MESSAGE__MSG_HANDOFF_RESPONSE = 26,
+  CHORD_MESSAGE__MSG_LEAVE_REQUEST = 27,
+  CHORD_MESSAGE__MSG_LEAVE_RESPONSE = 28,
+  CHORD_MESSAGE__MSG_STATS_REQUEST = 30,
+  CHORD_MESSAGE__MSG_STATS_RESPONSE = 31,
+  CHORD_MESSAGE__MSG_STABILIZE_REQUEST = 34,
+  CHORD_MESSAGE__MSG_STABILIZE_RESPONSE = 35,
+  CHORD_MESSAGE__MSG_BUSY_RESPONSE = 36
     PROTOBUF_C__FORCE_ENUM_TO_BE_INT_SIZE(CHORD_MESSAGE__MSG)
 } ChordMessage__MsgCase;
 
@@ -214,6 +634,17 @@ struct  _ChordMessage
   uint32_t version;
   protobuf_c_boolean has_query_id;
   int32_t query_id;
+  /*
+   * Key of the virtual node addressed, the first one if unset
+   */
+  protobuf_c_boolean has_target;
+  uint64_t target;
+  TraceContext *trace;
+  /*
+   * What the sender accepts, see chord_wire.h
+   */
+  protobuf_c_boolean has_features;
+  uint32_t features;
   ChordMessage__MsgCase msg_case;
   union {
     NotifyRequest *notify_request;
@@ -228,11 +659,28 @@ struct  _ChordMessage
     GetSuccessorListResponse *get_successor_list_response;
     StartFindSuccessorRequest *start_find_successor_request;
     StartFindSuccessorResponse *start_find_successor_response;
+    FindSuccessorsRequest *find_successors_request;
+    FindSuccessorsResponse *find_successors_response;
+    PutRequest *put_request;
+    PutResponse *put_response;
+    GetRequest *get_request;
+    GetResponse *get_response;
+    DeleteRequest *delete_request;
+    DeleteResponse *delete_response;
+    HandoffRequest *handoff_request;
+    HandoffResponse *handoff_response;
+    LeaveRequest *leave_request;
+    LeaveResponse *leave_response;
+    StatsRequest *stats_request;
+    StatsResponse *stats_response;
+    StabilizeRequest *stabilize_request;
+    StabilizeResponse *stabilize_response;
+    BusyResponse *busy_response;
   };
 };
 #define CHORD_MESSAGE__INIT \
  { PROTOBUF_C_MESSAGE_INIT (&chord_message__descriptor) \
-    , 417u, 0, 0, CHORD_MESSAGE__MSG__NOT_SET, {0} }
+    , 417u, 0, 0, 0, 0, NULL, 0, 0, CHORD_MESSAGE__MSG__NOT_SET, {0} }
 
 
 /* Node methods */
@@ -330,6 +778,44 @@ FindSuccessorResponse *
 void   find_successor_response__free_unpacked
                      (FindSuccessorResponse *message,
                       ProtobufCAllocator *allocator);
+/* FindSuccessorsRequest methods */
+void   find_successors_request__init
+                     (FindSuccessorsRequest         *message);
+size_t find_successors_request__get_packed_size
+                     (const FindSuccessorsRequest   *message);
+size_t find_successors_request__pack
+                     (const FindSuccessorsRequest   *message,
+                      uint8_t             *out);
+size_t find_successors_request__pack_to_buffer
+                     (const FindSuccessorsRequest   *message,
+                      ProtobufCBuffer     *buffer);
+FindSuccessorsRequest *
+       find_successors_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   find_successors_request__free_unpacked
+                     (FindSuccessorsRequest *message,
+                      ProtobufCAllocator *allocator);
+/* FindSuccessorsResponse methods */
+void   find_successors_response__init
+                     (FindSuccessorsResponse         *message);
+size_t find_successors_response__get_packed_size
+                     (const FindSuccessorsResponse   *message);
+size_t find_successors_response__pack
+                     (const FindSuccessorsResponse   *message,
+                      uint8_t             *out);
+size_t find_successors_response__pack_to_buffer
+                     (const FindSuccessorsResponse   *message,
+                      ProtobufCBuffer     *buffer);
+FindSuccessorsResponse *
+       find_successors_response__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   find_successors_response__free_unpacked
+                     (FindSuccessorsResponse *message,
+                      ProtobufCAllocator *allocator);
 /* StartFindSuccessorRequest methods */
 void   start_find_successor_request__init
                      (StartFindSuccessorRequest         *message);
@@ -482,6 +968,367 @@ GetSuccessorListResponse *
 void   get_successor_list_response__free_unpacked
                      (GetSuccessorListResponse *message,
                       ProtobufCAllocator *allocator);
+/* StabilizeRequest methods */
+void   stabilize_request__init
+                     (StabilizeRequest         *message);
+size_t stabilize_request__get_packed_size
+                     (const StabilizeRequest   *message);
+size_t stabilize_request__pack
+                     (const StabilizeRequest   *message,
+                      uint8_t             *out);
+size_t stabilize_request__pack_to_buffer
+                     (const StabilizeRequest   *message,
+                      ProtobufCBuffer     *buffer);
+StabilizeRequest *
+       stabilize_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   stabilize_request__free_unpacked
+                     (StabilizeRequest *message,
+                      ProtobufCAllocator *allocator);
+/* StabilizeResponse methods */
+void   stabilize_response__init
+                     (StabilizeResponse         *message);
+size_t stabilize_response__get_packed_size
+                     (const StabilizeResponse   *message);
+size_t stabilize_response__pack
+                     (const StabilizeResponse   *message,
+                      uint8_t             *out);
+size_t stabilize_response__pack_to_buffer
+                     (const StabilizeResponse   *message,
+                      ProtobufCBuffer     *buffer);
+StabilizeResponse *
+       stabilize_response__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   stabilize_response__free_unpacked
+                     (StabilizeResponse *message,
+                      ProtobufCAllocator *allocator);
+/* PutRequest methods */
+void   put_request__init
+                     (PutRequest         *message);
+size_t put_request__get_packed_size
+                     (const PutRequest   *message);
+size_t put_request__pack
+                     (const PutRequest   *message,
+                      uint8_t             *out);
+size_t put_request__pack_to_buffer
+                     (const PutRequest   *message,
+                      ProtobufCBuffer     *buffer);
+PutRequest *
+       put_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   put_request__free_unpacked
+                     (PutRequest *message,
+                      ProtobufCAllocator *allocator);
+/* PutResponse methods */
+void   put_response__init
+                     (PutResponse         *message);
+size_t put_response__get_packed_size
+                     (const PutResponse   *message);
+size_t put_response__pack
+                     (const PutResponse   *message,
+                      uint8_t             *out);
+size_t put_response__pack_to_buffer
+                     (const PutResponse   *message,
+                      ProtobufCBuffer     *buffer);
+PutResponse *
+       put_response__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   put_response__free_unpacked
+                     (PutResponse *message,
+                      ProtobufCAllocator *allocator);
+/* GetRequest methods */
+void   get_request__init
+                     (GetRequest         *message);
+size_t get_request__get_packed_size
+                     (const GetRequest   *message);
+size_t get_request__pack
+                     (const GetRequest   *message,
+                      uint8_t             *out);
+size_t get_request__pack_to_buffer
+                     (const GetRequest   *message,
+                      ProtobufCBuffer     *buffer);
+GetRequest *
+       get_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   get_request__free_unpacked
+                     (GetRequest *message,
+                      ProtobufCAllocator *allocator);
+/* GetResponse methods */
+void   get_response__init
+                     (GetResponse         *message);
+size_t get_response__get_packed_size
+                     (const GetResponse   *message);
+size_t get_response__pack
+                     (const GetResponse   *message,
+                      uint8_t             *out);
+size_t get_response__pack_to_buffer
+                     (const GetResponse   *message,
+                      ProtobufCBuffer     *buffer);
+GetResponse *
+       get_response__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   get_response__free_unpacked
+                     (GetResponse *message,
+                      ProtobufCAllocator *allocator);
+/* DeleteRequest methods */
+void   delete_request__init
+                     (DeleteRequest         *message);
+size_t delete_request__get_packed_size
+                     (const DeleteRequest   *message);
+size_t delete_request__pack
+                     (const DeleteRequest   *message,
+                      uint8_t             *out);
+size_t delete_request__pack_to_buffer
+                     (const DeleteRequest   *message,
+                      ProtobufCBuffer     *buffer);
+DeleteRequest *
+       delete_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   delete_request__free_unpacked
+                     (DeleteRequest *message,
+                      ProtobufCAllocator *allocator);
+/* DeleteResponse methods */
+void   delete_response__init
+                     (DeleteResponse         *message);
+size_t delete_response__get_packed_size
+                     (const DeleteResponse   *message);
+size_t delete_response__pack
+                     (const DeleteResponse   *message,
+                      uint8_t             *out);
+size_t delete_response__pack_to_buffer
+                     (const DeleteResponse   *message,
+                      ProtobufCBuffer     *buffer);
+DeleteResponse *
+       delete_response__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   delete_response__free_unpacked
+                     (DeleteResponse *message,
+                      ProtobufCAllocator *allocator);
+/* KeyValue methods */
+void   key_value__init
+                     (KeyValue         *message);
+size_t key_value__get_packed_size
+                     (const KeyValue   *message);
+size_t key_value__pack
+                     (const KeyValue   *message,
+                      uint8_t             *out);
+size_t key_value__pack_to_buffer
+                     (const KeyValue   *message,
+                      ProtobufCBuffer     *buffer);
+KeyValue *
+       key_value__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   key_value__free_unpacked
+                     (KeyValue *message,
+                      ProtobufCAllocator *allocator);
+/* HandoffRequest methods */
+void   handoff_request__init
+                     (HandoffRequest         *message);
+size_t handoff_request__get_packed_size
+                     (const HandoffRequest   *message);
+size_t handoff_request__pack
+                     (const HandoffRequest   *message,
+                      uint8_t             *out);
+size_t handoff_request__pack_to_buffer
+                     (const HandoffRequest   *message,
+                      ProtobufCBuffer     *buffer);
+HandoffRequest *
+       handoff_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   handoff_request__free_unpacked
+                     (HandoffRequest *message,
+                      ProtobufCAllocator *allocator);
+/* HandoffResponse methods */
+void   handoff_response__init
+                     (HandoffResponse         *message);
+size_t handoff_response__get_packed_size
+                     (const HandoffResponse   *message);
+size_t handoff_response__pack
+                     (const HandoffResponse   *message,
+                      uint8_t             *out);
+size_t handoff_response__pack_to_buffer
+                     (const HandoffResponse   *message,
+                      ProtobufCBuffer     *buffer);
+HandoffResponse *
+       handoff_response__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   handoff_response__free_unpacked
+                     (HandoffResponse *message,
+                      ProtobufCAllocator *allocator);
+/* LeaveRequest methods */
+void   leave_request__init
+                     (LeaveRequest         *message);
+size_t leave_request__get_packed_size
+                     (const LeaveRequest   *message);
+size_t leave_request__pack
+                     (const LeaveRequest   *message,
+                      uint8_t             *out);
+size_t leave_request__pack_to_buffer
+                     (const LeaveRequest   *message,
+                      ProtobufCBuffer     *buffer);
+LeaveRequest *
+       leave_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   leave_request__free_unpacked
+                     (LeaveRequest *message,
+                      ProtobufCAllocator *allocator);
+/* LeaveResponse methods */
+void   leave_response__init
+                     (LeaveResponse         *message);
+size_t leave_response__get_packed_size
+                     (const LeaveResponse   *message);
+size_t leave_response__pack
+                     (const LeaveResponse   *message,
+                      uint8_t             *out);
+size_t leave_response__pack_to_buffer
+                     (const LeaveResponse   *message,
+                      ProtobufCBuffer     *buffer);
+LeaveResponse *
+       leave_response__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   leave_response__free_unpacked
+                     (LeaveResponse *message,
+                      ProtobufCAllocator *allocator);
+/* Histogram methods */
+void   histogram__init
+                     (Histogram         *message);
+size_t histogram__get_packed_size
+                     (const Histogram   *message);
+size_t histogram__pack
+                     (const Histogram   *message,
+                      uint8_t             *out);
+size_t histogram__pack_to_buffer
+                     (const Histogram   *message,
+                      ProtobufCBuffer     *buffer);
+Histogram *
+       histogram__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   histogram__free_unpacked
+                     (Histogram *message,
+                      ProtobufCAllocator *allocator);
+/* Stats methods */
+void   stats__init
+                     (Stats         *message);
+size_t stats__get_packed_size
+                     (const Stats   *message);
+size_t stats__pack
+                     (const Stats   *message,
+                      uint8_t             *out);
+size_t stats__pack_to_buffer
+                     (const Stats   *message,
+                      ProtobufCBuffer     *buffer);
+Stats *
+       stats__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   stats__free_unpacked
+                     (Stats *message,
+                      ProtobufCAllocator *allocator);
+/* StatsRequest methods */
+void   stats_request__init
+                     (StatsRequest         *message);
+size_t stats_request__get_packed_size
+                     (const StatsRequest   *message);
+size_t stats_request__pack
+                     (const StatsRequest   *message,
+                      uint8_t             *out);
+size_t stats_request__pack_to_buffer
+                     (const StatsRequest   *message,
+                      ProtobufCBuffer     *buffer);
+StatsRequest *
+       stats_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   stats_request__free_unpacked
+                     (StatsRequest *message,
+                      ProtobufCAllocator *allocator);
+/* StatsResponse methods */
+void   stats_response__init
+                     (StatsResponse         *message);
+size_t stats_response__get_packed_size
+                     (const StatsResponse   *message);
+size_t stats_response__pack
+                     (const StatsResponse   *message,
+                      uint8_t             *out);
+size_t stats_response__pack_to_buffer
+                     (const StatsResponse   *message,
+                      ProtobufCBuffer     *buffer);
+StatsResponse *
+       stats_response__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   stats_response__free_unpacked
+                     (StatsResponse *message,
+                      ProtobufCAllocator *allocator);
+/* BusyResponse methods */
+void   busy_response__init
+                     (BusyResponse         *message);
+size_t busy_response__get_packed_size
+                     (const BusyResponse   *message);
+size_t busy_response__pack
+                     (const BusyResponse   *message,
+                      uint8_t             *out);
+size_t busy_response__pack_to_buffer
+                     (const BusyResponse   *message,
+                      ProtobufCBuffer     *buffer);
+BusyResponse *
+       busy_response__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   busy_response__free_unpacked
+                     (BusyResponse *message,
+                      ProtobufCAllocator *allocator);
+/* TraceContext methods */
+void   trace_context__init
+                     (TraceContext         *message);
+size_t trace_context__get_packed_size
+                     (const TraceContext   *message);
+size_t trace_context__pack
+                     (const TraceContext   *message,
+                      uint8_t             *out);
+size_t trace_context__pack_to_buffer
+                     (const TraceContext   *message,
+                      ProtobufCBuffer     *buffer);
+TraceContext *
+       trace_context__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   trace_context__free_unpacked
+                     (TraceContext *message,
+                      ProtobufCAllocator *allocator);
 /* ChordMessage methods */
 void   chord_message__init
                      (ChordMessage         *message);
@@ -518,6 +1365,12 @@ typedef void (*FindSuccessorRequest_Closure)
 typedef void (*FindSuccessorResponse_Closure)
                  (const FindSuccessorResponse *message,
                   void *closure_data);
+typedef void (*FindSuccessorsRequest_Closure)
+                 (const FindSuccessorsRequest *message,
+                  void *closure_data);
+typedef void (*FindSuccessorsResponse_Closure)
+                 (const FindSuccessorsResponse *message,
+                  void *closure_data);
 typedef void (*StartFindSuccessorRequest_Closure)
                  (const StartFindSuccessorRequest *message,
                   void *closure_data);
@@ -542,6 +1395,63 @@ typedef void (*GetSuccessorListRequest_Closure)
 typedef void (*GetSuccessorListResponse_Closure)
                  (const GetSuccessorListResponse *message,
                   void *closure_data);
+typedef void (*StabilizeRequest_Closure)
+                 (const StabilizeRequest *message,
+                  void *closure_data);
+typedef void (*StabilizeResponse_Closure)
+                 (const StabilizeResponse *message,
+                  void *closure_data);
+typedef void (*PutRequest_Closure)
+                 (const PutRequest *message,
+                  void *closure_data);
+typedef void (*PutResponse_Closure)
+                 (const PutResponse *message,
+                  void *closure_data);
+typedef void (*GetRequest_Closure)
+                 (const GetRequest *message,
+                  void *closure_data);
+typedef void (*GetResponse_Closure)
+                 (const GetResponse *message,
+                  void *closure_data);
+typedef void (*DeleteRequest_Closure)
+                 (const DeleteRequest *message,
+                  void *closure_data);
+typedef void (*DeleteResponse_Closure)
+                 (const DeleteResponse *message,
+                  void *closure_data);
+typedef void (*KeyValue_Closure)
+                 (const KeyValue *message,
+                  void *closure_data);
+typedef void (*HandoffRequest_Closure)
+                 (const HandoffRequest *message,
+                  void *closure_data);
+typedef void (*HandoffResponse_Closure)
+                 (const HandoffResponse *message,
+                  void *closure_data);
+typedef void (*LeaveRequest_Closure)
+                 (const LeaveRequest *message,
+                  void *closure_data);
+typedef void (*LeaveResponse_Closure)
+                 (const LeaveResponse *message,
+                  void *closure_data);
+typedef void (*Histogram_Closure)
+                 (const Histogram *message,
+                  void *closure_data);
+typedef void (*Stats_Closure)
+                 (const Stats *message,
+                  void *closure_data);
+typedef void (*StatsRequest_Closure)
+                 (const StatsRequest *message,
+                  void *closure_data);
+typedef void (*StatsResponse_Closure)
+                 (const StatsResponse *message,
+                  void *closure_data);
+typedef void (*BusyResponse_Closure)
+                 (const BusyResponse *message,
+                  void *closure_data);
+typedef void (*TraceContext_Closure)
+                 (const TraceContext *message,
+                  void *closure_data);
 typedef void (*ChordMessage_Closure)
                  (const ChordMessage *message,
                   void *closure_data);
@@ -556,6 +1466,8 @@ extern const ProtobufCMessageDescriptor notify_request__descriptor;
 extern const ProtobufCMessageDescriptor notify_response__descriptor;
 extern const ProtobufCMessageDescriptor find_successor_request__descriptor;
 extern const ProtobufCMessageDescriptor find_successor_response__descriptor;
+extern const ProtobufCMessageDescriptor find_successors_request__descriptor;
+extern const ProtobufCMessageDescriptor find_successors_response__descriptor;
 extern const ProtobufCMessageDescriptor start_find_successor_request__descriptor;
 extern const ProtobufCMessageDescriptor start_find_successor_response__descriptor;
 extern const ProtobufCMessageDescriptor get_predecessor_request__descriptor;
@@ -564,6 +1476,25 @@ extern const ProtobufCMessageDescriptor check_predecessor_request__descriptor;
 extern const ProtobufCMessageDescriptor check_predecessor_response__descriptor;
 extern const ProtobufCMessageDescriptor get_successor_list_request__descriptor;
 extern const ProtobufCMessageDescriptor get_successor_list_response__descriptor;
+extern const ProtobufCMessageDescriptor stabilize_request__descriptor;
+extern const ProtobufCMessageDescriptor stabilize_response__descriptor;
+extern const ProtobufCMessageDescriptor put_request__descriptor;
+extern const ProtobufCMessageDescriptor put_response__descriptor;
+extern const ProtobufCMessageDescriptor get_request__descriptor;
+extern const ProtobufCMessageDescriptor get_response__descriptor;
+extern const ProtobufCMessageDescriptor delete_request__descriptor;
+extern const ProtobufCMessageDescriptor delete_response__descriptor;
+extern const ProtobufCMessageDescriptor key_value__descriptor;
+extern const ProtobufCMessageDescriptor handoff_request__descriptor;
+extern const ProtobufCMessageDescriptor handoff_response__descriptor;
+extern const ProtobufCMessageDescriptor leave_request__descriptor;
+extern const ProtobufCMessageDescriptor leave_response__descriptor;
+extern const ProtobufCMessageDescriptor histogram__descriptor;
+extern const ProtobufCMessageDescriptor stats__descriptor;
+extern const ProtobufCMessageDescriptor stats_request__descriptor;
+extern const ProtobufCMessageDescriptor stats_response__descriptor;
+extern const ProtobufCMessageDescriptor busy_response__descriptor;
+extern const ProtobufCMessageDescriptor trace_context__descriptor;
 extern const ProtobufCMessageDescriptor chord_message__descriptor;
 
 PROTOBUF_C__END_DECLS
@@ -0,0 +1,257 @@
+// Lookup benchmark: starts a ring of chord processes on loopback, lets it
+// settle, then has the first node run the Bench command against it while
+// the others churn.
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <time.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+
+// Most nodes the ring may have
+#define BENCH_MAX_NODES 256
+
+struct bench_options {
+	int n_nodes;
+	int num_successors;
+	double churn;           // Nodes replaced per minute
+	int settle;             // Seconds between the last join and the first lookup
+	int timeout;            // Seconds the benchmark may take
+	int base_port;
+	const char *binary;
+	size_t n_lookups;
+	int concurrency;
+	double zipf_s;
+	size_t n_keys;
+	char **node_args;       // Passed on to every node, after --
+	int n_node_args;
+};
+
+struct node_process {
+	pid_t pid;
+	int port;
+	int input;              // Write end of its stdin, nodes exit once it closes
+};
+
+static struct node_process nodes[BENCH_MAX_NODES];
+static struct bench_options options = {
+	.n_nodes = 8,
+	.num_successors = 3,
+	.churn = 0,
+	.settle = 5,
+	.timeout = 300,
+	.base_port = 6000,
+	.binary = "./chord",
+	.n_lookups = 10000,
+	.concurrency = 16,
+	.zipf_s = 0.99,
+	.n_keys = 10000,
+};
+
+static uint64_t now_ms(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void usage(const char *name) {
+	fprintf(stderr,
+	        "Usage: %s [-n nodes] [-r successors] [-c churn per minute] [-s settle seconds]\n"
+	        "          [-t timeout seconds] [-p base port] [-b chord binary] [-l lookups]\n"
+	        "          [-w concurrency] [-z zipf exponent] [-k keys] [-- node args...]\n", name);
+	exit(1);
+}
+
+static void parse_options(int argc, char *argv[]) {
+	int opt;
+	while ((opt = getopt(argc, argv, "n:r:c:s:t:p:b:l:w:z:k:h")) != -1) {
+		switch (opt) {
+		case 'n': options.n_nodes = atoi(optarg); break;
+		case 'r': options.num_successors = atoi(optarg); break;
+		case 'c': options.churn = atof(optarg); break;
+		case 's': options.settle = atoi(optarg); break;
+		case 't': options.timeout = atoi(optarg); break;
+		case 'p': options.base_port = atoi(optarg); break;
+		case 'b': options.binary = optarg; break;
+		case 'l': options.n_lookups = strtoul(optarg, NULL, 10); break;
+		case 'w': options.concurrency = atoi(optarg); break;
+		case 'z': options.zipf_s = atof(optarg); break;
+		case 'k': options.n_keys = strtoul(optarg, NULL, 10); break;
+		default: usage(argv[0]);
+		}
+	}
+
+	if (options.n_nodes < 1 || options.n_nodes > BENCH_MAX_NODES || options.churn < 0
+		|| options.base_port < 1 || options.base_port > 65535 - BENCH_MAX_NODES) {
+		usage(argv[0]);
+	}
+	options.node_args = argv + optind;
+	options.n_node_args = argc - optind;
+}
+
+/**
+ * @brief Starts one chord process, the first creates the ring and the rest join it.
+ *
+ * @param output Where its stdout goes, -1 for /dev/null
+ */
+static struct node_process spawn(int port, int output) {
+	int input[2];
+	if (pipe(input) != 0) {
+		perror("pipe");
+		exit(1);
+	}
+
+	char port_arg[16], join_arg[16], successors_arg[16];
+	snprintf(port_arg, sizeof(port_arg), "%d", port);
+	snprintf(join_arg, sizeof(join_arg), "%d", options.base_port);
+	snprintf(successors_arg, sizeof(successors_arg), "%d", options.num_successors);
+
+	char *args[32 + options.n_node_args];
+	int n = 0;
+	args[n++] = (char *)options.binary;
+	args[n++] = "-p";
+	args[n++] = port_arg;
+	args[n++] = "-r";
+	args[n++] = successors_arg;
+	args[n++] = "--sp";
+	args[n++] = "5";
+	args[n++] = "--ffp";
+	args[n++] = "5";
+	args[n++] = "--cpp";
+	args[n++] = "5";
+	if (port != options.base_port) {
+		args[n++] = "--ja";
+		args[n++] = "127.0.0.1";
+		args[n++] = "--jp";
+		args[n++] = join_arg;
+	}
+	for (int i = 0; i < options.n_node_args; ++i) {
+		args[n++] = options.node_args[i];
+	}
+	args[n] = NULL;
+
+	pid_t pid = fork();
+	if (pid < 0) {
+		perror("fork");
+		exit(1);
+	}
+	if (pid == 0) {
+		dup2(input[0], STDIN_FILENO);
+		if (output < 0) {
+			output = open("/dev/null", O_WRONLY);
+		}
+		dup2(output, STDOUT_FILENO);
+		close(input[0]);
+		close(input[1]);
+		execv(options.binary, args);
+		perror("execv");
+		_exit(1);
+	}
+
+	close(input[0]);
+	fcntl(input[1], F_SETFD, FD_CLOEXEC);
+	return (struct node_process) {pid, port, input[1]};
+}
+
+static void stop(struct node_process *node, int signal) {
+	kill(node->pid, signal);
+	waitpid(node->pid, NULL, 0);
+	close(node->input);
+}
+
+int main(int argc, char *argv[]) {
+	parse_options(argc, argv);
+	signal(SIGPIPE, SIG_IGN);
+
+	int output[2];
+	if (pipe(output) != 0) {
+		perror("pipe");
+		exit(1);
+	}
+	fcntl(output[0], F_SETFD, FD_CLOEXEC);
+
+	// The first node runs the benchmark and is never churned, its output is the report
+	nodes[0] = spawn(options.base_port, output[1]);
+	close(output[1]);
+	usleep(500000);
+	for (int i = 1; i < options.n_nodes; ++i) {
+		nodes[i] = spawn(options.base_port + i, -1);
+		usleep(200000);
+	}
+	int next_port = options.base_port + options.n_nodes;
+	sleep(options.settle);
+
+	char command[128];
+	int len = snprintf(command, sizeof(command), "Bench %zu %d %f %zu\n",
+	                   options.n_lookups, options.concurrency, options.zipf_s, options.n_keys);
+	if (write(nodes[0].input, command, len) != len) {
+		perror("Failed to start the benchmark");
+		exit(1);
+	}
+
+	uint64_t deadline = now_ms() + (uint64_t)options.timeout * 1000;
+	uint64_t churn_ms = options.churn > 0 ? (uint64_t)(60000 / options.churn) : 0;
+	uint64_t next_churn = now_ms() + churn_ms;
+	int n_churned = 0;
+	srand(options.base_port);
+
+	// Copies the report through, only the lines the benchmark printed
+	char line[1024];
+	size_t line_len = 0;
+	int done = 0;
+	while (!done && now_ms() < deadline) {
+		if (churn_ms && options.n_nodes > 1 && next_churn <= now_ms()) {
+			// One node leaves without warning and a new one with another key takes its slot
+			int victim = 1 + rand() % (options.n_nodes - 1);
+			stop(&nodes[victim], SIGKILL);
+			nodes[victim] = spawn(next_port++, -1);
+			n_churned++;
+			next_churn += churn_ms;
+		}
+
+		struct pollfd pfd = {.fd = output[0], .events = POLLIN};
+		if (poll(&pfd, 1, 100) <= 0) {
+			continue;
+		}
+
+		char c;
+		ssize_t n = read(output[0], &c, 1);
+		if (n <= 0) {
+			fprintf(stderr, "The benchmarking node exited\n");
+			break;
+		}
+		if (c != '\n' && line_len < sizeof(line) - 1) {
+			line[line_len++] = c;
+			continue;
+		}
+		line[line_len] = '\0';
+		line_len = 0;
+
+		char *start = strstr(line, "< ");
+		if (!start) {
+			continue;
+		}
+		if (strncmp(start, "< Bench", 7) == 0 || strncmp(start, "< Latency", 9) == 0
+			|| strncmp(start, "< Requests", 10) == 0 || strncmp(start, "< Hops", 6) == 0) {
+			printf("%s\n", start + 2);
+			fflush(stdout);
+		}
+		done = strncmp(start, "< Hops", 6) == 0 || strncmp(start, "< Bench not", 11) == 0;
+	}
+
+	if (!done) {
+		fprintf(stderr, "Benchmark did not finish\n");
+	}
+	printf("Ring of %d nodes, %d successors, %d churned\n", options.n_nodes, options.num_successors, n_churned);
+
+	for (int i = 0; i < options.n_nodes; ++i) {
+		stop(&nodes[i], SIGINT);
+	}
+	return done ? 0 : 1;
+}
@@ -9,21 +9,40 @@
 #include <fcntl.h>
 #include <sys/ioctl.h>
 #include <poll.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/epoll.h>
 
+#include "chord_arena.h"
 #include "chord_arg_parser.h"
 #include "chord.h"
+#include "chord_bench.h"
+#include "chord_cache.h"
+#include "chord_checkpoint.h"
+#include "chord_handoff.h"
 #include "chord_impl.h"
+#include "chord_kv.h"
+#include "chord_peer.h"
+#include "chord_rpc.h"
+#include "chord_routing.h"
+#include "chord_stats.h"
+#include "chord_stream.h"
+#include "chord_timer.h"
+#include "chord_trace.h"
+#include "chord_vnode.h"
+#include "chord_worker.h"
 #include "hash.h"
 
 #include "chord.pb-c.h"
 
 struct chord_arguments chord_args;
-struct sha1sum_ctx *ctx;
 
 int sockfd = -1;
 int fixIndex = 0;
-int predExists = 1;
 int succListIndex = 1;
+int joined = 0;
+int check_predecessor_in_flight = 0;
+Node checked_predecessor;              // Predecessor the in-flight check is probing
 
 uint64_t hash;
 Node predecessor;
@@ -39,6 +58,25 @@ void create() {
 	successor = self;
 }
 
+static void join_reply(MessageResponse *response, void *arg) {
+	(void)arg;
+
+	if (response->type != CHORD_MESSAGE__MSG_START_FIND_SUCCESSOR_RESPONSE) {
+		join(); // Join node did not answer, ask again
+		return;
+	}
+
+	successor = response->node;
+	successor_list[0] = successor;
+	joined = 1;
+
+	// Everything the successor held that is not in (self, successor] is ours now
+	handoff_start(&successor, successor.key, hash);
+
+	// Build the whole finger table now rather than one entry per period
+	fix_all_fingers();
+}
+
 void join() {
 	predecessor = (Node) NODE__INIT;
 	predecessor.key = 0;
@@ -51,43 +89,10 @@ void join() {
 	msg.start_find_successor_request = &request;
 	msg.msg_case = CHORD_MESSAGE__MSG_START_FIND_SUCCESSOR_REQUEST;
 
-	uint64_t msg_len = chord_message__get_packed_size(&msg);
-
-	size_t total_size = sizeof(msg_len) + msg_len;
-	uint8_t *buffer = malloc(total_size);
-
-	uint64_t networkLen = htobe64(msg_len);
-	memcpy(buffer, &networkLen, sizeof(networkLen));
-	chord_message__pack(&msg, buffer + sizeof(networkLen));
-
-	if (sendto(sockfd, buffer, total_size, 0, (struct sockaddr *)&chord_args.join_address, sizeof(struct sockaddr_in)) < 0) {
-		perror("Error sending get predecessor request");
+	if (rpc_call_addr(&chord_args.join_address, &msg, CHORD_MESSAGE__MSG_START_FIND_SUCCESSOR_RESPONSE,
+	                  join_reply, NULL) != 0) {
 		exit(1);
 	}
-
-	MessageResponse response;
-	do {
-		fd_set readfds;
-		FD_ZERO(&readfds);
-		FD_SET(sockfd, &readfds);
-
-		struct timeval timeout;
-		timeout.tv_sec = 1;
-		timeout.tv_usec = 0;
-
-		int ret = select(sockfd + 1, &readfds, NULL, NULL, &timeout);
-
-		if (ret < 0) {
-				perror("Select error");
-				break;
-		} else if (ret > 0 && FD_ISSET(sockfd, &readfds)) {
-				response = process_chord_msg(1);
-		} 
-	} while (response.type != CHORD_MESSAGE__MSG_START_FIND_SUCCESSOR_RESPONSE);
-
-	successor = response.node;
-
-	free(buffer);
 }
 
 void notify() {
@@ -99,328 +104,322 @@ void notify() {
 	msg.notify_request = &request;
 	msg.msg_case = CHORD_MESSAGE__MSG_NOTIFY_REQUEST;
 
-	uint64_t msg_len = chord_message__get_packed_size(&msg);
-
-	size_t total_size = sizeof(msg_len) + msg_len;
-	uint8_t *buffer = malloc(total_size);
+	send_message_to_node(&successor, &msg, "Error sending notify request");
+}
 
-	uint64_t networkLen = htobe64(msg_len);
-	memcpy(buffer, &networkLen, sizeof(networkLen));
-	chord_message__pack(&msg, buffer + sizeof(networkLen));
+// TODO: check for failed nodes and re-fix successor list
+// stabilize(), fix_successor_list(), and fix_fingers() moved to chord_impl.c
 
-	struct sockaddr_in node_addr;
-	node_addr.sin_family = AF_INET;
-	node_addr.sin_port = successor.port;
-	node_addr.sin_addr = (struct in_addr) {.s_addr = successor.address};
+static void check_predecessor_reply(MessageResponse *response, void *arg) {
+	(void)arg;
 
-	if (sendto(sockfd, buffer, total_size, 0, (struct sockaddr *)&node_addr, sizeof(struct sockaddr_in)) < 0) {
-		perror("Error sending notify request");
-		exit(1);
+	// Only drop the predecessor we actually probed, notify() may have replaced it since.
+	// A peer heard from on schedule just lost this one reply.
+	if (response->type != CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_RESPONSE && predecessor.key == checked_predecessor.key
+		&& peer_status(checked_predecessor.address, checked_predecessor.port) != PEER_ALIVE) {
+		predecessor.key = 0;
+		predecessor.address = 0;
+		predecessor.port = 0;
 	}
 
-	free(buffer);
+	check_predecessor_in_flight = 0;
 }
 
-// TODO: check for failed nodes and re-fix successor list
-// stabilize(), fix_successor_list(), and fix_fingers() moved to chord_impl.c
-
 void check_predecessor() {
-	// if (!predExists) {
-	// //	printf("Tralalaeo tralalala: %" PRIu64 "\n", predecessor.key);
-	// 	predecessor.key = 0;
-	// 	predecessor.address = 0;
-	// 	predecessor.port = 0;
-	// }
-
-	// predExists = 0;
-
-	// if (predecessor.key != 0) {
-	// 	CheckPredecessorRequest request = CHECK_PREDECESSOR_REQUEST__INIT;
-	// 	ChordMessage msg = CHORD_MESSAGE__INIT;
-	// 	msg.version = 417;
-	// 	msg.check_predecessor_request = &request;
-	// 	msg.msg_case = CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_REQUEST;
-
-	// 	uint64_t msg_len = chord_message__get_packed_size(&msg);
-
-	// 	size_t total_size = sizeof(msg_len) + msg_len;
-	// 	uint8_t *buffer = malloc(total_size);
-
-	// 	uint64_t networkLen = htobe64(msg_len);
-	// 	memcpy(buffer, &networkLen, sizeof(networkLen));
-	// 	chord_message__pack(&msg, buffer + sizeof(networkLen));
-
-	// 	struct sockaddr_in node_addr;
-	// 	node_addr.sin_family = AF_INET;
-	// 	node_addr.sin_port = predecessor.port;
-	// 	node_addr.sin_addr = (struct in_addr) {.s_addr = predecessor.address};
-
-	// 	if (sendto(sockfd, buffer, total_size, 0, (struct sockaddr *)&node_addr, sizeof(struct sockaddr_in)) < 0) {
-	// 		perror("Error sending check predecessor request");
-	// 		exit(1);
-	// 	}
-
-	// 	free(buffer);
-	// }
-	// else {
-	// 	predExists = 1;
-	// }
-	 
-	if (predecessor.key != 0) {
+	// Silent for far longer than it ever was, no need to wait out a timeout
+	if (predecessor.key != 0 && peer_status(predecessor.address, predecessor.port) == PEER_FAILED) {
+		predecessor = (Node) NODE__INIT;
+		return;
+	}
+
+	if (predecessor.key != 0 && !check_predecessor_in_flight) {
 		CheckPredecessorRequest request = CHECK_PREDECESSOR_REQUEST__INIT;
 		ChordMessage msg = CHORD_MESSAGE__INIT;
 		msg.version = 417;
 		msg.check_predecessor_request = &request;
 		msg.msg_case = CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_REQUEST;
 
-		uint64_t msg_len = chord_message__get_packed_size(&msg);
-
-		size_t total_size = sizeof(msg_len) + msg_len;
-		uint8_t *buffer = malloc(total_size);
-
-		uint64_t networkLen = htobe64(msg_len);
-		memcpy(buffer, &networkLen, sizeof(networkLen));
-		chord_message__pack(&msg, buffer + sizeof(networkLen));
+		checked_predecessor = predecessor;
 
-		struct sockaddr_in node_addr;
-		node_addr.sin_family = AF_INET;
-		node_addr.sin_port = predecessor.port;
-		node_addr.sin_addr = (struct in_addr) {.s_addr = predecessor.address};
-
-		if (sendto(sockfd, buffer, total_size, 0, (struct sockaddr *)&node_addr, sizeof(struct sockaddr_in)) < 0) {
-			perror("Error sending check predecessor request");
-			exit(1);
+		if (rpc_call(&predecessor, &msg, CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_RESPONSE, check_predecessor_reply, NULL) == 0) {
+			check_predecessor_in_flight = 1;
 		}
+	} 
+}
 
-		time_t currTime = time(NULL);
-		time_t timeoutTime = time(NULL) + 1;
+// find_successor() and closest_preceding_node() moved to chord_impl.c
 
-		MessageResponse response;
-		do {
-			fd_set readfds;
-			FD_ZERO(&readfds);
-			FD_SET(sockfd, &readfds);
+struct start_find_successor_state {
+	struct sockaddr_in requester;
+	protobuf_c_boolean has_query_id;
+	int32_t query_id;
+};
 
-			struct timeval timeout;
-			timeout.tv_sec = 1;
-			timeout.tv_usec = 0;
+static void start_find_successor_done(Node *node, void *arg) {
+	struct start_find_successor_state *state = arg;
 
-			int ret = select(sockfd + 1, &readfds, NULL, NULL, &timeout);
+	if (!node) { // Lookup failed, the requester will time out and ask again
+		free(state);
+		return;
+	}
 
-			if (ret < 0) {
-					perror("Select error");
-					break;
-			} else if (ret > 0 && FD_ISSET(sockfd, &readfds)) {
-					response = process_chord_msg(6);
-			}
+	StartFindSuccessorResponse startResponse = START_FIND_SUCCESSOR_RESPONSE__INIT;
+	startResponse.node = node;
 
-			currTime = time(NULL);
-		} while (currTime < timeoutTime && response.type != CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_RESPONSE);
+	ChordMessage msg = CHORD_MESSAGE__INIT;
+	msg.version = 417;
+	msg.has_query_id = state->has_query_id;
+	msg.query_id = state->query_id;
+	msg.start_find_successor_response = &startResponse;
+	msg.msg_case = CHORD_MESSAGE__MSG_START_FIND_SUCCESSOR_RESPONSE;
 
-		if (response.type != CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_RESPONSE) {
-		  //printf("Tralalaeo tralalala: %" PRIu64 "\n", predecessor.key);
-			predecessor.key = 0;
-			predecessor.address = 0;
-			predecessor.port = 0;
-		}
-		
-		free(buffer);
-	} 
+	send_message(&state->requester, &msg, "Error sending start find successor response");
+	free(state);
 }
 
-// find_successor() and closest_preceding_node() moved to chord_impl.c
+// Recursive lookup we are relaying, answered once the next hop replies
+struct relay_find_successor_state {
+	Node requester;
+	protobuf_c_boolean has_query_id;
+	int32_t query_id;
+	uint64_t key;
+};
 
-MessageResponse process_chord_msg(int i) {
-	uint64_t messageLenSize;
-	struct sockaddr_in node_addr;
-  socklen_t addrLen = sizeof(node_addr);
+// Relays are recycled, as many are kept as can have a request pending
+static struct pool relay_pool = POOL_INIT(sizeof(struct relay_find_successor_state), RPC_MAX_PENDING);
 
-	MessageResponse response = {.type = CHORD_MESSAGE__MSG__NOT_SET};
-	
-	// int available = 0;
-	// ioctl(sockfd, FIONREAD, &available);
+static void relay_find_successor_reply(MessageResponse *response, void *arg) {
+	struct relay_find_successor_state *state = arg;
 
-	// if (available < sizeof(uint64_t)) {
-	// 	// Drain partial data from the socket to prevent select() loop
-	// 	char drain_buf[4096];
-	// 	recvfrom(sockfd, drain_buf, sizeof(drain_buf), 0, (struct sockaddr *)&node_addr, &addrLen);
-		
-	// 	return response;
-	// }
+	// On timeout the requester times out as well and retries the lookup, a
+	// busy next hop is passed on so it can route around us right away
+	if (response->type == CHORD_MESSAGE__MSG_BUSY_RESPONSE) {
+		BusyResponse busyResponse = BUSY_RESPONSE__INIT;
 
-	if (recvfrom(sockfd, &messageLenSize, sizeof(uint64_t), MSG_PEEK, (struct sockaddr *)&node_addr, &addrLen) < 0) {
-		perror("Peek error");
-		return response;
+		ChordMessage msg = CHORD_MESSAGE__INIT;
+		msg.version = 417;
+		msg.has_query_id = state->has_query_id;
+		msg.query_id = state->query_id;
+		msg.busy_response = &busyResponse;
+		msg.msg_case = CHORD_MESSAGE__MSG_BUSY_RESPONSE;
+
+		send_message_to_node(&state->requester, &msg, "Error relaying busy response");
 	}
+	else if (response->type == CHORD_MESSAGE__MSG_FIND_SUCCESSOR_RESPONSE) {
+		location_cache_insert(state->key - 1, &response->node);
 
-	messageLenSize = be64toh(messageLenSize);
+		FindSuccessorResponse successorResponse = FIND_SUCCESSOR_RESPONSE__INIT;
+		successorResponse.node = &response->node;
+		successorResponse.has_key = 1;
+		successorResponse.key = state->key;
 
-	size_t total_size = sizeof(uint64_t) + messageLenSize;
-	uint8_t *buffer = malloc(total_size);
+		ChordMessage msg = CHORD_MESSAGE__INIT;
+		msg.version = 417;
+		msg.has_query_id = state->has_query_id;
+		msg.query_id = state->query_id;
+		msg.find_successor_response = &successorResponse;
+		msg.msg_case = CHORD_MESSAGE__MSG_FIND_SUCCESSOR_RESPONSE;
 
-	if (recvfrom(sockfd, buffer, total_size, MSG_DONTWAIT, (struct sockaddr *)&node_addr, &addrLen) < 0) {
-		return response;
+		send_message_to_node(&state->requester, &msg, "Error relaying find successor response");
 	}
 
-	ChordMessage *message = chord_message__unpack(NULL, messageLenSize, buffer + sizeof(uint64_t));
-	
-	// Find successor
-	if (message->msg_case == CHORD_MESSAGE__MSG_FIND_SUCCESSOR_RESPONSE) {
-		FindSuccessorResponse *successorResponse = message->find_successor_response;
+	pool_put(&relay_pool, state);
+}
 
-		response = (MessageResponse) {.type = CHORD_MESSAGE__MSG_FIND_SUCCESSOR_RESPONSE, .node = *successorResponse->node};
+/**
+ * @brief Passes a recursive/transitive FindSuccessorRequest one hop closer to its key.
+ *
+ * In recursive mode we become the requester of the next hop and relay its
+ * answer back; otherwise the request travels on untouched and the node that
+ * finally owns the key replies to the original requester directly.
+ */
+static void forward_find_successor(ChordMessage *message) {
+	FindSuccessorRequest *request = message->find_successor_request;
+
+	Node next = closest_preceding_node(request->key);
+	if (next.key == hash) {
+		next = successor; // No finger precedes the key, keep moving around the ring
 	}
-	else if (message->msg_case == CHORD_MESSAGE__MSG_FIND_SUCCESSOR_REQUEST) {
-		FindSuccessorRequest *successorRequest = message->find_successor_request;
 
-		Node predNode = element_of(successorRequest->key, hash, successor.key, 1) ? // id ∈ (n, successor]
-										successor : closest_preceding_node(successorRequest->key);
+	// A traced lookup keeps its trace id, one hop further along
+	TraceContext *trace = message->trace;
+	if (trace) {
+		trace_log(trace->trace_id, TRACE_FORWARDED, trace->hop + 1, request->key, &next);
+	}
 
-		FindSuccessorResponse successorResponse = FIND_SUCCESSOR_RESPONSE__INIT;
-		successorResponse.node = &predNode;
+	if (chord_args.lookup_mode != LOOKUP_RECURSIVE) {
+		if (trace) {
+			trace_attach(message, trace, trace->trace_id, trace->hop + 1); // Restamped in place
+		}
+		send_message_to_node(&next, message, "Error forwarding find successor request");
+		return;
+	}
 
-		ChordMessage msg = CHORD_MESSAGE__INIT;
-		msg.version = 417;
-		msg.find_successor_response = &successorResponse;
-		msg.msg_case = CHORD_MESSAGE__MSG_FIND_SUCCESSOR_RESPONSE;
-		
-		uint64_t msg_len = chord_message__get_packed_size(&msg);
+	struct relay_find_successor_state *state = pool_get(&relay_pool);
+	if (!state) {
+		return; // The requester times out and routes around us
+	}
+	state->requester = *request->requester;
+	state->has_query_id = message->has_query_id;
+	state->query_id = message->query_id;
+	state->key = request->key;
 
-		size_t total_size = sizeof(msg_len) + msg_len;
-		uint8_t *buffer = malloc(total_size);
+	FindSuccessorRequest req = FIND_SUCCESSOR_REQUEST__INIT;
+	req.key = request->key;
+	req.requester = &self;
 
-		uint64_t networkLen = htobe64(msg_len);
-		memcpy(buffer, &networkLen, sizeof(networkLen));
-		chord_message__pack(&msg, buffer + sizeof(networkLen));
+	ChordMessage msg = CHORD_MESSAGE__INIT;
+	msg.version = 417;
+	msg.find_successor_request = &req;
+	msg.msg_case = CHORD_MESSAGE__MSG_FIND_SUCCESSOR_REQUEST;
 
-		if (sendto(sockfd, buffer, total_size, 0, (struct sockaddr *)&node_addr, sizeof(node_addr)) < 0) {
-			perror("Error sending find successor response");
-			exit(1);
-		}
+	TraceContext next_trace;
+	if (trace) {
+		trace_attach(&msg, &next_trace, trace->trace_id, trace->hop + 1);
+	}
 
-		free(buffer);
-		response = (MessageResponse) {.type = CHORD_MESSAGE__MSG_FIND_SUCCESSOR_REQUEST};
+	if (rpc_call(&next, &msg, CHORD_MESSAGE__MSG_FIND_SUCCESSOR_RESPONSE, relay_find_successor_reply, state) != 0) {
+		pool_put(&relay_pool, state);
 	}
+}
 
-	// Start find successor
-	else if (message->msg_case == CHORD_MESSAGE__MSG_START_FIND_SUCCESSOR_RESPONSE) {
-		StartFindSuccessorResponse *startResponse = message->start_find_successor_response;
+// A node that believes it is our predecessor told us so
+static void notified(const Node *sender) {
+	if (predecessor.key == 0 || element_of(sender->key, predecessor.key, hash, 0)) {
+		predecessor = *sender;
+	}
+}
 
-		response = (MessageResponse) {.type = CHORD_MESSAGE__MSG_START_FIND_SUCCESSOR_RESPONSE, .node = *startResponse->node};
+/**
+ * @brief Answers a stabilize exchange with what get predecessor and get
+ *        successor list would have, the notify already applied.
+ *
+ * The successor list is left out if it matches the digest of the one the
+ * requester holds, which on a settled ring is every round.
+ */
+static void answer_stabilize(ChordMessage *message, struct sockaddr_in *from) {
+	size_t num_entries = chord_args.num_successors - 1;
+	Node *successors[ROUTING_MAX_SUCCESSORS];
+	for (size_t i = 0; i < num_entries; ++i) {
+		successors[i] = &successor_list[i];
 	}
-	else if (message->msg_case == CHORD_MESSAGE__MSG_START_FIND_SUCCESSOR_REQUEST) {
-		StartFindSuccessorRequest *startRequest = message->start_find_successor_request;
 
-		Node predNode = find_successor(startRequest->key);
+	StabilizeResponse stabilizeResponse = STABILIZE_RESPONSE__INIT;
+	stabilizeResponse.predecessor = &predecessor;
+	if (successor_list_digest(successor_list, num_entries) == message->stabilize_request->successors_digest) {
+		stabilizeResponse.has_unchanged = 1;
+		stabilizeResponse.unchanged = 1;
+	} else {
+		stabilizeResponse.n_successors = num_entries;
+		stabilizeResponse.successors = successors;
+	}
 
-		StartFindSuccessorResponse startResponse = START_FIND_SUCCESSOR_RESPONSE__INIT;
-		startResponse.node = &predNode;
+	ChordMessage msg = CHORD_MESSAGE__INIT;
+	msg.version = 417;
+	msg.has_query_id = message->has_query_id;
+	msg.query_id = message->query_id;
+	msg.stabilize_response = &stabilizeResponse;
+	msg.msg_case = CHORD_MESSAGE__MSG_STABILIZE_RESPONSE;
 
-		ChordMessage msg = CHORD_MESSAGE__INIT;
-		msg.version = 417;
-		msg.start_find_successor_response = &startResponse;
-		msg.msg_case = CHORD_MESSAGE__MSG_START_FIND_SUCCESSOR_RESPONSE;
-		
-		uint64_t msg_len = chord_message__get_packed_size(&msg);
+	send_message(from, &msg, "Error sending stabilize response");
+}
 
-		size_t total_size = sizeof(msg_len) + msg_len;
-		uint8_t *buffer = malloc(total_size);
+static void handle_chord_msg(ChordMessage *message, struct sockaddr_in node_addr) {
+	MessageResponse response = {.type = CHORD_MESSAGE__MSG__NOT_SET};
 
-		uint64_t networkLen = htobe64(msg_len);
-		memcpy(buffer, &networkLen, sizeof(networkLen));
-		chord_message__pack(&msg, buffer + sizeof(networkLen));
+	// Any message is a sign of life, serving traffic spares the peer a probe
+	peer_heard(node_addr.sin_addr.s_addr, node_addr.sin_port);
 
-		if (sendto(sockfd, buffer, total_size, 0, (struct sockaddr *)&node_addr, sizeof(node_addr)) < 0) {
-			perror("Error sending start find successor response");
-			exit(1);
-		}
+	// Everything below acts on the virtual node the message is addressed to
+	vnode_activate(vnode_for_message(message));
+	trace_received(message, &node_addr, self.key);
 
-		free(buffer);
-		response = (MessageResponse) {.type = CHORD_MESSAGE__MSG_START_FIND_SUCCESSOR_REQUEST};
+	// Requests that only read routing state, workers answer these the same way
+	if (answer_query(message, &node_addr, routing_current())) {
+		return;
 	}
 
-	// Get predecessor
-	else if (message->msg_case == CHORD_MESSAGE__MSG_GET_PREDECESSOR_RESPONSE) {
-		GetPredecessorResponse *predecessorResponse = message->get_predecessor_response;
+	// Key-value requests for keys this node holds, key handoff and stats
+	if (kv_handle_request(message, &node_addr) || handoff_handle_request(message, &node_addr)
+		|| stats_handle_request(message, &node_addr)) {
+		return;
+	}
 
-		response = (MessageResponse) {.type = CHORD_MESSAGE__MSG_GET_PREDECESSOR_RESPONSE, .node = *predecessorResponse->node};
+	// Find successor
+	if (message->msg_case == CHORD_MESSAGE__MSG_FIND_SUCCESSOR_RESPONSE) {
+		FindSuccessorResponse *successorResponse = message->find_successor_response;
+
+		response = (MessageResponse) {.type = CHORD_MESSAGE__MSG_FIND_SUCCESSOR_RESPONSE, .node = *successorResponse->node};
+	}
+	else if (message->msg_case == CHORD_MESSAGE__MSG_FIND_SUCCESSOR_REQUEST) {
+		// Routed lookup for a key our successor does not hold, answer_query() left it to us
+		forward_find_successor(message);
 	}
-	else if (message->msg_case == CHORD_MESSAGE__MSG_GET_PREDECESSOR_REQUEST) {
-		GetPredecessorResponse predecessorResponse = GET_PREDECESSOR_RESPONSE__INIT;
-		predecessorResponse.node = &predecessor;
 
-		ChordMessage msg = CHORD_MESSAGE__INIT;
-		msg.version = 417;
-		msg.get_predecessor_response = &predecessorResponse;
-		msg.msg_case = CHORD_MESSAGE__MSG_GET_PREDECESSOR_RESPONSE;
+	// Find successors
+	else if (message->msg_case == CHORD_MESSAGE__MSG_FIND_SUCCESSORS_RESPONSE) {
+		response = (MessageResponse) {.type = CHORD_MESSAGE__MSG_FIND_SUCCESSORS_RESPONSE};
+	}
 
-		uint64_t msg_len = chord_message__get_packed_size(&msg);
+	// Start find successor
+	else if (message->msg_case == CHORD_MESSAGE__MSG_START_FIND_SUCCESSOR_RESPONSE) {
+		StartFindSuccessorResponse *startResponse = message->start_find_successor_response;
 
-		size_t total_size = sizeof(msg_len) + msg_len;
-		uint8_t *buffer = malloc(total_size);
+		response = (MessageResponse) {.type = CHORD_MESSAGE__MSG_START_FIND_SUCCESSOR_RESPONSE, .node = *startResponse->node};
+	}
+	else if (message->msg_case == CHORD_MESSAGE__MSG_START_FIND_SUCCESSOR_REQUEST) {
+		StartFindSuccessorRequest *startRequest = message->start_find_successor_request;
 
-		uint64_t networkLen = htobe64(msg_len);
+		// Answered once the lookup completes, remember who asked
+		struct start_find_successor_state *state = malloc(sizeof(*state));
+		state->requester = node_addr;
+		state->has_query_id = message->has_query_id;
+		state->query_id = message->query_id;
 
-		memcpy(buffer, &networkLen, sizeof(networkLen));
-		chord_message__pack(&msg, buffer + sizeof(networkLen));
-		if (sendto(sockfd, buffer, total_size, 0, (struct sockaddr *)&node_addr, sizeof(node_addr)) < 0) {
-			perror("Error sending get predecessor response");
-			exit(1);
-		}
+		find_successor(startRequest->key, start_find_successor_done, state);
+	}
+
+	// Get predecessor
+	else if (message->msg_case == CHORD_MESSAGE__MSG_GET_PREDECESSOR_RESPONSE) {
+		GetPredecessorResponse *predecessorResponse = message->get_predecessor_response;
 
-		free(buffer);
-		response = (MessageResponse) {.type = CHORD_MESSAGE__MSG_GET_PREDECESSOR_REQUEST};
+		response = (MessageResponse) {.type = CHORD_MESSAGE__MSG_GET_PREDECESSOR_RESPONSE, .node = *predecessorResponse->node};
 	}
 
 	// Notify
 	else if (message->msg_case == CHORD_MESSAGE__MSG_NOTIFY_REQUEST) {
-		NotifyRequest *notifyRequest = message->notify_request;
-		Node senderNode = *notifyRequest->node; 
+		notified(message->notify_request->node);
+	}
 
-		if (predecessor.key == 0 || element_of(senderNode.key, predecessor.key, hash, 0)) {
-			predecessor = senderNode;
+	// Stabilize
+	else if (message->msg_case == CHORD_MESSAGE__MSG_STABILIZE_REQUEST) {
+		notified(message->stabilize_request->node);
+		answer_stabilize(message, &node_addr);
+	}
+	else if (message->msg_case == CHORD_MESSAGE__MSG_STABILIZE_RESPONSE) {
+		StabilizeResponse *stabilizeResponse = message->stabilize_response;
+
+		Node *successors = message_scratch(sizeof(Node) * stabilizeResponse->n_successors);
+		for (size_t i = 0; i < stabilizeResponse->n_successors; ++i) {
+			successors[i] = *(stabilizeResponse->successors[i]);
 		}
 
-		response = (MessageResponse) {.type = CHORD_MESSAGE__MSG_NOTIFY_REQUEST};
+		response = (MessageResponse) {.type = CHORD_MESSAGE__MSG_STABILIZE_RESPONSE,
+		                              .node = *stabilizeResponse->predecessor,
+		                              .n_successors = stabilizeResponse->n_successors,
+		                              .successors = successors};
 	}
 
 	// Check predecessor
 	else if (message->msg_case == CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_RESPONSE) {
-		predExists = 1;
-
 		response = (MessageResponse) {.type = CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_RESPONSE};
 	}
-	else if (message->msg_case == CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_REQUEST) {
-		CheckPredecessorResponse checkResponse = CHECK_PREDECESSOR_RESPONSE__INIT;
-
-		ChordMessage msg = CHORD_MESSAGE__INIT;
-		msg.version = 417;
-		msg.check_predecessor_response = &checkResponse;
-		msg.msg_case = CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_RESPONSE;
-		
-		uint64_t msg_len = chord_message__get_packed_size(&msg);
-
-		size_t total_size = sizeof(msg_len) + msg_len;
-		uint8_t *buffer = malloc(total_size);
-
-		uint64_t networkLen = htobe64(msg_len);
-		memcpy(buffer, &networkLen, sizeof(networkLen));
-		chord_message__pack(&msg, buffer + sizeof(networkLen));
-
-		if (sendto(sockfd, buffer, total_size, 0, (struct sockaddr *)&node_addr, sizeof(node_addr)) < 0) {
-			perror("Error sending check predecessor response");
-			exit(1);
-		}
-
-		free(buffer);
-		response = (MessageResponse) {.type = CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_REQUEST};
-	}
 
 	// Get successor list
 	else if (message->msg_case == CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_RESPONSE) {
 		GetSuccessorListResponse *listResponse = message->get_successor_list_response;
 
-		Node *successors = malloc(sizeof(Node) * listResponse->n_successors);
+		Node *successors = message_scratch(sizeof(Node) * listResponse->n_successors);
 		for (size_t i = 0; i < listResponse->n_successors; ++i) {
 			successors[i] = *(listResponse->successors[i]);
 		}
@@ -429,61 +428,115 @@ MessageResponse process_chord_msg(int i) {
 																	.n_successors = listResponse->n_successors,
 																	.successors = successors};
 	}
-	else if (message->msg_case == CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_REQUEST) {
-		GetSuccessorListResponse listResponse = GET_SUCCESSOR_LIST_RESPONSE__INIT;
 
-		// Copy successor list and remove last entry
-		size_t num_entries = chord_args.num_successors - 1;
-		Node **successors = malloc(sizeof(Node*) * num_entries);
-		
-		for (size_t i = 0; i < num_entries; ++i) {
-			successors[i] = &successor_list[i];
-		}
-	
-		listResponse.n_successors = num_entries;
-		listResponse.successors = successors;
+	// A peer too backlogged to serve the request, the caller goes elsewhere
+	else if (message->msg_case == CHORD_MESSAGE__MSG_BUSY_RESPONSE) {
+		response = (MessageResponse) {.type = CHORD_MESSAGE__MSG_BUSY_RESPONSE};
+	}
 
-		ChordMessage msg = CHORD_MESSAGE__INIT;
-		msg.version = 417;
-		msg.get_successor_list_response = &listResponse;
-		msg.msg_case = CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_RESPONSE;
-		
-		uint64_t msg_len = chord_message__get_packed_size(&msg);
+	// Key-value and handoff replies, the callback reads the decoded message
+	else if (message->msg_case == CHORD_MESSAGE__MSG_PUT_RESPONSE ||
+	         message->msg_case == CHORD_MESSAGE__MSG_GET_RESPONSE ||
+	         message->msg_case == CHORD_MESSAGE__MSG_DELETE_RESPONSE ||
+	         message->msg_case == CHORD_MESSAGE__MSG_HANDOFF_RESPONSE ||
+	         message->msg_case == CHORD_MESSAGE__MSG_LEAVE_RESPONSE ||
+	         message->msg_case == CHORD_MESSAGE__MSG_STATS_RESPONSE) {
+		response = (MessageResponse) {.type = message->msg_case};
+	}
+
+	// Replies complete whichever RPC is waiting on them
+	if (response.type != CHORD_MESSAGE__MSG__NOT_SET) {
+		response.message = message;
+		rpc_complete(message, &node_addr, &response);
+	}
+}
 
-		size_t total_size = sizeof(msg_len) + msg_len;
-		uint8_t *buffer = malloc(total_size);
+void process_chord_msg(void) {
+	size_t received = recv_batch();
 
-		uint64_t networkLen = htobe64(msg_len);
-		memcpy(buffer, &networkLen, sizeof(networkLen));
-		chord_message__pack(&msg, buffer + sizeof(networkLen));
+	// Maintenance and replies of the whole batch first, then client requests
+	for (int class = 0; class < RPC_CLASSES; ++class) {
+		for (size_t i = 0; i < received; ++i) {
+			struct sockaddr_in node_addr;
+			size_t offset = 0;
+			ChordMessage *message;
 
-		if (sendto(sockfd, buffer, total_size, 0, (struct sockaddr *)&node_addr, sizeof(node_addr)) < 0) {
-			perror("Error sending get sucessor list response");
-			exit(1);
+			while ((message = recv_message(i, &offset, &node_addr, class))) {
+				handle_chord_msg(message, node_addr);
+				release_message();
+			}
 		}
+	}
+}
 
-		free(buffer);
-		free(successors);
-		response = (MessageResponse) {.type = CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_REQUEST};
+static void lookup_done(Node *key_succ, void *arg) {
+	(void)arg;
+
+	if (!key_succ) {
+		printf("< Lookup failed\n");
+		fflush(stdout);
+		return;
 	}
 
-	free(buffer);
-	chord_message__free_unpacked(message, NULL);
-	return response;
+	char ip[INET_ADDRSTRLEN];
+
+	struct in_addr succ_addr = {.s_addr = key_succ->address};
+	inet_ntop(AF_INET, &succ_addr, ip, sizeof(ip));
+
+	printf("< %" PRIu64 " %s %" PRIu32 "\n", key_succ->key, ip, ntohs(key_succ->port));
+	fflush(stdout);
 }
 
 void lookup(uint64_t key) {
-	Node key_succ = find_successor(key);
+	find_successor_parallel(key, chord_args.lookup_alpha, lookup_done, NULL);
+}
 
-	char ip[INET_ADDRSTRLEN];
+static void lookup_batch_done(size_t n_keys, uint64_t *keys, Node **nodes, void *arg) {
+	(void)keys;
 
-	struct in_addr succ_addr = {.s_addr = key_succ.address};
-	inet_ntop(AF_INET, &succ_addr, ip, sizeof(ip));
+	for (size_t i = 0; i < n_keys; ++i) {
+		lookup_done(nodes[i], arg);
+	}
+}
 
-	printf("< %" PRIu64 " %s %" PRIu32 "\n", key_succ.key, ip, ntohs(key_succ.port));
+void lookup_batch(uint64_t *keys, size_t n_keys) {
+	find_successors(keys, n_keys, lookup_batch_done, NULL);
 }
 
-void print_state() {
+static void put_done(enum kv_status status, const uint8_t *value, size_t value_len, void *arg) {
+	(void)value;
+	(void)value_len;
+	(void)arg;
+
+	printf(status == KV_OK ? "< Stored\n" : "< Put failed\n");
+	fflush(stdout);
+}
+
+static void get_done(enum kv_status status, const uint8_t *value, size_t value_len, void *arg) {
+	(void)arg;
+
+	if (status == KV_OK) {
+		printf("< %.*s\n", (int)value_len, (const char *)value);
+	} else {
+		printf(status == KV_NOT_FOUND ? "< Not found\n" : "< Get failed\n");
+	}
+	fflush(stdout);
+}
+
+static void delete_done(enum kv_status status, const uint8_t *value, size_t value_len, void *arg) {
+	(void)value;
+	(void)value_len;
+	(void)arg;
+
+	if (status == KV_OK) {
+		printf("< Deleted\n");
+	} else {
+		printf(status == KV_NOT_FOUND ? "< Not found\n" : "< Delete failed\n");
+	}
+	fflush(stdout);
+}
+
+static void print_vnode_state(void) {
 	char ip[INET_ADDRSTRLEN];
 	int i;
 
@@ -523,6 +576,30 @@ void print_state() {
 	}
 }
 
+void print_state() {
+	int active = vnode_active();
+
+	for (int i = 0; i < vnode_count(); ++i) {
+		vnode_activate(i);
+		print_vnode_state();
+	}
+	vnode_activate(active);
+}
+
+// The scrape endpoint's text without its comments and zero samples
+static void print_stats(void) {
+	static char text[64 * 1024];
+	stats_format(text, sizeof(text));
+
+	char *save;
+	for (char *line = strtok_r(text, "\n", &save); line; line = strtok_r(NULL, "\n", &save)) {
+		size_t len = strlen(line);
+		if (line[0] != '#' && !(len >= 2 && strcmp(line + len - 2, " 0") == 0)) {
+			printf("< %s\n", line);
+		}
+	}
+}
+
 // curr_var ∈ (r1, r2);
 int element_of(uint64_t curr_var, uint64_t r1, uint64_t r2, int is_inclusive) {
 	int bound1 = curr_var > r1;
@@ -543,14 +620,7 @@ uint64_t get_hash(struct sockaddr_in *addr) {
 	memcpy(buffer, &addr->sin_addr.s_addr, 4);
 	memcpy(buffer + 4, &addr->sin_port, 2);
 
-	uint8_t checksum[20];
-	sha1sum_finish(ctx, buffer, sizeof(buffer), checksum);
-
-	uint64_t head = sha1sum_truncated_head(checksum);
-
-	sha1sum_reset(ctx);
-
-	return head;
+	return sha1sum_head(buffer, sizeof(buffer));
 }
 
 // Uses a dummy socket along with getsockname() to get our IP address
@@ -588,56 +658,241 @@ void process_input(char *input) {
 
   sscanf(input, "%s %[^\n]", cmd, arg); // Scans command string, and then until newline
 
-	if ((strcmp(cmd, "Lookup") == 0) && (strlen(arg) > 0)) {
-		uint8_t checksum[20];
-		sha1sum_finish(ctx, (const uint8_t*)arg, strlen(arg), checksum);
-
-		uint64_t head = sha1sum_truncated_head(checksum);
+	// Commands are issued from the first virtual node's point of view
+	vnode_activate(0);
 
-		sha1sum_reset(ctx);
+	if ((strcmp(cmd, "Lookup") == 0) && (strlen(arg) > 0)) {
+		uint64_t head = sha1sum_head((const uint8_t*)arg, strlen(arg));
 
 		printf("< %s %" PRIu64 "\n", arg, head);
 
 		lookup(head);
+	} else if ((strcmp(cmd, "LookupBatch") == 0) && (strlen(arg) > 0)) {
+		// Answers follow in the same order as the names
+		const uint8_t *names[64];
+		size_t lens[64];
+		uint64_t keys[64];
+		size_t n_keys = 0;
+		char *save;
+
+		for (char *name = strtok_r(arg, " ", &save); name && n_keys < 64; name = strtok_r(NULL, " ", &save)) {
+			names[n_keys] = (const uint8_t*)name;
+			lens[n_keys] = strlen(name);
+			n_keys++;
+		}
+
+		sha1sum_heads(names, lens, n_keys, keys);
+		for (size_t i = 0; i < n_keys; ++i) {
+			printf("< %s %" PRIu64 "\n", (const char*)names[i], keys[i]);
+		}
+
+		lookup_batch(keys, n_keys);
+	} else if ((strcmp(cmd, "Put") == 0 || strcmp(cmd, "Get") == 0 || strcmp(cmd, "GetStale") == 0
+	            || strcmp(cmd, "Delete") == 0) && (strlen(arg) > 0)) {
+		// Put takes the rest of the line after the key as its value
+		char *value = strchr(arg, ' ');
+		if (value) {
+			*value++ = '\0';
+		}
+
+		uint64_t id = sha1sum_head((const uint8_t*)arg, strlen(arg));
+
+		if (cmd[0] == 'P') {
+			if (value) {
+				kv_put(id, (const uint8_t *)arg, strlen(arg), (const uint8_t *)value, strlen(value), put_done, NULL);
+			}
+		} else if (cmd[0] == 'G') {
+			kv_get(id, (const uint8_t *)arg, strlen(arg), strcmp(cmd, "GetStale") == 0, get_done, NULL);
+		} else {
+			kv_delete(id, (const uint8_t *)arg, strlen(arg), delete_done, NULL);
+		}
+	} else if ((strcmp(cmd, "Leave") == 0) && (strlen(arg) == 0)) {
+		handoff_leave();
 	} else if ((strcmp(cmd, "PrintState") == 0) && (strlen(arg) == 0)) {
 		print_state();
+	} else if ((strcmp(cmd, "Stats") == 0) && (strlen(arg) == 0)) {
+		print_stats();
+	} else if (strcmp(cmd, "Bench") == 0) {
+		// Bench [lookups [concurrency [zipf exponent [keys]]]]
+		size_t n_lookups = 10000, n_keys = 10000;
+		int concurrency = 16;
+		double zipf_s = 0.99;
+		sscanf(arg, "%zu %d %lf %zu", &n_lookups, &concurrency, &zipf_s, &n_keys);
+
+		if (bench_start(n_lookups, concurrency, zipf_s, n_keys) != 0) {
+			printf("< Bench not started\n");
+		}
 	}
 
 	free(cmd);
 	free(arg);
 }
 
+void node_release(void) {
+	checkpoint_close();
+	trace_close();
+	stream_destroy();
+	vnode_destroy();
+	rpc_destroy();
+	if (sockfd >= 0) {
+		close(sockfd);
+		sockfd = -1;
+	}
+}
+
 void cleanup() {
-	free(finger_table);
-	free(successor_list);
-	sha1sum_destroy(ctx);
-	close(sockfd);
+	node_release();
 	exit(0);
 }
 
-int main(int argc, char *argv[]) {
-	printf("> ");
-	fflush(stdout);
+// The process around the handlers above, left out where something else drives them (the simulator)
+#ifndef CHORD_NO_MAIN
 
-	char input[256];
+// Maintenance timers, one set per virtual node, arg is the node's index
+static struct timer stabilize_timers[VNODE_MAX];
+static struct timer fix_fingers_timers[VNODE_MAX];
+static struct timer check_predecessor_timers[VNODE_MAX];
 
-	signal(SIGSTOP, cleanup);
-	signal(SIGINT, cleanup);
+static void stabilize_tick(void *arg) {
+	int index = (int)(intptr_t)arg;
+	vnode_activate(index);
+	stabilize();
+	timer_schedule(&stabilize_timers[index], chord_args.stablize_period * 100);
+}
 
-	chord_args = chord_parseopt(argc, argv);
+static void fix_fingers_tick(void *arg) {
+	int index = (int)(intptr_t)arg;
+	vnode_activate(index);
+	fix_fingers();
+	timer_schedule(&fix_fingers_timers[index], chord_args.fix_fingers_period * 100);
+}
 
-	// Initialize checksum
-	ctx = sha1sum_create(NULL, 0);
-	if (!ctx) {
-		perror("Error creating checksum");
-		exit(1);
+static void check_predecessor_tick(void *arg) {
+	int index = (int)(intptr_t)arg;
+	vnode_activate(index);
+	check_predecessor();
+	if (index == 0) {
+		kv_store_collect(); // The store is shared by every virtual node
 	}
-	
+	timer_schedule(&check_predecessor_timers[index], chord_args.check_predecessor_period * 100);
+}
+
+// The main thread's reactor, stdin is only watched once the node has joined
+static int epfd = -1;
+static int stats_fd = -1;
+static int stdin_is_file = 0;
+static int watch_output = 0;
+static int serving = 0; // Maintenance timers are running
+static char input[256];
+
+static int reactor_init(void) {
+	epfd = epoll_create1(0);
+	if (epfd < 0) {
+		perror("Failed to create epoll instance");
+		return -1;
+	}
+
+	struct epoll_event event = {.events = EPOLLIN, .data.fd = sockfd};
+	epoll_ctl(epfd, EPOLL_CTL_ADD, sockfd, &event);
+	return 0;
+}
+
+static void reactor_watch(int fd) {
+	struct epoll_event event = {.events = EPOLLIN, .data.fd = fd};
+
+	if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &event) < 0) {
+		// Regular files cannot be polled but are always readable
+		if (fd == STDIN_FILENO && errno == EPERM) {
+			stdin_is_file = 1;
+		} else {
+			perror("Failed to watch fd");
+		}
+	}
+}
+
+/**
+ * @brief Runs one reactor iteration.
+ *
+ * Flushes queued output, sleeps until I/O or the next due timer, then
+ * handles what is ready and fires due timers.
+ *
+ * @param serve_stdin Whether commands are read from stdin
+ * @param max_wait_ms Longest sleep, -1 to sleep until there is something to do
+ * @return int 0 to keep going, -1 once stdin is closed or on error
+ */
+static int reactor_run_once(int serve_stdin, int max_wait_ms) {
+	// Everything queued since the last iteration goes out in one batch
+	rpc_flush();
+	stream_flush();
+
+	// Wake up as soon as a backlog can drain, but not while there is none
+	if (rpc_output_pending() != watch_output) {
+		watch_output = !watch_output;
+		struct epoll_event event = {.events = EPOLLIN | (watch_output ? EPOLLOUT : 0), .data.fd = sockfd};
+		epoll_ctl(epfd, EPOLL_CTL_MOD, sockfd, &event);
+	}
+
+	// Sleeps exactly until the next RPC timeout or maintenance round
+	int64_t timeout = timers_next_timeout();
+	if (serve_stdin && stdin_is_file) {
+		timeout = 0;
+	} else if (max_wait_ms >= 0 && (timeout < 0 || timeout > max_wait_ms)) {
+		timeout = max_wait_ms;
+	} else if (timeout > INT_MAX) {
+		timeout = INT_MAX;
+	}
+
+	struct epoll_event events[8];
+	int ready = epoll_wait(epfd, events, 8, (int)timeout);
+	if (ready < 0) {
+		if (errno == EINTR) {
+			return 0;
+		}
+		perror("epoll_wait()");
+		return -1;
+	}
+
+	int stdin_ready = serve_stdin && stdin_is_file;
+	for (int i = 0; i < ready; ++i) {
+		int fd = events[i].data.fd;
+
+		if (fd == STDIN_FILENO) {
+			stdin_ready = 1;
+		} else if (fd == sockfd && (events[i].events & EPOLLIN)) {
+			process_chord_msg();
+		} else if (fd == workers_wake_fd()) {
+			workers_drain(handle_chord_msg);
+		} else if (fd == stats_fd) {
+			stats_serve(stats_fd);
+		} else {
+			stream_handle(fd, events[i].events, handle_chord_msg);
+		}
+	}
+
+	if (stdin_ready) {
+		if (!fgets(input, sizeof(input), stdin)) {
+			return -1;
+		}
+		process_input(input);
+
+		printf("> ");
+		fflush(stdout);
+	}
+
+	timers_run();
+
+	// Requests are answered from a snapshot, republished after every round of changes
+	routing_publish();
+
+	return 0;
+}
+
+int node_start(void) {
 	// Initialize socket
 	sockfd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
 	if (sockfd == -1) {
 		perror("Failed to create socket");
-		exit(1);
+		return -1;
 	}
 
 	// Set socket to reuseable
@@ -648,100 +903,189 @@ int main(int argc, char *argv[]) {
 	int flags = fcntl(sockfd, F_GETFL, 0);
 	fcntl(sockfd, F_SETFL, flags | O_NONBLOCK);
 	
+	// Workers bind the same port and share its traffic
+	if (chord_args.workers > 0) {
+		setsockopt(sockfd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt));
+	}
+	
 	if (bind(sockfd, (struct sockaddr*)&chord_args.my_address, sizeof(chord_args.my_address)) < 0) {
 		perror("Bind failed");
 		close(sockfd);
-		exit(1);
+		sockfd = -1;
+		return -1;
+	}
+
+	if (rpc_init(sockfd) != 0) {
+		fprintf(stderr, "Failed to allocate message buffers\n");
+		return -1;
 	}
 
 	// Get our IP address
 	struct sockaddr_in hash_addr;
 	get_local_address(&hash_addr);
 
-	hash = get_hash(&hash_addr);
-	
-	self = (Node) NODE__INIT;
+	// Sets up self, finger table and successor list of every virtual node
+	if (vnode_init(chord_args.vnodes, &hash_addr, get_hash(&hash_addr)) != 0) {
+		fprintf(stderr, "Failed to set up virtual nodes\n");
+		return -1;
+	}
 
-	self.address = hash_addr.sin_addr.s_addr;
-	self.port = hash_addr.sin_port;
-	self.key = hash;
+	// Routing tables from before a restart, lookups are fast again right away
+	if (chord_args.state_path) {
+		if (checkpoint_open(chord_args.state_path) != 0) {
+			return -1;
+		}
+		checkpoint_restore();
+	}
+
+	if (chord_args.trace_path && trace_open(chord_args.trace_path, chord_args.trace_rate) != 0) {
+		return -1;
+	}
+
+	if (reactor_init() != 0) {
+		return -1;
+	}
+
+	// Streams share the ring's port number, over TCP
+	if (chord_args.stream && stream_init(&chord_args.my_address, epfd) != 0) {
+		return -1;
+	}
+
+	// Requests may arrive while joining, they need a snapshot to be answered from
+	routing_publish();
 
 	if (chord_args.join_address.sin_family != AF_INET) { // New Chord ring
-		create();
-	} else { // Join existing Chord ring
-		join();
+		// Unless we checkpointed one, then we resume it with the old successor
+		if (!checkpoint_restored(0) || successor.key == 0) {
+			create();
+		}
+		successor_list[0] = successor;
+		joined = 1;
+		routing_publish();
+
+		// Further virtual nodes join the ring the first one just created
+		chord_args.join_address = hash_addr;
 	}
 
-	finger_table = malloc(sizeof(Node) * M);
-	for (int i = 0; i < M; ++i) {
-		finger_table[i] = (Node) NODE__INIT;
+	// Join existing Chord ring
+	for (int i = 0; i < vnode_count(); ++i) {
+		vnode_activate(i);
+		if (!joined) {
+			join();
+		}
 	}
+	return 0;
+}
 
-	successor_list = malloc(sizeof(Node) * chord_args.num_successors);
+int node_serve(void) {
+	if (chord_args.workers > 0) {
+		if (workers_start(chord_args.workers, &chord_args.my_address) != 0) {
+			return -1;
+		}
+		reactor_watch(workers_wake_fd());
+	}
 
-	successor_list[0] = successor;
-	for (int i = 1; i < chord_args.num_successors; ++i) {
-		successor_list[i] = (Node) NODE__INIT;
+	// Scrapes are served on the same address as the ring, over TCP
+	if (chord_args.stats_port) {
+		struct sockaddr_in stats_address = chord_args.my_address;
+		stats_address.sin_port = chord_args.stats_port;
+		if ((stats_fd = stats_listen(&stats_address)) < 0) {
+			return -1;
+		}
+		reactor_watch(stats_fd);
 	}
 
-	struct timeval timeout;
-	time_t curr = time(NULL);
-	time_t stabilize_time = curr + chord_args.stablize_period / 10;
-	time_t fix_fingers_time = curr + chord_args.fix_fingers_period / 10;
-	time_t check_predecessor_time = curr + chord_args.check_predecessor_period / 10;
+	// Periods are given in deciseconds
+	for (int i = 0; i < vnode_count(); ++i) {
+		void *index = (void *)(intptr_t)i;
+		timer_init(&stabilize_timers[i], stabilize_tick, index);
+		timer_init(&fix_fingers_timers[i], fix_fingers_tick, index);
+		timer_init(&check_predecessor_timers[i], check_predecessor_tick, index);
+		timer_schedule(&stabilize_timers[i], chord_args.stablize_period * 100);
+		timer_schedule(&fix_fingers_timers[i], chord_args.fix_fingers_period * 100);
+		timer_schedule(&check_predecessor_timers[i], chord_args.check_predecessor_period * 100);
+	}
+	checkpoint_start();
+	serving = 1;
+	return 0;
+}
 
-	timeout.tv_sec = 1; // Prevents select from blocking so periodic stuff can happen
-	timeout.tv_usec = 0;
+int node_run_once(int max_wait_ms) {
+	return reactor_run_once(0, max_wait_ms);
+}
 
-	while (1) {
-		fd_set read_fds;
-		FD_ZERO(&read_fds);
-		FD_SET(STDIN_FILENO, &read_fds);
-		FD_SET(sockfd, &read_fds);
+int node_poll_fd(void) {
+	return epfd;
+}
 
-		int maxfd = STDIN_FILENO > sockfd ? STDIN_FILENO : sockfd;
+void node_stop(void) {
+	// Workers read the routing snapshots and state node_release() frees
+	workers_stop();
+	for (int i = 0; serving && i < vnode_count(); ++i) {
+		timer_cancel(&stabilize_timers[i]);
+		timer_cancel(&fix_fingers_timers[i]);
+		timer_cancel(&check_predecessor_timers[i]);
+	}
+	serving = 0;
 
-		int ret = select(maxfd + 1, &read_fds, NULL, NULL, &timeout);
+	// Operations in flight fail now, while the socket and routing state they may touch are still there
+	rpc_cancel_all();
+	handoff_stop();
 
-		if (ret < 0) {
-			perror("Select error");
-			break;
-		}
+	if (stats_fd >= 0) {
+		close(stats_fd);
+		stats_fd = -1;
+	}
+	if (epfd >= 0) {
+		close(epfd);
+		epfd = -1;
+	}
+	watch_output = 0;
+	node_release();
+
+	// No thread is left to read any of it, node_start() may run again
+	vnode_reset();
+	routing_reset();
+	kv_store_clear();
+	location_cache_clear();
+}
 
-		if (FD_ISSET(STDIN_FILENO, &read_fds)) {
-			if (!fgets(input, sizeof(input), stdin)) {
-				break;
-			}
-			process_input(input);
-			
-			printf("> ");
-			fflush(stdout);
-		}
+// The command line around the node, left out where a program embeds it (libchord)
+#ifndef CHORD_LIBRARY
 
-	    if (FD_ISSET(sockfd, &read_fds)) {
-			process_chord_msg(10);
-		} 
+int main(int argc, char *argv[]) {
+	printf("> ");
+	fflush(stdout);
 
-		curr = time(NULL);
-		if (curr >= stabilize_time) {
-		//	printf("Stabilize\n");
-			stabilize();
-			stabilize_time = curr + chord_args.stablize_period / 10;
-		}
-		if (curr >= fix_fingers_time) {
-		//    printf("Fix fingers\n");
-			fix_fingers();
-			fix_fingers_time = curr + chord_args.fix_fingers_period / 10;
-		}
-		if (curr >= check_predecessor_time) {
-		//   printf("Check pred\n");
-			check_predecessor();
-			check_predecessor_time = curr + chord_args.check_predecessor_period / 10;
+	signal(SIGSTOP, cleanup);
+	signal(SIGINT, cleanup);
+
+	chord_args = chord_parseopt(argc, argv);
+
+	if (node_start() != 0) {
+		exit(1);
+	}
+
+	// Serve the socket until the join node tells every virtual node its successor
+	while (!vnode_all_joined()) {
+		if (reactor_run_once(0, -1) < 0) {
+			exit(1);
 		}
+	}
 
+	if (node_serve() != 0) {
+		exit(1);
+	}
+	reactor_watch(STDIN_FILENO);
+
+	while (reactor_run_once(1, -1) == 0) {
 	//print_state();
 	}
 
 	cleanup();
 	return 0;
 }
+
+#endif // CHORD_LIBRARY
+
+#endif // CHORD_NO_MAIN
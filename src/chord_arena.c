@@ -0,0 +1,116 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "chord_arena.h"
+
+// Enough for any type the decoded messages contain (power of two)
+#define ARENA_ALIGN 16
+
+// Header in front of each malloc() fallback, keeps the chain aligned
+union overflow_header {
+	void *next;
+	uint8_t align[ARENA_ALIGN];
+};
+
+static void *arena_protobuf_alloc(void *allocator_data, size_t size) {
+	return arena_alloc(allocator_data, size);
+}
+
+// Individual frees are no-ops, arena_reset() releases everything at once
+static void arena_protobuf_free(void *allocator_data, void *pointer) {
+	(void)allocator_data;
+	(void)pointer;
+}
+
+int arena_init(struct arena *arena, size_t size) {
+	memset(arena, 0, sizeof(*arena));
+
+	arena->base = malloc(size);
+	if (!arena->base) {
+		return -1;
+	}
+
+	arena->size = size;
+	arena->allocator.alloc = arena_protobuf_alloc;
+	arena->allocator.free = arena_protobuf_free;
+	arena->allocator.allocator_data = arena;
+	return 0;
+}
+
+void *arena_alloc(struct arena *arena, size_t size) {
+	size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+	if (size <= arena->size - arena->used) {
+		void *pointer = arena->base + arena->used;
+		arena->used += size;
+		return pointer;
+	}
+
+	union overflow_header *header = malloc(sizeof(*header) + size);
+	if (!header) {
+		return NULL;
+	}
+
+	header->next = arena->overflow;
+	arena->overflow = header;
+	arena->overflow_size += size;
+	return header + 1;
+}
+
+void arena_reset(struct arena *arena) {
+	while (arena->overflow) {
+		union overflow_header *header = arena->overflow;
+		arena->overflow = header->next;
+		free(header);
+	}
+
+	// Grow so a message that overflowed this time fits in the block next time
+	if (arena->overflow_size > 0) {
+		size_t size = arena->size;
+		while (size < arena->used + arena->overflow_size) {
+			size *= 2;
+		}
+
+		uint8_t *base = malloc(size);
+		if (base) {
+			free(arena->base);
+			arena->base = base;
+			arena->size = size;
+		}
+	}
+
+	arena->used = 0;
+	arena->overflow_size = 0;
+}
+
+void arena_destroy(struct arena *arena) {
+	arena_reset(arena);
+	free(arena->base);
+	arena->base = NULL;
+	arena->size = 0;
+}
+
+void *pool_get(struct pool *pool) {
+	void *object = pool->free;
+	if (!object) {
+		return malloc(pool->size);
+	}
+
+	pool->free = *(void **)object;
+	pool->n_free--;
+	return object;
+}
+
+void pool_put(struct pool *pool, void *object) {
+	if (!object) {
+		return;
+	}
+	if (pool->n_free >= pool->max_free) {
+		free(object);
+		return;
+	}
+
+	*(void **)object = pool->free;
+	pool->free = object;
+	pool->n_free++;
+}
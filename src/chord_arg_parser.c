@@ -3,6 +3,8 @@
 #include <errno.h>
 
 #include "chord_arg_parser.h"
+#include "chord_routing.h"
+#include "chord_vnode.h"
 
 error_t chord_parser(int key, char *arg, struct argp_state *state) {
 	struct chord_arguments *args = state->input;
@@ -107,6 +109,177 @@ error_t chord_parser(int key, char *arg, struct argp_state *state) {
 		break;
 	}
 
+	// --lookup lookup mode
+	case 500:
+	{
+		if (strcmp(arg, "iterative") == 0) {
+			args->lookup_mode = LOOKUP_ITERATIVE;
+		} else if (strcmp(arg, "recursive") == 0) {
+			args->lookup_mode = LOOKUP_RECURSIVE;
+		} else if (strcmp(arg, "transitive") == 0) {
+			args->lookup_mode = LOOKUP_TRANSITIVE;
+		} else {
+			argp_error(state, "Invalid lookup mode, must be iterative, recursive or transitive");
+		}
+		break;
+	}
+
+	// --workers worker thread count
+	case 501:
+	{
+		int ts_arg = atoi(arg);
+		if (ts_arg < 0 || ts_arg > 64 /*number is invalid*/) {
+			argp_error(state, "Invalid option for worker count");
+		} else {
+			args->workers = (uint8_t)ts_arg;
+		}
+		break;
+	}
+
+	// --replicas copies kept on the successor list
+	case 502:
+	{
+		int ts_arg = atoi(arg);
+		if (ts_arg < 0 || ts_arg > 32 /*number is invalid*/) {
+			argp_error(state, "Invalid option for replica count");
+		} else {
+			args->replicas = (uint8_t)ts_arg;
+		}
+		break;
+	}
+
+	// --wq write quorum
+	case 503:
+	{
+		int ts_arg = atoi(arg);
+		if (ts_arg < 1 || ts_arg > 33 /*number is invalid*/) {
+			argp_error(state, "Invalid option for write quorum");
+		} else {
+			args->write_quorum = (uint8_t)ts_arg;
+		}
+		break;
+	}
+
+	// --rq read quorum
+	case 504:
+	{
+		int ts_arg = atoi(arg);
+		if (ts_arg < 1 || ts_arg > 33 /*number is invalid*/) {
+			argp_error(state, "Invalid option for read quorum");
+		} else {
+			args->read_quorum = (uint8_t)ts_arg;
+		}
+		break;
+	}
+
+	// --vnodes ring positions per process
+	case 505:
+	{
+		int ts_arg = atoi(arg);
+		if (ts_arg < 1 || ts_arg > 64 /*number is invalid*/) {
+			argp_error(state, "Invalid option for virtual node count");
+		} else {
+			args->vnodes = (uint8_t)ts_arg;
+		}
+		break;
+	}
+
+	// --state routing state checkpoint file
+	case 506:
+	{
+		if (strlen(arg) == 0) {
+			argp_error(state, "Invalid option for state file");
+		} else {
+			args->state_path = arg;
+		}
+		break;
+	}
+
+	// --deadline lookup deadline
+	case 507:
+	{
+		int ts_arg = atoi(arg);
+		if (ts_arg < 100 || ts_arg > 600000 /*number is invalid*/) {
+			argp_error(state, "Invalid option for lookup deadline");
+		} else {
+			args->lookup_deadline = (uint32_t)ts_arg;
+		}
+		break;
+	}
+
+	// --hops lookup hop budget
+	case 508:
+	{
+		int ts_arg = atoi(arg);
+		if (ts_arg < 1 || ts_arg > 255 /*number is invalid*/) {
+			argp_error(state, "Invalid option for hop budget");
+		} else {
+			args->lookup_hops = (uint8_t)ts_arg;
+		}
+		break;
+	}
+
+	// --alpha redundant lookups
+	case 509:
+	{
+		int ts_arg = atoi(arg);
+		if (ts_arg < 1 || ts_arg > 8 /*number is invalid*/) {
+			argp_error(state, "Invalid option for lookup parallelism");
+		} else {
+			args->lookup_alpha = (uint8_t)ts_arg;
+		}
+		break;
+	}
+
+	// --stats-port text stats endpoint
+	case 510:
+	{
+		uint16_t port = atoi(arg);
+		if (port <= 0 /* port is invalid */) {
+			argp_error(state, "Invalid option for a stats port, must be a number");
+		}
+		args->stats_port = htons(port);
+		break;
+	}
+
+	// --trace trace log file
+	case 511:
+	{
+		if (strlen(arg) == 0) {
+			argp_error(state, "Invalid option for trace file");
+		} else {
+			args->trace_path = arg;
+		}
+		break;
+	}
+
+	// --trace-rate fraction of lookups traced
+	case 512:
+	{
+		char *end;
+		double rate = strtod(arg, &end);
+		if (*end != '\0' || rate <= 0 || rate > 1 /*number is invalid*/) {
+			argp_error(state, "Invalid option for trace rate, must be in (0, 1]");
+		} else {
+			args->trace_rate = rate;
+		}
+		break;
+	}
+
+	// --compact compact encoding of control messages
+	case 513:
+	{
+		args->compact = 1;
+		break;
+	}
+
+	// --stream streams for large messages
+	case 514:
+	{
+		args->stream = 1;
+		break;
+	}
+
 	default:
 		ret = ARGP_ERR_UNKNOWN;
 		break;
@@ -114,6 +287,88 @@ error_t chord_parser(int key, char *arg, struct argp_state *state) {
 	return ret;
 }
 
+int chord_check_arguments(struct chord_arguments *args) {
+	if (!args->my_address.sin_port) {
+		fprintf(stderr, "Port must be specified\n");
+		return -1;
+	}
+	// An AF_INET join address means joining, it needs both halves
+	int joining = args->join_address.sin_family == AF_INET;
+	if (!args->join_address.sin_addr.s_addr && (joining || args->join_address.sin_port)) {
+		fprintf(stderr, "Join address must be specified\n");
+		return -1;
+	}
+	if (joining && !args->join_address.sin_port) {
+		fprintf(stderr, "Join port must be specified\n");
+		return -1;
+	}
+	if (!args->stablize_period) {
+		fprintf(stderr, "Stabilize period must be specified\n");
+		return -1;
+	}
+	if (!args->fix_fingers_period) {
+		fprintf(stderr, "Fix fingers period must be specified\n");
+		return -1;
+	}
+	if (!args->check_predecessor_period) {
+		fprintf(stderr, "Check predecessor period must be specified\n");
+		return -1;
+	}
+	if (!args->num_successors) {
+		fprintf(stderr, "Number of successors must be specified\n");
+		return -1;
+	}
+	if (args->num_successors > ROUTING_MAX_SUCCESSORS) {
+		fprintf(stderr, "At most %d successors\n", ROUTING_MAX_SUCCESSORS);
+		return -1;
+	}
+#if VNODE_MAX < UINT8_MAX // The simulator's limit is more than the field holds
+	if (args->vnodes > VNODE_MAX) {
+		fprintf(stderr, "At most %d virtual nodes\n", VNODE_MAX);
+		return -1;
+	}
+#endif
+	if (args->workers > 64) {
+		fprintf(stderr, "At most 64 workers\n");
+		return -1;
+	}
+	if (args->lookup_alpha > 8) {
+		fprintf(stderr, "At most 8 redundant lookups\n");
+		return -1;
+	}
+	if (args->replicas > args->num_successors) {
+		fprintf(stderr, "Replicas cannot exceed the number of successors\n");
+		return -1;
+	}
+	if (!args->vnodes) {
+		args->vnodes = 1;
+	}
+	if (!args->write_quorum) {
+		args->write_quorum = 1;
+	}
+	if (!args->read_quorum) {
+		args->read_quorum = 1;
+	}
+	if (!args->lookup_deadline) {
+		args->lookup_deadline = 5000;
+	}
+	if (!args->lookup_hops) {
+		args->lookup_hops = 32;
+	}
+	if (!args->lookup_alpha) {
+		args->lookup_alpha = 1;
+	}
+	if (args->trace_rate == 0) {
+		args->trace_rate = 0.01;
+	}
+	if (args->write_quorum > args->replicas + 1 || args->read_quorum > args->replicas + 1) {
+		fprintf(stderr, "Quorums cannot exceed the number of copies (replicas + 1)\n");
+		return -1;
+	}
+
+	return 0;
+}
+
 struct chord_arguments chord_parseopt(int argc, char *argv[]) {
 	struct argp_option options[] = {
 		{ "port", 'p', "port", 0, "The port that is being used at the chord node", 0},
@@ -124,6 +379,21 @@ struct chord_arguments chord_parseopt(int argc, char *argv[]) {
 		{ "ja", 300, "join_addr", 0, "The IP address the chord node to join", 0},
 		{ "jp", 301, "join_port", 0, "The port that chord node we're joining is listening on", 0},
 		{ "id", 'i', "id", 0, "An ID to use for this node in lieu of hashing", 0},
+		{ "lookup", 500, "mode", 0, "How lookups are routed: iterative (default), recursive or transitive", 0},
+		{ "replicas", 502, "replicas", 0, "Successors each stored key is copied to (default 0)", 0},
+		{ "wq", 503, "write_quorum", 0, "Copies a put or delete must reach, owner included (default 1)", 0},
+		{ "rq", 504, "read_quorum", 0, "Copies a get consults, owner included (default 1)", 0},
+		{ "vnodes", 505, "vnodes", 0, "Ring positions this process owns, sharing its socket and store (default 1)", 0},
+		{ "deadline", 507, "ms", 0, "How long a lookup may take before it fails (default 5000)", 0},
+		{ "hops", 508, "hops", 0, "Requests a lookup may send before it fails (default 32)", 0},
+		{ "alpha", 509, "alpha", 0, "Redundant walks behind Lookup, Get, Put and Delete (default 1)", 0},
+		{ "state", 506, "file", 0, "Checkpoints routing state here and resumes from it on restart", 0},
+		{ "stats-port", 510, "port", 0, "Serves counters and histograms as Prometheus text over HTTP on this TCP port", 0},
+		{ "trace", 511, "file", 0, "Appends the hops of sampled lookups to this binary log, see trace_stitch", 0},
+		{ "trace-rate", 512, "rate", 0, "Fraction of lookups traced with --trace (default 0.01)", 0},
+		{ "compact", 513, 0, 0, "Sends control messages in a fixed binary layout to peers that accept it", 0},
+		{ "stream", 514, 0, 0, "Sends messages too large for one unfragmented datagram over a TCP connection per peer", 0},
+		{ "workers", 501, "workers", 0, "Extra threads answering lookups on their own SO_REUSEPORT sockets (default 0)", 0},
 		{0}
 	};
 
@@ -137,33 +407,7 @@ struct chord_arguments chord_parseopt(int argc, char *argv[]) {
         exit(1);
 	}
 
-	// TODO: ADDITIONAL ARGUMENT VALIDATION
-	if (!args.my_address.sin_port) {
-		perror("Port must be specified");
-		exit(1);
-	}
-	if (!args.join_address.sin_addr.s_addr && args.join_address.sin_port) {
-		perror("Join address must be specified");
-		exit(1);
-	}
-	if (!args.my_address.sin_port && args.join_address.sin_addr.s_addr) {
-		perror("Join port must be specified");
-		exit(1);
-	}
-	if (!args.stablize_period) {
-		perror("Stabilize period must be specified");
-		exit(1);
-	}
-	if (!args.fix_fingers_period) {
-		perror("Fix fingers period must be specified");
-		exit(1);
-	}
-	if (!args.check_predecessor_period) {
-		perror("Check predecessor period must be specified");
-		exit(1);
-	}
-	if (!args.num_successors) {
-		perror("Number of successors must be specified");
+	if (chord_check_arguments(&args) != 0) {
 		exit(1);
 	}
 
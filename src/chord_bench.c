@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <arpa/inet.h>
+
+#include "chord.h"
+#include "chord_arg_parser.h"
+#include "chord_bench.h"
+#include "chord_impl.h"
+#include "chord_timer.h"
+#include "hash.h"
+
+struct bench_run {
+	size_t n_lookups;
+	size_t started;
+	size_t finished;
+	size_t failed;
+
+	size_t n_keys;
+	uint64_t *keys;         // Key of each rank
+	double *cdf;            // cdf[r] is the chance of drawing rank r or lower
+	uint64_t rng;
+
+	uint64_t start_us;
+	uint64_t *latency_us;   // Of the lookups that succeeded
+	uint64_t hops[BENCH_MAX_HOPS + 1];
+	uint64_t requests;
+};
+
+static struct bench_run *run = NULL;
+
+// Lookups our successor answers complete inside find_successor(), so
+// starting the next one from a callback is queued rather than recursed into
+static int dispatching = 0;
+static int wanted = 0;
+
+// xorshift64*, plenty for picking keys
+static double next_uniform(struct bench_run *bench) {
+	bench->rng ^= bench->rng >> 12;
+	bench->rng ^= bench->rng << 25;
+	bench->rng ^= bench->rng >> 27;
+	return ((bench->rng * 0x2545F4914F6CDD1DULL) >> 11) * 0x1.0p-53;
+}
+
+static uint64_t next_key(struct bench_run *bench) {
+	double u = next_uniform(bench);
+
+	// First rank whose cumulative weight reaches u
+	size_t low = 0, high = bench->n_keys - 1;
+	while (low < high) {
+		size_t mid = low + (high - low) / 2;
+		if (bench->cdf[mid] < u) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+	return bench->keys[low];
+}
+
+static int compare_u64(const void *a, const void *b) {
+	uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+	return (x > y) - (x < y);
+}
+
+static uint64_t percentile(const uint64_t *sorted, size_t n, double p) {
+	return n == 0 ? 0 : sorted[(size_t)(p * (n - 1))];
+}
+
+static void report(struct bench_run *bench) {
+	double seconds = (monotonic_us() - bench->start_us) / 1e6;
+	size_t ok = bench->finished - bench->failed;
+
+	qsort(bench->latency_us, ok, sizeof(uint64_t), compare_u64);
+
+	printf("< Bench %zu lookups, %zu failed, %.3f s, %.1f lookups/s\n",
+	       bench->finished, bench->failed, seconds, seconds > 0 ? bench->finished / seconds : 0);
+	printf("< Latency us p50 %" PRIu64 " p99 %" PRIu64 " p999 %" PRIu64 " max %" PRIu64 "\n",
+	       percentile(bench->latency_us, ok, 0.5), percentile(bench->latency_us, ok, 0.99),
+	       percentile(bench->latency_us, ok, 0.999), percentile(bench->latency_us, ok, 1));
+	printf("< Requests per lookup %.2f\n", bench->finished ? (double)bench->requests / bench->finished : 0);
+
+	printf("< Hops");
+	for (int i = 0; i <= BENCH_MAX_HOPS; ++i) {
+		if (bench->hops[i]) {
+			printf(" %d%s:%" PRIu64, i, i == BENCH_MAX_HOPS ? "+" : "", bench->hops[i]);
+		}
+	}
+	printf("\n");
+	fflush(stdout);
+}
+
+static void bench_free(struct bench_run *bench) {
+	free(bench->keys);
+	free(bench->cdf);
+	free(bench->latency_us);
+	free(bench);
+}
+
+static void bench_next(void);
+
+static void bench_done(Node *node, void *arg) {
+	struct bench_run *bench = run;
+	uint64_t started_us = (uint64_t)(uintptr_t)arg;
+
+	int hops, requests;
+	find_successor_cost(&hops, &requests);
+
+	if (node) {
+		bench->latency_us[bench->finished - bench->failed] = monotonic_us() - started_us;
+		bench->hops[hops < BENCH_MAX_HOPS ? hops : BENCH_MAX_HOPS]++;
+	} else {
+		bench->failed++;
+	}
+	bench->requests += requests;
+	bench->finished++;
+
+	if (bench->finished == bench->n_lookups) {
+		report(bench);
+		run = NULL;
+		bench_free(bench);
+		return;
+	}
+	bench_next();
+}
+
+static void bench_next(void) {
+	wanted++;
+	if (dispatching) {
+		return;
+	}
+
+	dispatching = 1;
+	while (wanted > 0 && run && run->started < run->n_lookups) {
+		wanted--;
+		run->started++;
+
+		// The start time rides along as the argument, no allocation per lookup
+		void *arg = (void *)(uintptr_t)monotonic_us();
+		find_successor_parallel(next_key(run), chord_args.lookup_alpha, bench_done, arg);
+	}
+	wanted = 0;
+	dispatching = 0;
+}
+
+int bench_start(size_t n_lookups, int concurrency, double zipf_s, size_t n_keys) {
+	if (run || n_lookups == 0 || n_keys == 0 || concurrency < 1
+		|| concurrency > BENCH_MAX_CONCURRENCY || zipf_s < 0) {
+		return -1;
+	}
+
+	struct bench_run *bench = calloc(1, sizeof(*bench));
+	if (!bench) {
+		return -1;
+	}
+	bench->n_lookups = n_lookups;
+	bench->n_keys = n_keys;
+	bench->keys = malloc(sizeof(uint64_t) * n_keys);
+	bench->cdf = malloc(sizeof(double) * n_keys);
+	bench->latency_us = malloc(sizeof(uint64_t) * n_lookups);
+	bench->rng = 0x9E3779B97F4A7C15ULL ^ n_lookups;
+	if (!bench->keys || !bench->cdf || !bench->latency_us) {
+		bench_free(bench);
+		return -1;
+	}
+
+	double total = 0;
+	for (size_t r = 0; r < n_keys; ++r) {
+		char name[32];
+		int len = snprintf(name, sizeof(name), "key%zu", r + 1);
+		bench->keys[r] = sha1sum_head((const uint8_t *)name, len);
+
+		total += pow(r + 1, -zipf_s);
+		bench->cdf[r] = total;
+	}
+	for (size_t r = 0; r < n_keys; ++r) {
+		bench->cdf[r] /= total;
+	}
+
+	run = bench;
+	bench->start_us = monotonic_us();
+
+	for (int i = 0; i < concurrency; ++i) {
+		bench_next();
+	}
+	return 0;
+}
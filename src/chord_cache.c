@@ -0,0 +1,151 @@
+#include <string.h>
+#include <arpa/inet.h>
+
+#include "chord_cache.h"
+#include "chord_impl.h"
+#include "chord_timer.h"
+
+// Owner of (start, owner.key] as of some lookup
+struct location_entry {
+	uint64_t start;
+	Node owner;
+	uint64_t expires;       // Monotonic ms
+	int referenced;         // Hit since the clock hand last passed
+};
+
+// Sorted by owner key, so the entry that can hold an id is the first at or
+// after it. Intervals of distinct owners never overlap.
+static struct location_entry entries[LOCATION_CACHE_SIZE];
+static size_t n_entries = 0;
+static size_t hand = 0;
+
+// First entry whose owner key is at least key, n_entries if there is none
+static size_t lower_bound(uint64_t key) {
+	size_t low = 0, high = n_entries;
+	while (low < high) {
+		size_t mid = low + (high - low) / 2;
+		if (entries[mid].owner.key < key) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+	return low;
+}
+
+static void remove_entry(size_t index) {
+	memmove(&entries[index], &entries[index + 1], sizeof(entries[0]) * (n_entries - index - 1));
+	n_entries--;
+	if (hand > index) {
+		hand--;
+	}
+}
+
+// CLOCK: passes over and clears referenced entries, drops the first that is not
+static void evict(uint64_t now) {
+	for (;;) {
+		if (hand >= n_entries) {
+			hand = 0;
+		}
+
+		struct location_entry *entry = &entries[hand];
+		if (entry->referenced && entry->expires > now) {
+			entry->referenced = 0;
+			hand++;
+		} else {
+			remove_entry(hand);
+			return;
+		}
+	}
+}
+
+void location_cache_insert(uint64_t start, const Node *owner) {
+	uint64_t now = monotonic_ms();
+
+	// Nobody else can sit inside an interval the owner holds
+	for (size_t i = 0; i < n_entries;) {
+		if (element_of(entries[i].owner.key, start, owner->key, 0)) {
+			remove_entry(i);
+		} else {
+			i++;
+		}
+	}
+
+	size_t index = lower_bound(owner->key);
+	if (index < n_entries && entries[index].owner.key == owner->key) {
+		struct location_entry *entry = &entries[index];
+
+		// Both intervals were answered by the same node, keep the wider one
+		if (entry->owner.address != owner->address || entry->owner.port != owner->port
+			|| owner->key - start > owner->key - entry->start) {
+			entry->start = start;
+		}
+		entry->owner = *owner;
+		entry->expires = now + LOCATION_CACHE_TTL_MS;
+		return;
+	}
+
+	if (n_entries == LOCATION_CACHE_SIZE) {
+		evict(now);
+		index = lower_bound(owner->key);
+	}
+
+	memmove(&entries[index + 1], &entries[index], sizeof(entries[0]) * (n_entries - index));
+	n_entries++;
+	if (hand >= index) {
+		hand++;
+	}
+
+	entries[index] = (struct location_entry) {
+		.start = start,
+		.owner = *owner,
+		.expires = now + LOCATION_CACHE_TTL_MS,
+		.referenced = 0,
+	};
+}
+
+// Entry whose interval holds id, dropping it if it has expired
+static int find_entry(uint64_t id, size_t *index) {
+	if (n_entries == 0) {
+		return 0;
+	}
+
+	size_t i = lower_bound(id);
+	if (i == n_entries) {
+		i = 0; // Past the largest owner key, wraps to the smallest
+	}
+
+	if (entries[i].expires <= monotonic_ms()) {
+		remove_entry(i);
+		return 0;
+	}
+	if (!element_of(id, entries[i].start, entries[i].owner.key, 1)) {
+		return 0;
+	}
+
+	*index = i;
+	return 1;
+}
+
+int location_cache_lookup(uint64_t id, Node *owner) {
+	size_t index;
+	if (!find_entry(id, &index)) {
+		return 0;
+	}
+
+	entries[index].referenced = 1;
+	*owner = entries[index].owner;
+	return 1;
+}
+
+void location_cache_invalidate(uint64_t id) {
+	size_t index;
+	if (find_entry(id, &index)) {
+		remove_entry(index);
+	}
+}
+
+void location_cache_clear(void) {
+	n_entries = 0;
+	hand = 0;
+}
@@ -0,0 +1,304 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "chord.h"
+#include "chord_arg_parser.h"
+#include "chord_checkpoint.h"
+#include "chord_impl.h"
+#include "chord_peer.h"
+#include "chord_routing.h"
+#include "chord_rpc.h"
+#include "chord_timer.h"
+#include "chord_vnode.h"
+#include "chord.pb-c.h"
+
+#define CHECKPOINT_MAGIC 0x43484f5244535431ULL // "CHORDST1"
+#define CHECKPOINT_VERSION 1
+
+struct checkpoint_node {
+	uint64_t key;
+	uint32_t address;
+	uint32_t port;
+};
+
+struct checkpoint_vnode {
+	uint64_t hash;
+	struct checkpoint_node predecessor;
+	struct checkpoint_node successor;
+	struct checkpoint_node fingers[ROUTING_FINGERS];
+	struct checkpoint_node successors[ROUTING_MAX_SUCCESSORS];
+};
+
+// Layout of the mapped file. sequence is odd while a copy is being written,
+// so a process that died halfway leaves a checkpoint restore will not trust.
+struct checkpoint_file {
+	uint64_t magic;
+	uint32_t version;
+	uint32_t n_vnodes;
+	uint64_t sequence;
+	uint64_t saved_ms;      // Wall clock, the monotonic clock restarts with the machine
+	uint32_t num_successors;
+	uint32_t n_peers;
+	struct checkpoint_vnode vnodes[VNODE_MAX];
+	struct peer_record peers[PEER_TABLE_SIZE];
+};
+
+static struct checkpoint_file *file = NULL;
+static struct timer save_timer;
+static unsigned char restored[VNODE_MAX];
+
+static void save_tick(void *arg);
+
+static uint64_t realtime_ms(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+static struct checkpoint_node pack_node(const Node *node) {
+	return (struct checkpoint_node) {node->key, node->address, node->port};
+}
+
+static Node unpack_node(const struct checkpoint_node *saved) {
+	Node node = NODE__INIT;
+	node.key = saved->key;
+	node.address = saved->address;
+	node.port = saved->port;
+	return node;
+}
+
+static int same_node(const Node *a, const Node *b) {
+	return a->key == b->key && a->address == b->address && a->port == b->port;
+}
+
+int checkpoint_open(const char *path) {
+	int fd = open(path, O_RDWR | O_CREAT, 0644);
+	if (fd < 0) {
+		perror("Failed to open state file");
+		return -1;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		perror("Failed to stat state file");
+		close(fd);
+		return -1;
+	}
+
+	int fresh = (size_t)st.st_size != sizeof(struct checkpoint_file);
+	if (fresh && ftruncate(fd, sizeof(struct checkpoint_file)) != 0) {
+		perror("Failed to size state file");
+		close(fd);
+		return -1;
+	}
+
+	file = mmap(NULL, sizeof(struct checkpoint_file), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (file == MAP_FAILED) {
+		perror("Failed to map state file");
+		file = NULL;
+		return -1;
+	}
+
+	if (fresh || file->magic != CHECKPOINT_MAGIC || file->version != CHECKPOINT_VERSION) {
+		memset(file, 0, sizeof(*file));
+	}
+	timer_init(&save_timer, save_tick, NULL);
+	return 0;
+}
+
+void checkpoint_close(void) {
+	if (file) {
+		timer_cancel(&save_timer);
+		munmap(file, sizeof(*file));
+		file = NULL;
+	}
+	memset(restored, 0, sizeof(restored));
+}
+
+static void save(void) {
+	__atomic_store_n(&file->sequence, file->sequence + 1, __ATOMIC_RELEASE);
+
+	int n_vnodes = vnode_count();
+	for (int i = 0; i < n_vnodes; ++i) {
+		const struct vnode_state *state = vnode_get(i);
+		struct checkpoint_vnode *saved = &file->vnodes[i];
+
+		saved->hash = state->hash;
+		saved->predecessor = pack_node(&state->predecessor);
+		saved->successor = pack_node(&state->successor);
+		for (int j = 0; j < ROUTING_FINGERS; ++j) {
+			saved->fingers[j] = pack_node(&state->finger_table[j]);
+		}
+		for (int j = 0; j < chord_args.num_successors; ++j) {
+			saved->successors[j] = pack_node(&state->successor_list[j]);
+		}
+	}
+
+	file->magic = CHECKPOINT_MAGIC;
+	file->version = CHECKPOINT_VERSION;
+	file->n_vnodes = n_vnodes;
+	file->num_successors = chord_args.num_successors;
+	file->n_peers = peer_export(file->peers);
+	file->saved_ms = realtime_ms();
+
+	__atomic_store_n(&file->sequence, file->sequence + 1, __ATOMIC_RELEASE);
+}
+
+static void save_tick(void *arg) {
+	(void)arg;
+	save();
+	timer_schedule(&save_timer, CHECKPOINT_INTERVAL_MS);
+}
+
+void checkpoint_start(void) {
+	if (!file) {
+		return;
+	}
+	save_tick(NULL);
+}
+
+// Drops a node that did not answer from the active virtual node's tables
+static void forget(const Node *dead) {
+	if (same_node(&predecessor, dead)) {
+		predecessor = (Node) NODE__INIT;
+	}
+	for (int i = 0; i < M; ++i) {
+		if (same_node(&finger_table[i], dead)) {
+			finger_table[i] = (Node) NODE__INIT;
+		}
+	}
+
+	int kept = 0;
+	for (int i = 0; i < chord_args.num_successors; ++i) {
+		if (!same_node(&successor_list[i], dead)) {
+			successor_list[kept++] = successor_list[i];
+		}
+	}
+	for (; kept < chord_args.num_successors; ++kept) {
+		successor_list[kept] = (Node) NODE__INIT;
+	}
+
+	// Without a live entry behind it the successor stays, join() replaces it
+	if (same_node(&successor, dead) && successor_list[0].key != 0) {
+		successor = successor_list[0];
+	}
+}
+
+static void revalidate_reply(MessageResponse *response, void *arg) {
+	Node *node = arg;
+
+	if (response->type != CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_RESPONSE) {
+		int active = vnode_active();
+		for (int i = 0; i < vnode_count(); ++i) {
+			if (restored[i]) {
+				vnode_activate(i);
+				forget(node);
+			}
+		}
+		vnode_activate(active);
+	}
+	free(node);
+}
+
+// Pings every distinct node the restored tables name, once per process
+static void revalidate(void) {
+	size_t n_distinct = 0;
+	Node *distinct = malloc(sizeof(Node) * VNODE_MAX * (ROUTING_CANDIDATES + 1));
+	if (!distinct) {
+		return;
+	}
+
+	for (int i = 0; i < vnode_count(); ++i) {
+		if (!restored[i]) {
+			continue;
+		}
+		const struct vnode_state *state = vnode_get(i);
+
+		for (int j = 0; j < M + chord_args.num_successors + 1; ++j) {
+			const Node *node = j < M ? &state->finger_table[j]
+				: j < M + chord_args.num_successors ? &state->successor_list[j - M] : &state->predecessor;
+			if (node->key == 0 || vnode_is_local(node)) {
+				continue;
+			}
+
+			size_t k = 0;
+			while (k < n_distinct && !same_node(&distinct[k], node)) {
+				k++;
+			}
+			if (k == n_distinct) {
+				distinct[n_distinct++] = *node;
+			}
+		}
+	}
+
+	for (size_t k = 0; k < n_distinct; ++k) {
+		Node *node = malloc(sizeof(Node));
+		if (!node) {
+			continue; // Left to ordinary maintenance, like a full pending table
+		}
+		*node = distinct[k];
+
+		CheckPredecessorRequest request = CHECK_PREDECESSOR_REQUEST__INIT;
+		ChordMessage msg = CHORD_MESSAGE__INIT;
+		msg.version = 417;
+		msg.check_predecessor_request = &request;
+		msg.msg_case = CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_REQUEST;
+
+		// A full pending table leaves the entry to ordinary maintenance
+		if (rpc_call(node, &msg, CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_RESPONSE, revalidate_reply, node) != 0) {
+			free(node);
+		}
+	}
+
+	free(distinct);
+}
+
+int checkpoint_restore(void) {
+	if (!file || file->magic != CHECKPOINT_MAGIC || file->sequence % 2 != 0
+		|| realtime_ms() - file->saved_ms > CHECKPOINT_MAX_AGE_MS) {
+		return 0;
+	}
+
+	int n_restored = 0;
+	int n_successors = file->num_successors < chord_args.num_successors ? file->num_successors : chord_args.num_successors;
+	int active = vnode_active();
+
+	for (int i = 0; i < vnode_count() && i < (int)file->n_vnodes; ++i) {
+		const struct checkpoint_vnode *saved = &file->vnodes[i];
+		if (saved->hash != vnode_get(i)->hash) {
+			continue; // Address or --id changed, this is some other node's state
+		}
+
+		vnode_activate(i);
+		predecessor = unpack_node(&saved->predecessor);
+		successor = unpack_node(&saved->successor);
+		for (int j = 0; j < M; ++j) {
+			finger_table[j] = unpack_node(&saved->fingers[j]);
+		}
+		for (int j = 0; j < n_successors; ++j) {
+			successor_list[j] = unpack_node(&saved->successors[j]);
+		}
+
+		restored[i] = 1;
+		n_restored++;
+	}
+	vnode_activate(active);
+
+	if (n_restored > 0) {
+		peer_import(file->peers, file->n_peers < PEER_TABLE_SIZE ? file->n_peers : PEER_TABLE_SIZE);
+		revalidate();
+	}
+	return n_restored;
+}
+
+int checkpoint_restored(int index) {
+	return restored[index];
+}
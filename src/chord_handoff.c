@@ -0,0 +1,365 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+
+#include "chord.h"
+#include "chord_arg_parser.h"
+#include "chord_handoff.h"
+#include "chord_impl.h"
+#include "chord_kv.h"
+#include "chord_rpc.h"
+#include "chord_timer.h"
+#include "chord_vnode.h"
+#include "chord.pb-c.h"
+
+// Encoding overhead assumed per entry when sizing a chunk
+#define HANDOFF_ITEM_OVERHEAD 32
+
+// A range being pulled to this node
+struct handoff {
+	Node source;
+	uint64_t start, end;
+	uint64_t cursor;
+	uint64_t generation;
+	protobuf_c_boolean started;     // cursor and generation came from the source
+	int releasing;                  // Every chunk is in, waiting for the release to be acknowledged
+	int retries;
+	struct timer timer;
+	struct handoff *next;
+};
+
+static struct handoff *handoffs = NULL;
+
+// Virtual nodes whose successor has yet to release their range
+static int leaving = 0;
+static int leave_pending = 0;
+static unsigned char leave_waiting[VNODE_MAX];
+static struct timer leave_timer;
+
+static void handoff_step(void *arg);
+
+static void handoff_free(struct handoff *handoff) {
+	struct handoff **link = &handoffs;
+	while (*link != handoff) {
+		link = &(*link)->next;
+	}
+	*link = handoff->next;
+
+	timer_cancel(&handoff->timer);
+	free(handoff);
+}
+
+static void handoff_reply(MessageResponse *response, void *arg) {
+	struct handoff *handoff = arg;
+
+	if (response->type != CHORD_MESSAGE__MSG_HANDOFF_RESPONSE) {
+		// Same cursor again, the source may just be busy
+		if (++handoff->retries > HANDOFF_MAX_RETRIES) {
+			fprintf(stderr, "Handoff from %" PRIu64 " abandoned\n", handoff->source.key);
+			handoff_free(handoff);
+		} else {
+			timer_schedule(&handoff->timer, RPC_TIMEOUT_MS);
+		}
+		return;
+	}
+	handoff->retries = 0;
+
+	if (handoff->releasing) {
+		handoff_free(handoff);
+		return;
+	}
+
+	HandoffResponse *handoffResponse = response->message->handoff_response;
+	for (size_t i = 0; i < handoffResponse->n_items; ++i) {
+		KeyValue *item = handoffResponse->items[i];
+		const struct kv_item *local = kv_store_get(item->id, item->key.data, item->key.len);
+
+		if (local && local->version >= item->version) {
+			continue;
+		}
+		if (item->deleted) {
+			kv_store_tombstone(item->id, item->key.data, item->key.len, item->version);
+		} else {
+			kv_store_put(item->id, item->key.data, item->key.len, item->value.data, item->value.len, item->version);
+		}
+	}
+
+	// A resize on the source restarts the walk, entries already here are not re-stored
+	handoff->cursor = handoffResponse->cursor;
+	handoff->generation = handoffResponse->generation;
+	handoff->started = 1;
+	handoff->releasing = handoffResponse->done;
+
+	timer_schedule(&handoff->timer, HANDOFF_INTERVAL_MS);
+}
+
+static void handoff_step(void *arg) {
+	struct handoff *handoff = arg;
+
+	HandoffRequest request = HANDOFF_REQUEST__INIT;
+	request.start = handoff->start;
+	request.end = handoff->end;
+	request.has_cursor = handoff->started;
+	request.cursor = handoff->cursor;
+	request.has_generation = handoff->started;
+	request.generation = handoff->generation;
+	request.has_release = handoff->releasing;
+	request.release = handoff->releasing;
+
+	ChordMessage msg = CHORD_MESSAGE__INIT;
+	msg.version = 417;
+	msg.handoff_request = &request;
+	msg.msg_case = CHORD_MESSAGE__MSG_HANDOFF_REQUEST;
+
+	if (rpc_call(&handoff->source, &msg, CHORD_MESSAGE__MSG_HANDOFF_RESPONSE, handoff_reply, handoff) != 0) {
+		timer_schedule(&handoff->timer, RPC_TIMEOUT_MS); // Pending table full, try again later
+	}
+}
+
+void handoff_start(Node *source, uint64_t start, uint64_t end) {
+	// Our own virtual nodes share the store, nothing to move
+	if (vnode_is_local(source) || start == end) {
+		return;
+	}
+
+	// A range already on its way from the same node is not pulled twice
+	for (struct handoff *handoff = handoffs; handoff; handoff = handoff->next) {
+		if (handoff->source.key == source->key && handoff->start == start && handoff->end == end) {
+			return;
+		}
+	}
+
+	struct handoff *handoff = calloc(1, sizeof(*handoff));
+	if (!handoff) {
+		return;
+	}
+	handoff->source = *source;
+	handoff->start = start;
+	handoff->end = end;
+	timer_init(&handoff->timer, handoff_step, handoff);
+
+	handoff->next = handoffs;
+	handoffs = handoff;
+
+	handoff_step(handoff);
+}
+
+Node *handoff_source(uint64_t id) {
+	for (struct handoff *handoff = handoffs; handoff; handoff = handoff->next) {
+		if (!handoff->releasing && element_of(id, handoff->start, handoff->end, 1)) {
+			return &handoff->source;
+		}
+	}
+	return NULL;
+}
+
+static void leave_reply(MessageResponse *response, void *arg) {
+	(void)response;
+	(void)arg;
+	// The successor starts pulling, leave_timer bounds the wait either way
+}
+
+static void leave_tick(void *arg) {
+	(void)arg;
+	fprintf(stderr, "Successor did not take over in time, leaving anyway\n");
+	cleanup();
+}
+
+void handoff_leave(void) {
+	int active = vnode_active();
+
+	for (int i = 0; i < vnode_count(); ++i) {
+		vnode_activate(i);
+
+		// A successor in this process leaves with us
+		if (vnode_is_local(&successor)) {
+			continue;
+		}
+
+		LeaveRequest request = LEAVE_REQUEST__INIT;
+		if (predecessor.key != 0) {
+			request.predecessor = &predecessor;
+		}
+
+		ChordMessage msg = CHORD_MESSAGE__INIT;
+		msg.version = 417;
+		msg.leave_request = &request;
+		msg.msg_case = CHORD_MESSAGE__MSG_LEAVE_REQUEST;
+
+		if (rpc_call(&successor, &msg, CHORD_MESSAGE__MSG_LEAVE_RESPONSE, leave_reply, NULL) == 0) {
+			leave_waiting[i] = 1;
+			leave_pending++;
+		}
+	}
+	vnode_activate(active);
+
+	if (leave_pending == 0) {
+		cleanup(); // Alone on the ring
+	}
+
+	leaving = 1;
+	timer_init(&leave_timer, leave_tick, NULL);
+	timer_schedule(&leave_timer, HANDOFF_LEAVE_TIMEOUT_MS);
+}
+
+void handoff_stop(void) {
+	while (handoffs) {
+		handoff_free(handoffs);
+	}
+
+	if (leaving) {
+		timer_cancel(&leave_timer);
+	}
+	leaving = 0;
+	leave_pending = 0;
+	memset(leave_waiting, 0, sizeof(leave_waiting));
+}
+
+// Drops a released range, deletes can pull later entries into the current slot
+static void release_range(uint64_t start, uint64_t end) {
+	size_t slot = 0;
+	while (slot < kv_store_capacity()) {
+		const struct kv_item *item = kv_store_slot(slot);
+
+		if (item && element_of(item->id, start, end, 1)) {
+			kv_store_delete(item->id, kv_item_key(item), item->key_len);
+		} else {
+			slot++;
+		}
+	}
+}
+
+// Next chunk of (start, end] from the cursor on, ending at a free slot so
+// entries a later delete shifts back are not skipped. A chunk that reaches
+// the hard limit is cut back to the last free slot it passed, only a run
+// too large for a datagram on its own is split
+static void answer_handoff(HandoffRequest *request, HandoffResponse *response) {
+	uint64_t cursor = request->has_cursor && request->generation == kv_store_generation() ? request->cursor : 0;
+	size_t capacity = kv_store_capacity();
+
+	size_t n_items = 0;
+	size_t bytes = 0;
+	size_t end = cursor;
+	size_t free_slot = cursor;       // Last free slot passed, where the chunk can end
+	size_t items_before_free = 0;
+	for (; end < capacity; ++end) {
+		const struct kv_item *item = kv_store_slot(end);
+
+		if (!item) {
+			if (bytes >= HANDOFF_CHUNK_BYTES) {
+				break;
+			}
+			free_slot = end;
+			items_before_free = n_items;
+			continue;
+		}
+		if (!element_of(item->id, request->start, request->end, 1)) {
+			continue;
+		}
+
+		size_t size = item->key_len + item->value_len + HANDOFF_ITEM_OVERHEAD;
+		if (n_items > 0 && bytes + size > HANDOFF_MAX_CHUNK_BYTES) {
+			// The next chunk starts over at the run this item belongs to
+			if (free_slot > cursor) {
+				end = free_slot;
+				n_items = items_before_free;
+			}
+			break;
+		}
+		bytes += size;
+		n_items++;
+	}
+
+	KeyValue *items = message_scratch(sizeof(KeyValue) * n_items);
+	KeyValue **item_ptrs = message_scratch(sizeof(KeyValue *) * n_items);
+	size_t n = 0;
+	for (size_t slot = cursor; slot < end && n < n_items; ++slot) {
+		const struct kv_item *item = kv_store_slot(slot);
+
+		if (item && element_of(item->id, request->start, request->end, 1)) {
+			items[n] = (KeyValue) KEY_VALUE__INIT;
+			items[n].id = item->id;
+			items[n].key = (ProtobufCBinaryData) {.len = item->key_len, .data = (uint8_t *)kv_item_key(item)};
+			items[n].value = (ProtobufCBinaryData) {.len = item->value_len, .data = (uint8_t *)kv_item_value(item)};
+			items[n].version = item->version;
+			items[n].has_deleted = item->deleted;
+			items[n].deleted = item->deleted;
+			item_ptrs[n] = &items[n];
+			n++;
+		}
+	}
+
+	response->n_items = n;
+	response->items = item_ptrs;
+	response->cursor = end;
+	response->generation = kv_store_generation();
+	response->done = end >= capacity;
+}
+
+int handoff_handle_request(ChordMessage *message, struct sockaddr_in *from) {
+	ChordMessage msg = CHORD_MESSAGE__INIT;
+	msg.version = 417;
+	msg.has_query_id = message->has_query_id;
+	msg.query_id = message->query_id;
+
+	// Handoff
+	if (message->msg_case == CHORD_MESSAGE__MSG_HANDOFF_REQUEST) {
+		HandoffRequest *request = message->handoff_request;
+		HandoffResponse handoffResponse = HANDOFF_RESPONSE__INIT;
+
+		if (request->release) {
+			// Without replication nothing here is needed any more, with it this
+			// node stays one of the range's replicas
+			if (chord_args.replicas == 0) {
+				release_range(request->start, request->end);
+			}
+			handoffResponse.generation = kv_store_generation();
+			handoffResponse.done = 1;
+		} else {
+			answer_handoff(request, &handoffResponse);
+		}
+
+		msg.handoff_response = &handoffResponse;
+		msg.msg_case = CHORD_MESSAGE__MSG_HANDOFF_RESPONSE;
+
+		send_message(from, &msg, "Error sending handoff response");
+
+		// A repeated release for the same range only counts once
+		int index = vnode_find(request->end);
+		if (request->release && leaving && index >= 0 && leave_waiting[index]) {
+			leave_waiting[index] = 0;
+			if (--leave_pending == 0) {
+				rpc_flush();
+				cleanup();
+			}
+		}
+		return 1;
+	}
+
+	// Leave
+	if (message->msg_case == CHORD_MESSAGE__MSG_LEAVE_REQUEST) {
+		LeaveRequest *request = message->leave_request;
+
+		// Only our predecessor can hand us its range
+		if (predecessor.key != 0 && predecessor.address == from->sin_addr.s_addr && predecessor.port == from->sin_port) {
+			Node leaver = predecessor;
+
+			if (request->predecessor && request->predecessor->key != hash) {
+				predecessor = *request->predecessor;
+			} else {
+				predecessor = (Node) NODE__INIT;
+			}
+			handoff_start(&leaver, request->predecessor ? request->predecessor->key : hash, leaver.key);
+		}
+
+		LeaveResponse leaveResponse = LEAVE_RESPONSE__INIT;
+		msg.leave_response = &leaveResponse;
+		msg.msg_case = CHORD_MESSAGE__MSG_LEAVE_RESPONSE;
+
+		send_message(from, &msg, "Error sending leave response");
+		return 1;
+	}
+
+	return 0;
+}
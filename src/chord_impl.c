@@ -8,358 +8,882 @@
 #include <string.h>
 #include <unistd.h>
 #include <arpa/inet.h>
-#include <time.h>
-#include <sys/select.h>
+#include <stdint.h>
 
 #include "chord.h"
 #include "chord_impl.h"
+#include "chord_arena.h"
 #include "chord_arg_parser.h"
+#include "chord_cache.h"
+#include "chord_peer.h"
+#include "chord_rpc.h"
+#include "chord_routing.h"
+#include "chord_stats.h"
+#include "chord_timer.h"
+#include "chord_trace.h"
+#include "chord_vnode.h"
+#include "chord_wire.h"
 #include "chord.pb-c.h"
 
-/**
- * @brief Sends a buffer to a Chord node over UDP.
- * 
- * This helper function constructs a socket address from the provided Node structure
- * and sends the given buffer to that node using the sendto() system call. The function
- * handles error reporting and terminates the program if the send operation fails.
- * 
- * @param node Pointer to the target Chord node to send the message to. The node's
- *             address and port are extracted to construct the destination socket address.
- *             Must not be NULL.
- * @param buffer Pointer to the buffer containing the message data to send. The buffer
- *               should contain a properly formatted Chord protocol message.
- * @param total_size The total size in bytes of the buffer to send. This should include
- *                   both the message length prefix and the actual message data.
- * @param error_msg Optional error message string to print before the system error
- *                  message. If NULL, only the system error message from perror() is
- *                  printed. The error message is printed to stderr.
- * 
- * @note This function uses the global sockfd variable for the socket file descriptor.
- *       The function will call exit(1) if sendto() fails, so it does not return on error.
- * 
- * @warning This function terminates the program on failure. Ensure proper error handling
- *          in calling code if graceful error recovery is needed.
- */
-static void send_to_node(Node *node, uint8_t *buffer, size_t total_size, const char *error_msg) {
-	struct sockaddr_in node_addr;
-	node_addr.sin_family = AF_INET;
-	node_addr.sin_port = node->port;
-	node_addr.sin_addr = (struct in_addr) {.s_addr = node->address};
-
-	if (sendto(sockfd, buffer, total_size, 0, (struct sockaddr *)&node_addr, sizeof(struct sockaddr_in)) < 0) {
-		if (error_msg) {
-			fprintf(stderr, "%s\n", error_msg);
+// Hops a lookup remembers as useless and routes around
+#define LOOKUP_MAX_DEAD 16
+
+// Redundant walks for one key, the first to resolve it answers
+struct find_successor_group {
+	int walks;              // Still running
+	int done;               // Callback already ran
+	int requests;           // Sent by all walks together
+	uint64_t started_us;    // Monotonic
+	uint64_t trace_id;      // 0 unless sampled for tracing
+	find_successor_callback callback;
+	void *arg;
+};
+
+// Outstanding iterative lookup, owned by the RPC callbacks until it resolves
+struct find_successor_state {
+	uint64_t id;
+	Node n_bar;
+	int probing;            // n_bar is the cached owner, asked to answer for itself
+	int retried;            // n_bar already got a second chance
+	int hops;
+	uint64_t deadline;      // Monotonic ms
+	size_t n_dead;
+	Node dead[LOOKUP_MAX_DEAD]; // Did not answer, or only pointed at hops that did not
+	struct find_successor_group *group;
+};
+
+// Walks and groups are recycled, as many are kept as can have a request pending
+static struct pool walk_pool = POOL_INIT(sizeof(struct find_successor_state), RPC_MAX_PENDING);
+static struct pool group_pool = POOL_INIT(sizeof(struct find_successor_group), RPC_MAX_PENDING);
+
+// Most keys carried by one FindSuccessorsRequest, keeps it well inside a datagram
+#define MAX_BATCH_KEYS 256
+
+// Outstanding batched lookup, every key walks the ring independently
+struct find_successors_state {
+	size_t n_keys;
+	uint64_t *keys;
+	Node *n_bar;            // Hop each unresolved key is waiting on
+	Node *nodes;            // Owners of resolved keys
+	Node **results;         // Into nodes, NULL for failed keys
+	unsigned char *resolved;
+	uint8_t *hops;          // Replies each key has been through, bounded by --hops
+	uint64_t deadline;      // Monotonic, unresolved keys fail from then on
+	size_t remaining;
+	find_successors_callback callback;
+	void *arg;
+};
+
+// One FindSuccessorsRequest in flight, covering the keys at indices
+struct find_successors_hop {
+	struct find_successors_state *state;
+	Node target;
+	size_t n_indices;
+	size_t indices[];
+};
+
+// Key of a batch that left it for a lookup of its own
+struct find_successors_key {
+	struct find_successors_state *state;
+	size_t index;
+};
+
+// Maintenance rounds still waiting on replies, at most one of each runs at a time
+int stabilize_in_flight = 0;
+int fix_fingers_in_flight = 0;
+
+// Cost of the lookup whose callback is running, see find_successor_cost()
+static int answer_hops = 0;
+static int answer_requests = 0;
+
+static void find_successor_step(struct find_successor_state *state);
+
+uint64_t successor_list_digest(const Node *list, size_t n) {
+	uint64_t digest = 0xCBF29CE484222325ULL;
+	for (size_t i = 0; i < n; ++i) {
+		uint64_t words[2] = {list[i].key, (uint64_t)list[i].address << 16 | (uint16_t)list[i].port};
+		for (int j = 0; j < 2; ++j) {
+			digest = (digest ^ words[j]) * 0x100000001B3ULL;
+			digest ^= digest >> 29;
 		}
-		perror("sendto()");
-		exit(1);
 	}
+	return digest;
 }
 
-/**
- * @brief Waits for a specific Chord protocol message response with timeout.
- * 
- * This helper function polls the socket for incoming messages and processes them
- * until either the expected message type is received or a timeout occurs. The function
- * uses select() to efficiently wait for socket data availability with a 1-second timeout
- * per iteration, and continues polling for up to 1 second total.
- * 
- * @param process_msg_param An integer parameter passed to process_chord_msg() to
- *                          identify the context or message type being processed.
- *                          This is used internally by the message processing logic.
- * @param expected_type The expected ChordMessage__MsgCase type that indicates the
- *                     desired response message type. The function will continue
- *                     polling until a message of this type is received.
- * 
- * @return MessageResponse The response message received. If the expected message type
- *                         is received, response.type will match expected_type. If a
- *                         timeout occurs or an error happens, response.type will be
- *                         CHORD_MESSAGE__MSG__NOT_SET or another value, and the caller
- *                         should check response.type to determine if the expected
- *                         message was received.
- * 
- * @note This function uses the global sockfd variable for the socket file descriptor.
- *       The function implements a timeout mechanism: it will poll for up to 1 second
- *       total, checking for socket data availability every 1 second using select().
- *       If select() fails, the function breaks out of the loop and returns the current
- *       response (which will have type CHORD_MESSAGE__MSG__NOT_SET if no message was
- *       received).
- * 
- * @warning The function may return a response with a type different from expected_type
- *          if a timeout occurs or an error happens. Callers must check response.type
- *          to verify that the expected message was actually received before using
- *          the response data.
- */
-static MessageResponse wait_for_response(int process_msg_param, ChordMessage__MsgCase expected_type) {
-	time_t currTime = time(NULL);
-	time_t timeoutTime = time(NULL) + 1;
-
-	MessageResponse response = {.type = CHORD_MESSAGE__MSG__NOT_SET};
-	do {
-		fd_set readfds;
-		FD_ZERO(&readfds);
-		FD_SET(sockfd, &readfds);
-
-		struct timeval timeout;
-		timeout.tv_sec = 1;
-		timeout.tv_usec = 0;
-
-		int ret = select(sockfd + 1, &readfds, NULL, NULL, &timeout);
-
-		if (ret < 0) {
-			perror("Select error");
-			break;
-		} else if (ret > 0 && FD_ISSET(sockfd, &readfds)) {
-			response = process_chord_msg(process_msg_param);
-		}
+// Successor's predecessor, if it is closer to us, becomes our successor
+static int adopt_predecessor(const Node *node) {
+	if (node->key != 0 && element_of(node->key, hash, successor.key, 0)) {
+		successor = *node;
+		successor_list[0] = successor;
+		return 1;
+	}
+	return 0;
+}
 
-		currTime = time(NULL);
-	} while (currTime < timeoutTime && response.type != expected_type);
+static void stabilize_reply(MessageResponse *response, void *arg) {
+	(void)arg;
 
-	return response;
+	if (response->type == CHORD_MESSAGE__MSG_GET_PREDECESSOR_RESPONSE) {
+		adopt_predecessor(&response->node);
+	}
+
+	notify();
+	fix_successor_list();
 }
 
-/**
- * @brief Packs a ChordMessage into a network-ready buffer.
- * 
- * This helper function takes a ChordMessage structure, calculates its packed size,
- * allocates a buffer with space for the message length prefix, converts the length
- * to network byte order, and packs the message into the buffer. The buffer includes
- * a 64-bit length prefix followed by the packed message data.
- * 
- * @param msg Pointer to the ChordMessage structure to pack. The message must be
- *            properly initialized with all required fields set before calling
- *            this function.
- * @param total_size Output parameter that will be set to the total size of the
- *                   allocated buffer (including the length prefix).
- * 
- * @return uint8_t* Pointer to the allocated buffer containing the packed message.
- *                  The buffer contains:
- *                  - First 8 bytes: message length in network byte order
- *                  - Remaining bytes: the packed ChordMessage data
- *                  The caller is responsible for freeing this buffer with free().
- * 
- * @note The function allocates memory using malloc(). The caller must free the
- *       returned buffer to avoid memory leaks.
- * 
- * @warning If memory allocation fails, malloc() will return NULL and the function
- *          will return NULL. Callers should check for NULL return values before
- *          using the buffer.
- */
-static uint8_t *pack_chord_message(ChordMessage *msg, size_t *total_size) {
-	uint64_t msg_len = chord_message__get_packed_size(msg);
-	
-	*total_size = sizeof(uint64_t) + msg_len;
-	uint8_t *buffer = malloc(*total_size);
-	if (!buffer) {
-		return NULL;
+static void stabilize_exchange_reply(MessageResponse *response, void *arg) {
+	(void)arg;
+
+	if (response->type != CHORD_MESSAGE__MSG_STABILIZE_RESPONSE) {
+		// Silent while heard from otherwise, it may have been replaced by a
+		// node without the exchange, so the next round takes three messages
+		rpc_forget_features(successor.address, successor.port, WIRE_FEATURE_STABILIZE);
+		stabilize_in_flight = 0;
+
+		// Dead, drop it and stabilize with the next entry right away
+		if (peer_status(successor.address, successor.port) != PEER_ALIVE && chord_args.num_successors > 1
+			&& successor_list[1].key != 0) {
+			memmove(successor_list, successor_list + 1, sizeof(Node) * (chord_args.num_successors - 1));
+			successor_list[chord_args.num_successors - 1] = (Node) NODE__INIT;
+			successor = successor_list[0];
+			stabilize();
+		}
+		return;
+	}
+
+	const Node old_successor = successor;
+	int moved = adopt_predecessor(&response->node);
+	size_t n = chord_args.num_successors;
+
+	// Unless the list we hold matched, the old successor's own goes behind it
+	if (!response->message->stabilize_response->unchanged) {
+		for (size_t i = 0; i + 1 < n; ++i) {
+			successor_list[i + 1] = i < response->n_successors ? response->successors[i] : (Node) NODE__INIT;
+		}
 	}
-	
-	uint64_t networkLen = htobe64(msg_len);
-	memcpy(buffer, &networkLen, sizeof(networkLen));
-	chord_message__pack(msg, buffer + sizeof(networkLen));
-	
-	return buffer;
-}
 
+	// A new successor goes in front of the old one
+	if (moved && n > 1) {
+		memmove(successor_list + 2, successor_list + 1, sizeof(Node) * (n - 2));
+		successor_list[1] = old_successor;
+	}
 
-// help functions are provided above, you may use them in the following functions
-// but you should not modify them
+	stabilize_in_flight = 0;
+	if (moved) {
+		notify(); // The new successor learns of us now rather than next round
+	}
+}
 
 void stabilize() {
-    // TODO:
     // Ask successor for its predecessor, update if necessary, and notify
-	GetPredecessorRequest request = GET_PREDECESSOR_REQUEST__INIT;
-	ChordMessage msg = CHORD_MESSAGE__INIT;
-	MessageResponse response;
-	size_t size;
-	uint8_t* buffer;
+	if (stabilize_in_flight) {
+		return;
+	}
 
+	// Skip a successor that has been silent for far longer than it ever was
+	if (successor.key != hash && chord_args.num_successors > 1 && successor_list[1].key != 0
+		&& peer_status(successor.address, successor.port) == PEER_FAILED) {
+		successor = successor_list[1];
+	}
+
+	ChordMessage msg = CHORD_MESSAGE__INIT;
 	msg.version = 417;
+
+	// In one exchange when the successor is known to take it
+	if (successor.key != hash && (rpc_peer_features(successor.address, successor.port) & WIRE_FEATURE_STABILIZE)) {
+		StabilizeRequest request = STABILIZE_REQUEST__INIT;
+		request.node = &self;
+		request.successors_digest = successor_list_digest(successor_list + 1, chord_args.num_successors - 1);
+
+		msg.stabilize_request = &request;
+		msg.msg_case = CHORD_MESSAGE__MSG_STABILIZE_REQUEST;
+
+		if (rpc_call(&successor, &msg, CHORD_MESSAGE__MSG_STABILIZE_RESPONSE, stabilize_exchange_reply, NULL) == 0) {
+			stabilize_in_flight = 1;
+			stats_add(STATS_STABILIZE_ROUNDS, 1);
+		}
+		return;
+	}
+
+	GetPredecessorRequest request = GET_PREDECESSOR_REQUEST__INIT;
 	msg.get_predecessor_request = &request;
 	msg.msg_case = CHORD_MESSAGE__MSG_GET_PREDECESSOR_REQUEST;
 
-	buffer = pack_chord_message(&msg, &size);
-	send_to_node(&successor, buffer, size, "error sending predecessor");
-	response = wait_for_response(2, CHORD_MESSAGE__MSG_GET_PREDECESSOR_RESPONSE);
+	if (rpc_call(&successor, &msg, CHORD_MESSAGE__MSG_GET_PREDECESSOR_RESPONSE, stabilize_reply, NULL) == 0) {
+		stabilize_in_flight = 1;
+		stats_add(STATS_STABILIZE_ROUNDS, 1);
+	}
+}
+
+static void request_successor_list(int succ_index);
+
+static void successor_list_reply(MessageResponse *resp, void *arg) {
+	int succ_index = (int)(intptr_t)arg;
+
+	if (resp->type == CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_RESPONSE) {
+		// Successor first, then as many of its successors as fit, updated in place
+		size_t num_entries = resp->n_successors;
+		if (num_entries > (size_t)chord_args.num_successors - 1) {
+			num_entries = chord_args.num_successors - 1;
+		}
+
+		successor_list[0] = successor;
+		for (size_t i = 0; i < num_entries; i++) {
+			successor_list[i + 1] = resp->successors[i];
+		}
+		for (size_t i = num_entries + 1; i < (size_t)chord_args.num_successors; i++) {
+			successor_list[i] = (Node) NODE__INIT;
+		}
 
-	if(response.type == CHORD_MESSAGE__MSG_GET_PREDECESSOR_RESPONSE
-		&& response.node.key != 0 && element_of(response.node.key, hash, successor.key, 0) ) { 
-			successor = response.node;
-			successor_list[0] = successor;
+		stabilize_in_flight = 0;
+		return;
 	}
 
-	notify();
-	fix_successor_list();
-	free(buffer);
+	// A successor heard from on schedule just lost this reply, ask again next round
+	if (peer_status(successor.address, successor.port) == PEER_ALIVE) {
+		stabilize_in_flight = 0;
+		return;
+	}
 
+	// Successor did not answer, fail over to the next live entry
+	succ_index++;
+	if (succ_index >= chord_args.num_successors || successor_list[succ_index].key == 0) {
+		stabilize_in_flight = 0;
+		return;
+	}
 
+	successor = successor_list[succ_index];
+	request_successor_list(succ_index);
 }
 
-void fix_successor_list() {
-	// // TODO:
-    // // 1) If id in (n, successor], return successor
-    // // 2) Otherwise forward request to closest preceding node
+static void request_successor_list(int succ_index) {
+	GetSuccessorListRequest req = GET_SUCCESSOR_LIST_REQUEST__INIT;
 
-	// GetSuccessorListRequest req = GET_SUCCESSOR_LIST_REQUEST__INIT;
+	ChordMessage msg = CHORD_MESSAGE__INIT;
+	msg.version = 417;
+	msg.get_successor_list_request = &req;
+	msg.msg_case = CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_REQUEST;
 
+	if (rpc_call(&successor, &msg, CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_RESPONSE,
+	             successor_list_reply, (void *)(intptr_t)succ_index) != 0) {
+		stabilize_in_flight = 0;
+	}
+}
 
+void fix_successor_list() {
+	request_successor_list(0);
+}
 
-	// ChordMessage msg = CHORD_MESSAGE__INIT;
+// Finger being refreshed, waiting on the successor list of the interval's first node
+struct fix_finger_state {
+	int index;
+	Node first;
+};
+
+// Finger i may be any node in [n + 2^i, n + 2^(i+1))
+static int in_finger_interval(uint64_t key, int index) {
+	uint64_t start = hash + ((uint64_t)1 << index);
+	uint64_t end = index + 1 < M ? hash + ((uint64_t)1 << (index + 1)) : hash;
+	return element_of(key, start - 1, end - 1, 1);
+}
 
-	// msg.version = 417;
+/**
+ * @brief Stores a refreshed finger and ends the refresh round.
+ *
+ * If the entry it replaces was empty or stale the table is still catching
+ * up with the ring, so the next round starts right away instead of waiting
+ * for the period. Swapping one valid finger for a closer one does not.
+ */
+static void set_finger(int index, const Node *node) {
+	Node *old = &finger_table[index];
+	int stale = old->key == 0 || (old->key != node->key && !in_finger_interval(old->key, index));
 
-	// msg.get_successor_list_request = &req;
+	*old = *node;
+	fix_fingers_in_flight = 0;
 
-	// msg.msg_case = CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_REQUEST;
+	if (stale) {
+		fix_fingers();
+	}
+}
 
+static void ping_reply(MessageResponse *resp, void *arg) {
+	(void)resp;
+	(void)arg;
+	// Only sent to measure the round trip, the RPC layer records it
+}
 
+static void ping(Node *node) {
+	CheckPredecessorRequest req = CHECK_PREDECESSOR_REQUEST__INIT;
+	ChordMessage msg = CHORD_MESSAGE__INIT;
+	msg.version = 417;
+	msg.check_predecessor_request = &req;
+	msg.msg_case = CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_REQUEST;
 
-	// uint64_t msg_len = 0;
+	rpc_call(node, &msg, CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_RESPONSE, ping_reply, NULL);
+}
 
+static void fix_finger_candidates(MessageResponse *resp, void *arg) {
+	struct fix_finger_state *state = arg;
 
+	// Any node in the interval is a valid finger, the nearest one is the cheapest hop
+	Node best = state->first;
+	uint64_t best_rtt = peer_rtt(best.address, best.port);
 
-	// uint8_t* buffer = pack_chord_message(&msg, &msg_len);
+	if (resp->type == CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_RESPONSE && best_rtt != 0) {
+		for (size_t i = 0; i < resp->n_successors; ++i) {
+			Node *candidate = &resp->successors[i];
+			if (candidate->key == 0 || !in_finger_interval(candidate->key, state->index)) {
+				break; // The list is in ring order, nothing later is in the interval either
+			}
 
-	// send_to_node(&successor, buffer, msg_len, NULL);
+			// Unmeasured candidates are pinged now and compete from the next round on
+			uint64_t rtt = peer_rtt(candidate->address, candidate->port);
+			if (rtt == 0) {
+				ping(candidate);
+			} else if (rtt < best_rtt) {
+				best = *candidate;
+				best_rtt = rtt;
+			}
+		}
+	}
 
-	// MessageResponse resp = wait_for_response(3, CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_RESPONSE);
+	int index = state->index;
+	free(state);
+	set_finger(index, &best);
+}
 
+static void fix_fingers_done(Node *node, void *arg) {
+	int index = (intptr_t)arg;
 
+	if (!node) {
+		fix_fingers_in_flight = 0;
+		return;
+	}
 
-	// if (resp.type == CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_RESPONSE) {
+	// A successor outside the interval is the only choice, so is one of our own
+	if (!in_finger_interval(node->key, index) || vnode_is_local(node)) {
+		set_finger(index, node);
+		return;
+	}
 
-	// 	size_t num_entries = resp.n_successors;
+	// Proximity neighbour selection among the interval's first nodes, which
+	// the interval's successor knows as its successor list
+	struct fix_finger_state *state = malloc(sizeof(*state));
+	state->index = index;
+	state->first = *node;
 
+	GetSuccessorListRequest req = GET_SUCCESSOR_LIST_REQUEST__INIT;
+	ChordMessage msg = CHORD_MESSAGE__INIT;
+	msg.version = 417;
+	msg.get_successor_list_request = &req;
+	msg.msg_case = CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_REQUEST;
 
+	if (rpc_call(node, &msg, CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_RESPONSE, fix_finger_candidates, state) != 0) {
+		free(state);
+		set_finger(index, node);
+	}
+}
 
-	// 	// Getting rid of original list
+void fix_fingers() {
+    // Periodically rebuild finger[i]
+	if (fix_fingers_in_flight) {
+		return;
+	}
+	stats_add(STATS_FIX_FINGERS_ROUNDS, 1);
 
-	// 	if (successor_list)
+	// Fingers our successor covers need no lookup, move on to the first that does
+	for (int i = 0; i < M; ++i) {
+		fixIndex = fixIndex + 1;
 
-	// 		free(successor_list);
+		if (fixIndex >= M) {
+			fixIndex = 0;
+		}
 
+		uint64_t start = hash + ((uint64_t)1 << fixIndex);
+		if (!element_of(start, hash, successor.key, 1)) {
+			fix_fingers_in_flight = 1;
+			find_successor(start, fix_fingers_done, (void *)(intptr_t)fixIndex);
+			return;
+		}
+		finger_table[fixIndex] = successor;
+	}
+}
 
+static void fix_all_fingers_done(size_t n_keys, uint64_t *keys, Node **nodes, void *arg) {
+	(void)keys;
+	(void)arg;
 
-	// 	// Creating new one
+	int failed = 0;
+	for (size_t i = 0; i < n_keys; ++i) {
+		if (nodes[i]) {
+			finger_table[i] = *nodes[i];
+		} else {
+			failed = 1;
+		}
+	}
+	fix_fingers_in_flight = 0;
 
-	// 	successor_list = malloc(sizeof(Node) * (num_entries + 1));
+	// Keys the batch gave up on are left to the periodic refresh, which
+	// keeps going for as long as it finds stale entries
+	if (failed) {
+		fix_fingers();
+	}
+}
 
-	// 	successor_list[0] = successor; // Adding succesor to the start
+void fix_all_fingers() {
+	if (fix_fingers_in_flight) {
+		return;
+	}
 
+	// One batched lookup, keys sharing a next hop travel in the same request
+	uint64_t starts[M];
+	for (int i = 0; i < M; ++i) {
+		starts[i] = hash + ((uint64_t)1 << i);
+	}
 
+	// The batch is bounded, its callback always ends the round
+	fix_fingers_in_flight = 1;
+	find_successors(starts, M, fix_all_fingers_done, NULL);
+}
 
-	// 	// Filling the rest out with successor node's succesors
+// Runs a lookup's callback with its cost on record
+static void answer(uint64_t id, Node *node, int hops, int requests, uint64_t started_us, uint64_t trace_id,
+                   find_successor_callback callback, void *arg) {
+	trace_log(trace_id, node ? TRACE_LOOKUP_DONE : TRACE_LOOKUP_FAILED, hops, id, node);
+
+	stats_add(STATS_LOOKUPS, 1);
+	if (node) {
+		stats_observe(STATS_LOOKUP_LATENCY_US, monotonic_us() - started_us);
+		stats_observe(STATS_LOOKUP_HOPS, hops);
+	} else {
+		stats_add(STATS_LOOKUPS_FAILED, 1);
+	}
 
-	// 	for (size_t i = 0; i < num_entries; i++) {
+	answer_hops = hops;
+	answer_requests = requests;
+	callback(node, arg);
+}
 
-	// 		successor_list[i + 1] = resp.successors[i];
+// Ends one walk, the group answers with the first node found or NULL once every walk failed
+static void find_successor_finish(struct find_successor_state *state, Node *node) {
+	struct find_successor_group *group = state->group;
 
-	// 	}
+	if (node && !group->done) {
+		group->done = 1;
+		answer(state->id, node, state->hops, group->requests, group->started_us, group->trace_id,
+		       group->callback, group->arg);
+	}
+	if (--group->walks == 0) {
+		if (!group->done) {
+			answer(state->id, NULL, state->hops, group->requests, group->started_us, group->trace_id,
+			       group->callback, group->arg);
+		}
+		pool_put(&group_pool, group);
+	}
+	pool_put(&walk_pool, state);
+}
 
-	// }
+static int is_dead_hop(struct find_successor_state *state, const Node *node) {
+	for (size_t i = 0; i < state->n_dead; ++i) {
+		if (state->dead[i].key == node->key && state->dead[i].address == node->address
+			&& state->dead[i].port == node->port) {
+			return 1;
+		}
+	}
+	return 0;
+}
 
-	int succ_index = 0;
+static void mark_dead_hop(struct find_successor_state *state, const Node *node) {
+	if (is_dead_hop(state, node)) {
+		return;
+	}
 
-	while (1) {
-		GetSuccessorListRequest req = GET_SUCCESSOR_LIST_REQUEST__INIT;
+	// Oldest entry makes room, the walk has long moved past it
+	if (state->n_dead == LOOKUP_MAX_DEAD) {
+		memmove(state->dead, state->dead + 1, sizeof(Node) * (LOOKUP_MAX_DEAD - 1));
+		state->n_dead--;
+	}
+	state->dead[state->n_dead++] = *node;
+}
 
-		ChordMessage msg = CHORD_MESSAGE__INIT;
-		msg.version = 417;
-		msg.get_successor_list_request = &req;
-		msg.msg_case = CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_REQUEST;
+// Gives up on n_bar and picks our own best candidate for the key that is
+// not known to be useless
+static void route_around(struct find_successor_state *state) {
+	mark_dead_hop(state, &state->n_bar);
 
-		uint64_t msg_len = 0;
+	Node next = closest_preceding_node(state->id);
+	while (next.key != hash && is_dead_hop(state, &next)) {
+		next = closest_preceding_node(next.key);
+	}
 
-		uint8_t* buffer = pack_chord_message(&msg, &msg_len);
-		send_to_node(&successor, buffer, msg_len, NULL);
-		MessageResponse resp = wait_for_response(3, CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_RESPONSE);
+	// Nothing of ours precedes it, creep along the successor list instead
+	if (next.key == hash) {
+		next = successor;
+		for (int i = 0; i < chord_args.num_successors && is_dead_hop(state, &next); ++i) {
+			if (successor_list[i].key != 0) {
+				next = successor_list[i];
+			}
+		}
+	}
 
-		free(buffer);
+	state->n_bar = next;
+	state->retried = 0;
+}
 
-		if (resp.type == CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_RESPONSE) {
-			size_t num_entries = resp.n_successors;
+static void find_successor_reply(MessageResponse *resp, void *arg) {
+	struct find_successor_state *state = arg;
 
-			// Getting rid of original list
-			if (successor_list)
-				free(successor_list);
+	trace_log(state->group->trace_id, resp->type == CHORD_MESSAGE__MSG_FIND_SUCCESSOR_RESPONSE ? TRACE_HOP_REPLY
+	          : resp->type == CHORD_MESSAGE__MSG_BUSY_RESPONSE ? TRACE_HOP_BUSY
+	          : TRACE_HOP_TIMEOUT, state->hops - 1, state->id, &state->n_bar);
 
-			// Creating new one
-			successor_list = malloc(sizeof(Node) * (num_entries + 1));
-			successor_list[0] = successor; // Adding succesor to the start
+	if (state->group->done) { // Another walk got there first
+		find_successor_finish(state, NULL);
+		return;
+	}
 
-			// Filling the rest out with successor node's succesors
-			for (size_t i = 0; i < num_entries; i++) {
-				successor_list[i + 1] = resp.successors[i];
-			}
+	if (resp->type == CHORD_MESSAGE__MSG_FIND_SUCCESSOR_RESPONSE) {
+		FindSuccessorResponse *successorResponse = resp->message->find_successor_response;
+		int keyed = successorResponse->has_key && successorResponse->key == state->id;
 
+		// The cached owner gave the key up, its answer is still a hop towards it
+		if (state->probing && !keyed) {
+			location_cache_invalidate(state->id);
+		}
+		state->probing = 0;
+
+		// Routed lookups and probes answer with the key they resolved, and that
+		// answer is final. An iterative hop answering with its successor vouches
+		// for everything up to it.
+		if (keyed || element_of(state->id, state->n_bar.key, resp->node.key, 1)) {
+			location_cache_insert(keyed ? state->id - 1 : state->n_bar.key, &resp->node);
+			find_successor_finish(state, &resp->node);
 			return;
+		}
+
+		// Pointed at a hop that already failed us, its table is no use to this walk either
+		if (is_dead_hop(state, &resp->node)) {
+			route_around(state);
 		} else {
-			succ_index++;
-			successor = successor_list[succ_index];
+			state->n_bar = resp->node;
+			state->retried = 0;
 		}
 	}
+	else if (resp->type == CHORD_MESSAGE__MSG_BUSY_RESPONSE) {
+		// Alive but backlogged, another finger gets the request and the hop
+		// keeps its standing with the failure detector
+		state->probing = 0;
+		route_around(state);
+	}
+	else if (state->probing) {
+		// Cached owner is gone, walk the ring as if it had never been cached
+		location_cache_invalidate(state->id);
+		state->probing = 0;
+		state->n_bar = closest_preceding_node(state->id);
+	}
+	else if (!state->retried && peer_status(state->n_bar.address, state->n_bar.port) == PEER_ALIVE) {
+		// A hop heard from on schedule most likely lost this one datagram
+		state->retried = 1;
+	}
+	else {
+		route_around(state);
+	}
+
+	find_successor_step(state);
 }
 
-void fix_fingers() {
-    // TODO:
-    // Periodically rebuild finger[i]
-	fixIndex = fixIndex + 1;
-	
-    if (fixIndex >= M) {
-        fixIndex = 0;
-    }
-    finger_table[fixIndex] = find_successor(hash + ((uint64_t)1 << fixIndex));
-	
+static void find_successor_step(struct find_successor_state *state) {
+	// Bounded in time and hops, a lookup that cannot finish reports failure
+	if (state->hops++ >= chord_args.lookup_hops || monotonic_ms() >= state->deadline) {
+		find_successor_finish(state, NULL);
+		return;
+	}
+
+	FindSuccessorRequest req = FIND_SUCCESSOR_REQUEST__INIT;
+	req.key = state->id;
+	if (state->probing) {
+		req.has_probe = 1;
+		req.probe = 1;
+	} else if (chord_args.lookup_mode != LOOKUP_ITERATIVE) {
+		req.requester = &self; // Let the ring route it instead of walking every hop ourselves
+	}
+	ChordMessage msg = CHORD_MESSAGE__INIT;
+	msg.version = 417;
+	msg.find_successor_request = &req;
+	msg.msg_case = CHORD_MESSAGE__MSG_FIND_SUCCESSOR_REQUEST;
+
+	TraceContext trace;
+	if (state->group->trace_id) {
+		trace_attach(&msg, &trace, state->group->trace_id, state->hops - 1);
+	}
+
+	if (rpc_call(&state->n_bar, &msg, CHORD_MESSAGE__MSG_FIND_SUCCESSOR_RESPONSE, find_successor_reply, state) != 0) {
+		find_successor_finish(state, NULL);
+		return;
+	}
+	state->group->requests++;
+	trace_log(state->group->trace_id, TRACE_HOP_SENT, state->hops - 1, state->id, &state->n_bar);
+}
+
+static void start_walk(struct find_successor_group *group, uint64_t id, Node *first, int probing) {
+	struct find_successor_state *state = pool_get(&walk_pool);
+	if (!state) {
+		return; // The group's other walks still count, with none it fails
+	}
+	state->id = id;
+	state->n_bar = *first;
+	state->probing = probing;
+	state->retried = 0;
+	state->hops = 0;
+	state->deadline = monotonic_ms() + chord_args.lookup_deadline;
+	state->n_dead = 0;
+	state->group = group;
+
+	group->walks++;
+	find_successor_step(state);
 }
 
-Node find_successor(uint64_t id) {	
+void find_successor_parallel(uint64_t id, int alpha, find_successor_callback callback, void *arg) {
     // 1) If id in (n, successor], return successor
 	if (element_of(id, hash, successor.key, 1)) {
-		return successor;
+		Node succ = successor;
+		answer(id, &succ, 0, 0, monotonic_us(), 0, callback, arg);
+		return;
 	}
-    // 2) Otherwise forward request to closest preceding node
-	else {
-		Node n_bar = closest_preceding_node(id);
-
-		while (1) {
-			FindSuccessorRequest req = FIND_SUCCESSOR_REQUEST__INIT;
-			req.key = id;
-			ChordMessage msg = CHORD_MESSAGE__INIT;
-			msg.version = 417;
-			msg.find_successor_request = &req;
-			msg.msg_case = CHORD_MESSAGE__MSG_FIND_SUCCESSOR_REQUEST;
-
-			uint64_t msg_len = 0;
-
-			uint8_t* buffer = pack_chord_message(&msg, &msg_len);
-			send_to_node(&n_bar, buffer, msg_len, NULL);
-			MessageResponse resp = wait_for_response(4, CHORD_MESSAGE__MSG_FIND_SUCCESSOR_RESPONSE);
-			
-			free(buffer);
-
-			if (resp.type == CHORD_MESSAGE__MSG_FIND_SUCCESSOR_RESPONSE) {
-				if (element_of(id, n_bar.key, resp.node.key, 1)) {
-					return resp.node; 
-				}
-				else {
-					n_bar = resp.node;
-				}
+
+	struct find_successor_group *group = pool_get(&group_pool);
+	if (!group) {
+		answer(id, NULL, 0, 0, monotonic_us(), 0, callback, arg);
+		return;
+	}
+	*group = (struct find_successor_group) {.started_us = monotonic_us(), .trace_id = trace_sample(),
+	                                        .callback = callback, .arg = arg};
+	trace_log(group->trace_id, TRACE_LOOKUP_START, 0, id, NULL);
+
+	// Walks are counted in before any of them starts, one failing early must not end the group
+	group->walks = 1;
+
+	// 2) Ask a recently resolved owner directly, one round trip if it still holds id
+	Node first;
+	int probing = location_cache_lookup(id, &first);
+
+	// 3) Otherwise forward request to closest preceding node, one hop per reply.
+	// Further walks start from the next best candidates, so no two share a first hop.
+	Node next = closest_preceding_node(id);
+	if (!probing) {
+		first = next;
+		next = closest_preceding_node(next.key);
+	}
+	start_walk(group, id, &first, probing);
+
+	for (int i = 1; i < alpha && next.key != hash && !group->done; ++i) {
+		Node start = next;
+		next = closest_preceding_node(next.key);
+		start_walk(group, id, &start, 0);
+	}
+
+	if (--group->walks == 0) {
+		if (!group->done) {
+			answer(id, NULL, 0, group->requests, group->started_us, group->trace_id, callback, arg);
+		}
+		pool_put(&group_pool, group);
+	}
+}
+
+void find_successor_cost(int *hops, int *requests) {
+	*hops = answer_hops;
+	*requests = answer_requests;
+}
+
+void find_successor(uint64_t id, find_successor_callback callback, void *arg) {
+	find_successor_parallel(id, 1, callback, arg);
+}
+
+static void resolve_key(struct find_successors_state *state, size_t index, Node *node) {
+	if (node) {
+		state->nodes[index] = *node;
+		state->results[index] = &state->nodes[index];
+	}
+	state->resolved[index] = 1;
+	state->remaining--;
+}
+
+// Runs the callback and frees the batch once every key is resolved
+static void find_successors_finish(struct find_successors_state *state) {
+	if (state->remaining > 0) {
+		return;
+	}
+
+	state->callback(state->n_keys, state->keys, state->results, state->arg);
+
+	free(state->keys);
+	free(state->n_bar);
+	free(state->nodes);
+	free(state->results);
+	free(state->resolved);
+	free(state->hops);
+	free(state);
+}
+
+static void find_successors_reply(MessageResponse *resp, void *arg);
+
+static void send_successors_hop(struct find_successors_state *state, Node *target, size_t *indices, size_t n_indices) {
+	struct find_successors_hop *hop = malloc(sizeof(*hop) + sizeof(size_t) * n_indices);
+	hop->state = state;
+	hop->target = *target;
+	hop->n_indices = n_indices;
+	memcpy(hop->indices, indices, sizeof(size_t) * n_indices);
+
+	uint64_t *keys = malloc(sizeof(uint64_t) * n_indices);
+	for (size_t i = 0; i < n_indices; ++i) {
+		keys[i] = state->keys[indices[i]];
+	}
+
+	FindSuccessorsRequest req = FIND_SUCCESSORS_REQUEST__INIT;
+	req.n_keys = n_indices;
+	req.keys = keys;
+	ChordMessage msg = CHORD_MESSAGE__INIT;
+	msg.version = 417;
+	msg.find_successors_request = &req;
+	msg.msg_case = CHORD_MESSAGE__MSG_FIND_SUCCESSORS_REQUEST;
+
+	if (rpc_call(target, &msg, CHORD_MESSAGE__MSG_FIND_SUCCESSORS_RESPONSE, find_successors_reply, hop) != 0) {
+		for (size_t i = 0; i < n_indices; ++i) {
+			resolve_key(state, indices[i], NULL);
+		}
+		free(hop);
+	}
+
+	free(keys);
+}
+
+// Sends the given keys on, one request per distinct next hop
+static void dispatch_successors(struct find_successors_state *state, size_t *indices, size_t n_indices) {
+	unsigned char *sent = calloc(n_indices, 1);
+	size_t *group = malloc(sizeof(size_t) * n_indices);
+
+	for (size_t i = 0; i < n_indices; ++i) {
+		if (sent[i]) {
+			continue;
+		}
+
+		Node *target = &state->n_bar[indices[i]];
+		size_t n_group = 0;
+		for (size_t j = i; j < n_indices && n_group < MAX_BATCH_KEYS; ++j) {
+			Node *other = &state->n_bar[indices[j]];
+			if (!sent[j] && other->key == target->key
+				&& other->address == target->address && other->port == target->port) {
+				group[n_group++] = indices[j];
+				sent[j] = 1;
+			}
+		}
+
+		send_successors_hop(state, target, group, n_group);
+	}
+
+	free(group);
+	free(sent);
+}
+
+static void find_successors_key_done(Node *node, void *arg) {
+	struct find_successors_key *key = arg;
+	struct find_successors_state *state = key->state;
+
+	resolve_key(state, key->index, node);
+	free(key);
+	find_successors_finish(state);
+}
+
+/**
+ * @brief Hands the keys of a failed hop to lookups of their own.
+ *
+ * find_successor() routes around the hop and is bounded in time and hops,
+ * so every key is resolved or failed eventually.
+ */
+static void walk_keys_alone(struct find_successors_state *state, struct find_successors_hop *hop) {
+	state->remaining++; // Held until every walk is started, some may end at once
+	for (size_t i = 0; i < hop->n_indices; ++i) {
+		struct find_successors_key *key = malloc(sizeof(*key));
+		if (!key) {
+			resolve_key(state, hop->indices[i], NULL);
+			continue;
+		}
+		key->state = state;
+		key->index = hop->indices[i];
+		find_successor(state->keys[key->index], find_successors_key_done, key);
+	}
+	state->remaining--;
+}
+
+static void find_successors_reply(MessageResponse *resp, void *arg) {
+	struct find_successors_hop *hop = arg;
+	struct find_successors_state *state = hop->state;
+
+	FindSuccessorsResponse *successorsResponse = resp->type == CHORD_MESSAGE__MSG_FIND_SUCCESSORS_RESPONSE ?
+		resp->message->find_successors_response : NULL;
+
+	if (!successorsResponse || successorsResponse->n_nodes != hop->n_indices) {
+		// Timed out, busy or malformed, asking the hop again may never end
+		walk_keys_alone(state, hop);
+	} else {
+		size_t n_next = 0;
+		size_t *next = malloc(sizeof(size_t) * hop->n_indices);
+
+		for (size_t i = 0; i < hop->n_indices; ++i) {
+			size_t index = hop->indices[i];
+			Node *node = successorsResponse->nodes[i];
+
+			if (element_of(state->keys[index], state->n_bar[index].key, node->key, 1)) {
+				location_cache_insert(state->n_bar[index].key, node);
+				resolve_key(state, index, node);
+			} else if (++state->hops[index] >= chord_args.lookup_hops || monotonic_ms() >= state->deadline) {
+				resolve_key(state, index, NULL); // Same bounds as a single lookup
 			} else {
-				printf("Wrong Message Type!\n");
+				state->n_bar[index] = *node;
+				next[n_next++] = index;
 			}
 		}
+
+		dispatch_successors(state, next, n_next);
+		free(next);
 	}
+
+	free(hop);
+	find_successors_finish(state);
 }
 
-Node closest_preceding_node(uint64_t id) {
-    // TODO:
-    // Scan finger table for closest predecessor
-	for (int i = M - 1; i >= 0; i--) {
-        if (finger_table[i].key != 0 && element_of(finger_table[i].key, hash, id, 0)) {
-            return finger_table[i];
-        }
-    }
+void find_successors(uint64_t *keys, size_t n_keys, find_successors_callback callback, void *arg) {
+	struct find_successors_state *state = malloc(sizeof(*state));
+	state->n_keys = n_keys;
+	state->keys = malloc(sizeof(uint64_t) * n_keys);
+	memcpy(state->keys, keys, sizeof(uint64_t) * n_keys);
+	state->n_bar = malloc(sizeof(Node) * n_keys);
+	state->nodes = malloc(sizeof(Node) * n_keys);
+	state->results = calloc(n_keys, sizeof(Node *));
+	state->resolved = calloc(n_keys, 1);
+	state->hops = calloc(n_keys, 1);
+	state->deadline = monotonic_ms() + chord_args.lookup_deadline;
+	state->remaining = n_keys;
+	state->callback = callback;
+	state->arg = arg;
+
+	size_t n_remote = 0;
+	size_t *remote = malloc(sizeof(size_t) * n_keys);
+
+	for (size_t i = 0; i < n_keys; ++i) {
+		if (element_of(keys[i], hash, successor.key, 1)) {
+			resolve_key(state, i, &successor);
+		} else {
+			state->n_bar[i] = closest_preceding_node(keys[i]);
+			remote[n_remote++] = i;
+		}
+	}
 
-	return self;
+	dispatch_successors(state, remote, n_remote);
+	free(remote);
+	find_successors_finish(state);
 }
 
+Node closest_preceding_node(uint64_t id) {
+	return routing_closest_preceding_node(routing_current(), id);
+}
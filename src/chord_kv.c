@@ -0,0 +1,869 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <arpa/inet.h>
+
+#include "chord.h"
+#include "chord_arg_parser.h"
+#include "chord_handoff.h"
+#include "chord_impl.h"
+#include "chord_kv.h"
+#include "chord_peer.h"
+#include "chord_routing.h"
+#include "chord_rpc.h"
+#include "chord_timer.h"
+#include "chord_vnode.h"
+#include "chord.pb-c.h"
+
+// Grow once three quarters of the slots are taken, probe runs stay short
+#define KV_MAX_LOAD_NUM 3
+#define KV_MAX_LOAD_DEN 4
+
+// Open addressing table, a slot is free when item is NULL. The id is kept
+// beside the pointer so probes only touch the item on a likely match.
+struct kv_slot {
+	uint64_t id;
+	struct kv_item *item;
+};
+
+static struct kv_slot *slots = NULL;
+static size_t capacity = 0;
+static size_t count = 0;
+static uint64_t generation = 0;     // Bumped whenever entries change slots wholesale
+
+// Ids of one node's slice share their high bits, mix them all into the index
+static inline size_t home_slot(uint64_t id) {
+	return (size_t)((id * 0x9E3779B97F4A7C15ULL) >> 32) & (capacity - 1);
+}
+
+static int item_matches(const struct kv_slot *slot, uint64_t id, const uint8_t *key, size_t key_len) {
+	return slot->id == id && slot->item->key_len == key_len && memcmp(slot->item->data, key, key_len) == 0;
+}
+
+// Slot holding the key, or the free slot ending its probe sequence
+static size_t find_slot(uint64_t id, const uint8_t *key, size_t key_len) {
+	size_t i = home_slot(id);
+	while (slots[i].item && !item_matches(&slots[i], id, key, key_len)) {
+		i = (i + 1) & (capacity - 1);
+	}
+	return i;
+}
+
+static int resize(size_t new_capacity) {
+	struct kv_slot *new_slots = calloc(new_capacity, sizeof(struct kv_slot));
+	if (!new_slots) {
+		return -1;
+	}
+
+	struct kv_slot *old_slots = slots;
+	size_t old_capacity = capacity;
+	slots = new_slots;
+	capacity = new_capacity;
+	generation++;
+
+	for (size_t i = 0; i < old_capacity; ++i) {
+		if (old_slots[i].item) {
+			size_t j = home_slot(old_slots[i].id);
+			while (slots[j].item) {
+				j = (j + 1) & (capacity - 1);
+			}
+			slots[j] = old_slots[i];
+		}
+	}
+
+	free(old_slots);
+	return 0;
+}
+
+static int store(uint64_t id, const uint8_t *key, size_t key_len, const uint8_t *value, size_t value_len,
+                 uint64_t version, int deleted) {
+	if (!slots && resize(KV_INITIAL_CAPACITY) != 0) {
+		return -1;
+	}
+	if ((count + 1) * KV_MAX_LOAD_DEN > capacity * KV_MAX_LOAD_NUM && resize(capacity * 2) != 0) {
+		return -1;
+	}
+
+	struct kv_item *item = malloc(sizeof(*item) + key_len + value_len);
+	if (!item) {
+		return -1;
+	}
+	item->id = id;
+	item->version = version;
+	item->deleted = deleted;
+	item->key_len = key_len;
+	item->value_len = value_len;
+	memcpy(item->data, key, key_len);
+	if (value_len) {
+		memcpy(item->data + key_len, value, value_len);
+	}
+
+	size_t i = find_slot(id, key, key_len);
+	if (slots[i].item) {
+		free(slots[i].item);
+	} else {
+		count++;
+	}
+	slots[i].id = id;
+	slots[i].item = item;
+	return 0;
+}
+
+int kv_store_put(uint64_t id, const uint8_t *key, size_t key_len, const uint8_t *value, size_t value_len,
+                 uint64_t version) {
+	return store(id, key, key_len, value, value_len, version, 0);
+}
+
+int kv_store_tombstone(uint64_t id, const uint8_t *key, size_t key_len, uint64_t version) {
+	return store(id, key, key_len, NULL, 0, version, 1);
+}
+
+const struct kv_item *kv_store_get(uint64_t id, const uint8_t *key, size_t key_len) {
+	if (!slots) {
+		return NULL;
+	}
+	return slots[find_slot(id, key, key_len)].item;
+}
+
+int kv_store_delete(uint64_t id, const uint8_t *key, size_t key_len) {
+	if (!slots) {
+		return 0;
+	}
+
+	size_t hole = find_slot(id, key, key_len);
+	if (!slots[hole].item) {
+		return 0;
+	}
+	free(slots[hole].item);
+	slots[hole].item = NULL;
+	count--;
+
+	// Backward shift: pull later entries of the run into the hole unless that
+	// would move them before their home slot, so no tombstones are needed
+	size_t i = hole;
+	while (1) {
+		i = (i + 1) & (capacity - 1);
+		if (!slots[i].item) {
+			break;
+		}
+
+		size_t home = home_slot(slots[i].id);
+		if (((i - home) & (capacity - 1)) >= ((i - hole) & (capacity - 1))) {
+			slots[hole] = slots[i];
+			slots[i].item = NULL;
+			hole = i;
+		}
+	}
+
+	return 1;
+}
+
+size_t kv_store_count(void) {
+	return count;
+}
+
+size_t kv_store_capacity(void) {
+	return capacity;
+}
+
+uint64_t kv_store_generation(void) {
+	return generation;
+}
+
+const struct kv_item *kv_store_slot(size_t slot) {
+	return slot < capacity ? slots[slot].item : NULL;
+}
+
+void kv_store_clear(void) {
+	for (size_t i = 0; i < capacity; ++i) {
+		free(slots[i].item);
+	}
+	free(slots);
+	slots = NULL;
+	capacity = count = 0;
+	generation++;
+}
+
+// Versions carry the wall clock in ms above their low 16 bits, so a
+// tombstone's age is read off its version
+void kv_store_collect(void) {
+	static size_t cursor = 0;
+
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	uint64_t now = (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+
+	// A delete pulls a later entry into the current slot, which is then looked at again
+	for (int visited = 0; visited < KV_COLLECT_SLOTS && capacity > 0; ++visited) {
+		if (cursor >= capacity) {
+			cursor = 0;
+		}
+
+		const struct kv_item *item = slots[cursor].item;
+		if (item && item->deleted && (item->version >> 16) + KV_TOMBSTONE_TTL_MS < now) {
+			kv_store_delete(item->id, kv_item_key(item), item->key_len);
+		} else {
+			cursor++;
+		}
+	}
+}
+
+// An operation the owner runs against its own copy and its replicas
+struct kv_coord {
+	ChordMessage__MsgCase type;     // Put, get or delete request
+	uint64_t id;
+	uint8_t *key;
+	size_t key_len;
+	uint8_t *value;                 // Value written, or the newest value read
+	size_t value_len;
+	uint64_t version;
+	int found;
+	int acks;                       // Copies that succeeded, the owner's included
+	int needed;                     // Quorum
+	int outstanding;                // Replica RPCs in flight
+	int done;                       // Callback has run
+	kv_callback callback;
+	void *arg;
+};
+
+// One replica RPC of a coordinated operation
+struct kv_replica_call {
+	struct kv_coord *coord;
+	int counts;                     // Its ack counts towards the quorum
+};
+
+static int copy_bytes(uint8_t **dst, const uint8_t *src, size_t len) {
+	*dst = malloc(len ? len : 1);
+	if (!*dst) {
+		return -1;
+	}
+	if (len) {
+		memcpy(*dst, src, len);
+	}
+	return 0;
+}
+
+static void coord_complete(struct kv_coord *coord) {
+	if (!coord->done) {
+		if (coord->acks >= coord->needed) {
+			coord->done = 1;
+			if (coord->type == CHORD_MESSAGE__MSG_PUT_REQUEST || coord->found) {
+				coord->callback(KV_OK, coord->type == CHORD_MESSAGE__MSG_GET_REQUEST ? coord->value : NULL,
+				                coord->value_len, coord->arg);
+			} else {
+				coord->callback(KV_NOT_FOUND, NULL, 0, coord->arg);
+			}
+		} else if (coord->outstanding == 0) {
+			coord->done = 1;
+			coord->callback(KV_FAILED, NULL, 0, coord->arg);
+		}
+	}
+
+	// Writes keep replicating after the quorum answered
+	if (coord->outstanding == 0) {
+		free(coord->key);
+		free(coord->value);
+		free(coord);
+	}
+}
+
+static void replica_reply(MessageResponse *response, void *arg) {
+	struct kv_replica_call *call = arg;
+	struct kv_coord *coord = call->coord;
+	int counts = call->counts;
+	free(call);
+
+	coord->outstanding--;
+
+	if (response->type == CHORD_MESSAGE__MSG_GET_RESPONSE) {
+		GetResponse *getResponse = response->message->get_response;
+		uint64_t version = getResponse->has_version ? getResponse->version : 0;
+		coord->acks += counts;
+
+		// Newest copy wins, a tombstone as well as a value
+		if (version > coord->version || (getResponse->found && !coord->found && coord->version == 0)) {
+			uint8_t *value;
+			if (!getResponse->found) {
+				free(coord->value);
+				coord->value = NULL;
+				coord->value_len = 0;
+				coord->version = version;
+				coord->found = 0;
+			} else if (copy_bytes(&value, getResponse->value.data, getResponse->value.len) == 0) {
+				free(coord->value);
+				coord->value = value;
+				coord->value_len = getResponse->value.len;
+				coord->version = version;
+				coord->found = 1;
+			}
+		}
+	} else if (response->type == CHORD_MESSAGE__MSG_DELETE_RESPONSE) {
+		coord->acks += counts;
+		coord->found |= response->message->delete_response->found;
+	} else if (response->type == CHORD_MESSAGE__MSG_PUT_RESPONSE) {
+		coord->acks += counts;
+	}
+
+	coord_complete(coord);
+}
+
+static void send_to_replica(struct kv_coord *coord, Node *replica, int counts) {
+	ChordMessage msg = CHORD_MESSAGE__INIT;
+	msg.version = 417;
+	msg.msg_case = coord->type;
+
+	ProtobufCBinaryData key = {.len = coord->key_len, .data = coord->key};
+	ChordMessage__MsgCase expected;
+
+	PutRequest putRequest = PUT_REQUEST__INIT;
+	GetRequest getRequest = GET_REQUEST__INIT;
+	DeleteRequest deleteRequest = DELETE_REQUEST__INIT;
+
+	if (coord->type == CHORD_MESSAGE__MSG_PUT_REQUEST) {
+		putRequest.id = coord->id;
+		putRequest.key = key;
+		putRequest.value = (ProtobufCBinaryData) {.len = coord->value_len, .data = coord->value};
+		putRequest.has_version = 1;
+		putRequest.version = coord->version;
+		msg.put_request = &putRequest;
+		expected = CHORD_MESSAGE__MSG_PUT_RESPONSE;
+	} else if (coord->type == CHORD_MESSAGE__MSG_GET_REQUEST) {
+		getRequest.id = coord->id;
+		getRequest.key = key;
+		getRequest.has_replica = 1;
+		getRequest.replica = 1;
+		msg.get_request = &getRequest;
+		expected = CHORD_MESSAGE__MSG_GET_RESPONSE;
+	} else {
+		deleteRequest.id = coord->id;
+		deleteRequest.key = key;
+		deleteRequest.has_replica = 1;
+		deleteRequest.replica = 1;
+		deleteRequest.has_version = 1;
+		deleteRequest.version = coord->version;
+		msg.delete_request = &deleteRequest;
+		expected = CHORD_MESSAGE__MSG_DELETE_RESPONSE;
+	}
+
+	struct kv_replica_call *call = malloc(sizeof(*call));
+	if (!call) {
+		return;
+	}
+	call->coord = coord;
+	call->counts = counts;
+
+	if (rpc_call(replica, &msg, expected, replica_reply, call) != 0) {
+		free(call);
+		return;
+	}
+	coord->outstanding++;
+}
+
+// Versions follow the wall clock so a write made while a range is still
+// moving here wins over the older copy that arrives with the range
+static uint64_t next_version(const struct kv_item *item) {
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+
+	uint64_t now = ((uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000) << 16;
+	return item && item->version >= now ? item->version + 1 : now;
+}
+
+// Replicas of this node's keys: the first --replicas distinct processes of
+// its successor list, virtual nodes sharing one would share its store
+static size_t find_replicas(Node **replicas, size_t max) {
+	size_t n = 0;
+	for (int i = 0; i < chord_args.num_successors && n < (size_t)chord_args.replicas && n < max; ++i) {
+		Node *replica = &successor_list[i];
+		int duplicate = replica->key == 0 || vnode_is_local(replica);
+		for (int j = 0; j < i && !duplicate; ++j) {
+			duplicate = successor_list[j].address == replica->address && successor_list[j].port == replica->port;
+		}
+
+		if (!duplicate) {
+			replicas[n++] = replica;
+		}
+	}
+	return n;
+}
+
+/**
+ * @brief Runs an operation on the owner: applies it locally, then on the
+ *        first --replicas distinct successors.
+ *
+ * Reads only go to the replicas when the read quorum needs them. While the
+ * key's range is still being handed to this node, misses are read from and
+ * deletes also applied to the node it comes from.
+ */
+static void coordinate(ChordMessage__MsgCase type, uint64_t id, const uint8_t *key, size_t key_len,
+                       const uint8_t *value, size_t value_len, kv_callback callback, void *arg) {
+	struct kv_coord *coord = calloc(1, sizeof(*coord));
+	if (!coord || copy_bytes(&coord->key, key, key_len) != 0) {
+		free(coord);
+		callback(KV_FAILED, NULL, 0, arg);
+		return;
+	}
+	coord->type = type;
+	coord->id = id;
+	coord->key_len = key_len;
+	coord->callback = callback;
+	coord->arg = arg;
+
+	const struct kv_item *item = kv_store_get(id, key, key_len);
+
+	if (type == CHORD_MESSAGE__MSG_PUT_REQUEST) {
+		coord->needed = chord_args.write_quorum;
+		coord->version = next_version(item);
+
+		if (copy_bytes(&coord->value, value, value_len) == 0
+		    && kv_store_put(id, key, key_len, value, value_len, coord->version) == 0) {
+			coord->value_len = value_len;
+			coord->acks = 1;
+		}
+	} else if (type == CHORD_MESSAGE__MSG_GET_REQUEST) {
+		coord->needed = chord_args.read_quorum;
+		coord->acks = 1;
+
+		if (item && item->deleted) {
+			coord->version = item->version; // Replicas need a newer copy to override it
+		} else if (item && copy_bytes(&coord->value, kv_item_value(item), item->value_len) == 0) {
+			coord->value_len = item->value_len;
+			coord->version = item->version;
+			coord->found = 1;
+		}
+	} else {
+		// Deleting writes a tombstone, quorum reads then prefer it to older copies
+		coord->needed = chord_args.write_quorum;
+		coord->version = next_version(item);
+		coord->found = item && !item->deleted;
+		coord->acks = kv_store_tombstone(id, key, key_len, coord->version) == 0;
+	}
+
+	Node *source = handoff_source(id);
+	if (source && type == CHORD_MESSAGE__MSG_GET_REQUEST && !coord->found) {
+		// A miss here says nothing yet, the source's copy decides
+		coord->acks = 0;
+		coord->needed = 1;
+		send_to_replica(coord, source, 1);
+	} else if (source && type == CHORD_MESSAGE__MSG_DELETE_REQUEST && coord->acks > 0) {
+		// The source is about to drop the range, it is no replica and does not ack
+		send_to_replica(coord, source, 0);
+	}
+
+	// A failed local write is reported, nothing is replicated
+	if (coord->acks > 0 && (type != CHORD_MESSAGE__MSG_GET_REQUEST || coord->needed > 1)) {
+		Node *replicas[ROUTING_MAX_SUCCESSORS];
+		size_t n_replicas = find_replicas(replicas, ROUTING_MAX_SUCCESSORS);
+		for (size_t i = 0; i < n_replicas; ++i) {
+			send_to_replica(coord, replicas[i], 1);
+		}
+	}
+
+	coord_complete(coord);
+}
+
+// Outstanding put, get or delete from this node, owned by the callbacks until it completes
+struct kv_op {
+	ChordMessage__MsgCase type;     // Request to send once the owner is known
+	uint64_t id;
+	uint8_t *key;
+	size_t key_len;
+	uint8_t *value;
+	size_t value_len;
+	int allow_stale;
+	Node owner;
+	int asked_owner;                // The request went to the owner, its answer lists its replicas
+	kv_callback callback;
+	void *arg;
+};
+
+// Replica sets owners reported, direct-mapped on the owner's key
+struct replica_set {
+	Node owner;
+	size_t n_replicas;
+	Node replicas[KV_MAX_KNOWN_REPLICAS];
+	uint64_t expires;               // Monotonic ms
+};
+
+static struct replica_set replica_sets[KV_REPLICA_SETS];
+
+static int same_node(const Node *a, const Node *b) {
+	return a->key == b->key && a->address == b->address && a->port == b->port;
+}
+
+static void remember_replicas(const Node *owner, Node **replicas, size_t n_replicas) {
+	struct replica_set *set = &replica_sets[owner->key % KV_REPLICA_SETS];
+	set->owner = *owner;
+	set->n_replicas = 0;
+	for (size_t i = 0; i < n_replicas && set->n_replicas < KV_MAX_KNOWN_REPLICAS; ++i) {
+		set->replicas[set->n_replicas++] = *replicas[i];
+	}
+	set->expires = monotonic_ms() + KV_REPLICA_SET_TTL_MS;
+}
+
+static void kv_op_free(struct kv_op *op) {
+	free(op->key);
+	free(op->value);
+	free(op);
+}
+
+static void kv_op_finish(struct kv_op *op, enum kv_status status, const uint8_t *value, size_t value_len) {
+	op->callback(status, value, value_len, op->arg);
+	kv_op_free(op);
+}
+
+static void kv_reply(MessageResponse *response, void *arg) {
+	struct kv_op *op = arg;
+
+	if (response->type == CHORD_MESSAGE__MSG_PUT_RESPONSE) {
+		kv_op_finish(op, response->message->put_response->failed ? KV_FAILED : KV_OK, NULL, 0);
+	} else if (response->type == CHORD_MESSAGE__MSG_GET_RESPONSE) {
+		GetResponse *getResponse = response->message->get_response;
+		if (op->asked_owner && getResponse->n_replicas > 0) {
+			remember_replicas(&op->owner, getResponse->replicas, getResponse->n_replicas);
+		}
+
+		if (getResponse->failed) {
+			kv_op_finish(op, KV_FAILED, NULL, 0);
+		} else if (getResponse->found) {
+			kv_op_finish(op, KV_OK, getResponse->value.data, getResponse->value.len);
+		} else {
+			kv_op_finish(op, KV_NOT_FOUND, NULL, 0);
+		}
+	} else if (response->type == CHORD_MESSAGE__MSG_DELETE_RESPONSE) {
+		DeleteResponse *deleteResponse = response->message->delete_response;
+		if (deleteResponse->failed) {
+			kv_op_finish(op, KV_FAILED, NULL, 0);
+		} else {
+			kv_op_finish(op, deleteResponse->found ? KV_OK : KV_NOT_FOUND, NULL, 0);
+		}
+	} else {
+		kv_op_finish(op, KV_FAILED, NULL, 0); // Owner did not answer
+	}
+}
+
+// Owner or one of the replicas it last reported, for a stale read: the
+// nearest by measured round trip. One never measured is picked first, the
+// read itself measures it. Until the owner answered once, or after its
+// report expired, only the owner
+static Node pick_replica(Node *owner) {
+	int count = 1;
+	Node candidates[1 + KV_MAX_KNOWN_REPLICAS];
+	candidates[0] = *owner;
+
+	const struct replica_set *set = &replica_sets[owner->key % KV_REPLICA_SETS];
+	if (same_node(&set->owner, owner) && set->expires > monotonic_ms()) {
+		for (size_t i = 0; i < set->n_replicas; ++i) {
+			candidates[count++] = set->replicas[i];
+		}
+	}
+
+	int best = 0;
+	uint64_t best_rtt = UINT64_MAX;
+	for (int i = 0; i < count; ++i) {
+		Node *candidate = &candidates[i];
+		if (peer_status(candidate->address, candidate->port) == PEER_FAILED) {
+			continue;
+		}
+
+		uint64_t rtt = peer_rtt(candidate->address, candidate->port);
+		if (rtt < best_rtt) {
+			best = i;
+			best_rtt = rtt; // 0 when never measured, nothing beats it
+		}
+	}
+
+	return candidates[best];
+}
+
+static void kv_owner_found(Node *owner, void *arg) {
+	struct kv_op *op = arg;
+
+	if (!owner) {
+		kv_op_finish(op, KV_FAILED, NULL, 0);
+		return;
+	}
+
+	ChordMessage msg = CHORD_MESSAGE__INIT;
+	msg.version = 417;
+	msg.msg_case = op->type;
+
+	Node target = *owner;
+	ProtobufCBinaryData key = {.len = op->key_len, .data = op->key};
+	ChordMessage__MsgCase expected;
+
+	PutRequest putRequest = PUT_REQUEST__INIT;
+	GetRequest getRequest = GET_REQUEST__INIT;
+	DeleteRequest deleteRequest = DELETE_REQUEST__INIT;
+
+	if (op->type == CHORD_MESSAGE__MSG_GET_REQUEST && op->allow_stale) {
+		// Any copy will do, one held here costs no round trip at all
+		const struct kv_item *item = kv_store_get(op->id, op->key, op->key_len);
+		if (item && item->deleted) {
+			kv_op_finish(op, KV_NOT_FOUND, NULL, 0);
+			return;
+		} else if (item) {
+			kv_op_finish(op, KV_OK, kv_item_value(item), item->value_len);
+			return;
+		}
+
+		target = pick_replica(owner);
+		getRequest.has_replica = 1;
+		getRequest.replica = 1;
+	}
+	op->owner = *owner;
+	op->asked_owner = same_node(&target, owner);
+
+	int local = vnode_find(target.key);
+	if (local >= 0) {
+		// One of our virtual nodes owns the key, coordinate as if the request had come in
+		vnode_activate(local);
+		coordinate(op->type, op->id, op->key, op->key_len, op->value, op->value_len, op->callback, op->arg);
+		kv_op_free(op);
+		return;
+	}
+
+	if (op->type == CHORD_MESSAGE__MSG_PUT_REQUEST) {
+		putRequest.id = op->id;
+		putRequest.key = key;
+		putRequest.value = (ProtobufCBinaryData) {.len = op->value_len, .data = op->value};
+		msg.put_request = &putRequest;
+		expected = CHORD_MESSAGE__MSG_PUT_RESPONSE;
+	} else if (op->type == CHORD_MESSAGE__MSG_GET_REQUEST) {
+		getRequest.id = op->id;
+		getRequest.key = key;
+		msg.get_request = &getRequest;
+		expected = CHORD_MESSAGE__MSG_GET_RESPONSE;
+	} else {
+		deleteRequest.id = op->id;
+		deleteRequest.key = key;
+		msg.delete_request = &deleteRequest;
+		expected = CHORD_MESSAGE__MSG_DELETE_RESPONSE;
+	}
+
+	if (rpc_call(&target, &msg, expected, kv_reply, op) != 0) {
+		kv_op_finish(op, KV_FAILED, NULL, 0);
+	}
+}
+
+static void kv_start(ChordMessage__MsgCase type, uint64_t id, const uint8_t *key, size_t key_len,
+                     const uint8_t *value, size_t value_len, int allow_stale, kv_callback callback, void *arg) {
+	struct kv_op *op = calloc(1, sizeof(*op));
+	if (!op || copy_bytes(&op->key, key, key_len) != 0 || copy_bytes(&op->value, value, value_len) != 0) {
+		if (op) {
+			free(op->key);
+		}
+		free(op);
+		callback(KV_FAILED, NULL, 0, arg);
+		return;
+	}
+
+	op->type = type;
+	op->id = id;
+	op->key_len = key_len;
+	op->value_len = value_len;
+	op->allow_stale = allow_stale;
+	op->callback = callback;
+	op->arg = arg;
+
+	find_successor_parallel(id, chord_args.lookup_alpha, kv_owner_found, op);
+}
+
+void kv_put(uint64_t id, const uint8_t *key, size_t key_len, const uint8_t *value, size_t value_len,
+            kv_callback callback, void *arg) {
+	kv_start(CHORD_MESSAGE__MSG_PUT_REQUEST, id, key, key_len, value, value_len, 0, callback, arg);
+}
+
+void kv_get(uint64_t id, const uint8_t *key, size_t key_len, int allow_stale, kv_callback callback, void *arg) {
+	kv_start(CHORD_MESSAGE__MSG_GET_REQUEST, id, key, key_len, NULL, 0, allow_stale, callback, arg);
+}
+
+void kv_delete(uint64_t id, const uint8_t *key, size_t key_len, kv_callback callback, void *arg) {
+	kv_start(CHORD_MESSAGE__MSG_DELETE_REQUEST, id, key, key_len, NULL, 0, 0, callback, arg);
+}
+
+// Who a coordinated request answers once its quorum is in
+struct kv_requester {
+	ChordMessage__MsgCase type;
+	struct sockaddr_in addr;
+	protobuf_c_boolean has_query_id;
+	int32_t query_id;
+	size_t n_replicas;              // Ours as of the request, returned with a get
+	Node replicas[KV_MAX_KNOWN_REPLICAS];
+};
+
+static void reply_to_requester(enum kv_status status, const uint8_t *value, size_t value_len, void *arg) {
+	struct kv_requester *requester = arg;
+
+	ChordMessage msg = CHORD_MESSAGE__INIT;
+	msg.version = 417;
+	msg.has_query_id = requester->has_query_id;
+	msg.query_id = requester->query_id;
+
+	PutResponse putResponse = PUT_RESPONSE__INIT;
+	GetResponse getResponse = GET_RESPONSE__INIT;
+	DeleteResponse deleteResponse = DELETE_RESPONSE__INIT;
+
+	if (requester->type == CHORD_MESSAGE__MSG_PUT_REQUEST) {
+		putResponse.has_failed = status == KV_FAILED;
+		putResponse.failed = status == KV_FAILED;
+		msg.put_response = &putResponse;
+		msg.msg_case = CHORD_MESSAGE__MSG_PUT_RESPONSE;
+	} else if (requester->type == CHORD_MESSAGE__MSG_GET_REQUEST) {
+		getResponse.found = status == KV_OK;
+		getResponse.has_failed = status == KV_FAILED;
+		getResponse.failed = status == KV_FAILED;
+		if (status == KV_OK) {
+			getResponse.has_value = 1;
+			getResponse.value = (ProtobufCBinaryData) {.len = value_len, .data = (uint8_t *)value};
+		}
+		Node *replicas[KV_MAX_KNOWN_REPLICAS];
+		for (size_t i = 0; i < requester->n_replicas; ++i) {
+			replicas[i] = &requester->replicas[i];
+		}
+		getResponse.n_replicas = requester->n_replicas;
+		getResponse.replicas = replicas;
+		msg.get_response = &getResponse;
+		msg.msg_case = CHORD_MESSAGE__MSG_GET_RESPONSE;
+	} else {
+		deleteResponse.found = status == KV_OK;
+		deleteResponse.has_failed = status == KV_FAILED;
+		deleteResponse.failed = status == KV_FAILED;
+		msg.delete_response = &deleteResponse;
+		msg.msg_case = CHORD_MESSAGE__MSG_DELETE_RESPONSE;
+	}
+
+	send_message(&requester->addr, &msg, "Error sending key-value response");
+	free(requester);
+}
+
+// Replicas apply the owner's writes as they are and read their own copy
+static void answer_replica(ChordMessage *message, struct sockaddr_in *from) {
+	ChordMessage msg = CHORD_MESSAGE__INIT;
+	msg.version = 417;
+	msg.has_query_id = message->has_query_id;
+	msg.query_id = message->query_id;
+
+	if (message->msg_case == CHORD_MESSAGE__MSG_PUT_REQUEST) {
+		PutRequest *putRequest = message->put_request;
+		const struct kv_item *item = kv_store_get(putRequest->id, putRequest->key.data, putRequest->key.len);
+
+		// Not acknowledged if it could not be stored, the owner times out
+		if ((!item || item->version < putRequest->version)
+		    && kv_store_put(putRequest->id, putRequest->key.data, putRequest->key.len,
+		                    putRequest->value.data, putRequest->value.len, putRequest->version) != 0) {
+			return;
+		}
+
+		PutResponse putResponse = PUT_RESPONSE__INIT;
+		msg.put_response = &putResponse;
+		msg.msg_case = CHORD_MESSAGE__MSG_PUT_RESPONSE;
+
+		send_message(from, &msg, "Error sending put response");
+	} else if (message->msg_case == CHORD_MESSAGE__MSG_GET_REQUEST) {
+		GetRequest *getRequest = message->get_request;
+		const struct kv_item *item = kv_store_get(getRequest->id, getRequest->key.data, getRequest->key.len);
+
+		GetResponse getResponse = GET_RESPONSE__INIT;
+		getResponse.found = item && !item->deleted;
+		if (getResponse.found) {
+			getResponse.has_value = 1;
+			getResponse.value = (ProtobufCBinaryData) {.len = item->value_len, .data = (uint8_t *)kv_item_value(item)};
+		}
+		if (item) {
+			getResponse.has_version = 1;
+			getResponse.version = item->version;
+		}
+
+		// Asked as a replica but the owner, it tells the requester where the other copies are
+		Node *replicas[KV_MAX_KNOWN_REPLICAS];
+		if (predecessor.key != 0 && element_of(getRequest->id, predecessor.key, hash, 1)) {
+			getResponse.n_replicas = find_replicas(replicas, KV_MAX_KNOWN_REPLICAS);
+			getResponse.replicas = replicas;
+		}
+
+		msg.get_response = &getResponse;
+		msg.msg_case = CHORD_MESSAGE__MSG_GET_RESPONSE;
+
+		send_message(from, &msg, "Error sending get response");
+	} else {
+		DeleteRequest *deleteRequest = message->delete_request;
+		const struct kv_item *item = kv_store_get(deleteRequest->id, deleteRequest->key.data, deleteRequest->key.len);
+
+		DeleteResponse deleteResponse = DELETE_RESPONSE__INIT;
+		deleteResponse.found = item && !item->deleted;
+
+		// Not acknowledged if the tombstone could not be stored, the owner times out.
+		// An owner that sends no version leaves none
+		if (!deleteRequest->has_version) {
+			kv_store_delete(deleteRequest->id, deleteRequest->key.data, deleteRequest->key.len);
+		} else if ((!item || item->version < deleteRequest->version)
+		           && kv_store_tombstone(deleteRequest->id, deleteRequest->key.data, deleteRequest->key.len,
+		                                 deleteRequest->version) != 0) {
+			return;
+		}
+
+		msg.delete_response = &deleteResponse;
+		msg.msg_case = CHORD_MESSAGE__MSG_DELETE_RESPONSE;
+
+		send_message(from, &msg, "Error sending delete response");
+	}
+}
+
+int kv_handle_request(ChordMessage *message, struct sockaddr_in *from) {
+	uint64_t id;
+	ProtobufCBinaryData key;
+	ProtobufCBinaryData value = {0};
+	int replica;
+
+	if (message->msg_case == CHORD_MESSAGE__MSG_PUT_REQUEST) {
+		id = message->put_request->id;
+		key = message->put_request->key;
+		value = message->put_request->value;
+		replica = message->put_request->has_version;
+	} else if (message->msg_case == CHORD_MESSAGE__MSG_GET_REQUEST) {
+		id = message->get_request->id;
+		key = message->get_request->key;
+		replica = message->get_request->replica;
+	} else if (message->msg_case == CHORD_MESSAGE__MSG_DELETE_REQUEST) {
+		id = message->delete_request->id;
+		key = message->delete_request->key;
+		replica = message->delete_request->replica;
+	} else {
+		return 0;
+	}
+
+	if (replica) {
+		answer_replica(message, from);
+		return 1;
+	}
+
+	struct kv_requester *requester = malloc(sizeof(*requester));
+	if (!requester) {
+		return 1; // The requester times out
+	}
+	requester->type = message->msg_case;
+	requester->addr = *from;
+	requester->has_query_id = message->has_query_id;
+	requester->query_id = message->query_id;
+	requester->n_replicas = 0;
+
+	// A requester whose lookup is out of date is told so rather than
+	// served stale data or leaving writes where the owner never reads them
+	if (predecessor.key != 0 && !element_of(id, predecessor.key, hash, 1)) {
+		reply_to_requester(KV_FAILED, NULL, 0, requester);
+		return 1;
+	}
+
+	// Taken now, the reply may go out after another virtual node became active
+	if (message->msg_case == CHORD_MESSAGE__MSG_GET_REQUEST) {
+		Node *replicas[KV_MAX_KNOWN_REPLICAS];
+		requester->n_replicas = find_replicas(replicas, KV_MAX_KNOWN_REPLICAS);
+		for (size_t i = 0; i < requester->n_replicas; ++i) {
+			requester->replicas[i] = *replicas[i];
+		}
+	}
+
+	coordinate(message->msg_case, id, key.data, key.len, value.data, value.len, reply_to_requester, requester);
+	return 1;
+}
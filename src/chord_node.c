@@ -0,0 +1,182 @@
+#include <stdlib.h>
+#include <arpa/inet.h>
+
+#include "chord.h"
+#include "chord_impl.h"
+#include "chord_arg_parser.h"
+#include "chord_node.h"
+#include "chord_timer.h"
+#include "chord_vnode.h"
+#include "hash.h"
+
+struct chord_node {
+	int serving; // Joined, and node_serve() started the maintenance rounds
+	int failed;
+};
+
+// The routing state behind a node is the process's, so one node is live at a time
+static struct chord_node *live = NULL;
+
+struct lookup_state {
+	struct chord_node *node;
+	uint64_t key;
+	chord_lookup_callback callback;
+	void *arg;
+};
+
+struct lookup_batch_state {
+	struct chord_node *node;
+	chord_lookup_batch_callback callback;
+	void *arg;
+	struct chord_location *locations; // Room for the results, one per key
+	const struct chord_location **owners;
+};
+
+static struct chord_location location_of(const Node *node) {
+	struct chord_location location = {.key = node->key};
+	location.address.sin_family = AF_INET;
+	location.address.sin_addr.s_addr = node->address;
+	location.address.sin_port = node->port;
+	return location;
+}
+
+struct chord_node *chord_node_create(const struct chord_arguments *args) {
+	if (live) {
+		return NULL;
+	}
+
+	struct chord_arguments checked = *args;
+	if (chord_check_arguments(&checked) != 0) {
+		return NULL;
+	}
+
+	struct chord_node *node = calloc(1, sizeof(*node));
+	if (!node) {
+		return NULL;
+	}
+
+	chord_args = checked;
+	if (node_start() != 0) {
+		node_stop(); // Leaves nothing behind, a later create starts afresh
+		free(node);
+		return NULL;
+	}
+
+	live = node;
+	return node;
+}
+
+void chord_node_destroy(struct chord_node *node) {
+	// Lookups the failed calls end report back, none may start meanwhile
+	node->serving = 0;
+	node_stop();
+
+	live = NULL;
+	free(node);
+}
+
+int chord_node_poll(struct chord_node *node, int timeout_ms) {
+	if (node->failed || node_run_once(timeout_ms) != 0) {
+		node->failed = 1;
+		return -1;
+	}
+
+	// The maintenance rounds start once every virtual node has a successor
+	if (!node->serving && vnode_all_joined()) {
+		if (node_serve() != 0) {
+			node->failed = 1;
+			return -1;
+		}
+		node->serving = 1;
+	}
+	return 0;
+}
+
+int chord_node_fd(const struct chord_node *node) {
+	(void)node;
+	return node_poll_fd();
+}
+
+int64_t chord_node_timeout(const struct chord_node *node) {
+	(void)node;
+	return timers_next_timeout();
+}
+
+int chord_node_joined(const struct chord_node *node) {
+	return node->serving;
+}
+
+uint64_t chord_node_key(const void *name, size_t len) {
+	return sha1sum_head(name, len);
+}
+
+static void lookup_async_done(Node *owner, void *arg) {
+	struct lookup_state *state = arg;
+
+	if (owner) {
+		struct chord_location location = location_of(owner);
+		state->callback(state->node, state->key, &location, state->arg);
+	} else {
+		state->callback(state->node, state->key, NULL, state->arg);
+	}
+	free(state);
+}
+
+int chord_lookup_async(struct chord_node *node, uint64_t key, chord_lookup_callback callback, void *arg) {
+	if (!node->serving) {
+		return -1;
+	}
+
+	struct lookup_state *state = malloc(sizeof(*state));
+	if (!state) {
+		return -1;
+	}
+	*state = (struct lookup_state) {.node = node, .key = key, .callback = callback, .arg = arg};
+
+	vnode_activate(0);
+	find_successor_parallel(key, chord_args.lookup_alpha, lookup_async_done, state);
+	return 0;
+}
+
+static void lookup_batch_async_done(size_t n_keys, uint64_t *keys, Node **nodes, void *arg) {
+	struct lookup_batch_state *state = arg;
+
+	for (size_t i = 0; i < n_keys; ++i) {
+		if (nodes[i]) {
+			state->locations[i] = location_of(nodes[i]);
+			state->owners[i] = &state->locations[i];
+		} else {
+			state->owners[i] = NULL;
+		}
+	}
+	state->callback(state->node, n_keys, keys, state->owners, state->arg);
+
+	free(state->locations);
+	free(state->owners);
+	free(state);
+}
+
+int chord_lookup_batch_async(struct chord_node *node, const uint64_t *keys, size_t n_keys,
+                             chord_lookup_batch_callback callback, void *arg) {
+	if (!node->serving) {
+		return -1;
+	}
+
+	// Taken now, so that a batch once started always reports back
+	struct lookup_batch_state *state = malloc(sizeof(*state));
+	struct chord_location *locations = malloc(sizeof(*locations) * (n_keys ? n_keys : 1));
+	const struct chord_location **owners = malloc(sizeof(*owners) * (n_keys ? n_keys : 1));
+	if (!state || !locations || !owners) {
+		free(state);
+		free(locations);
+		free(owners);
+		return -1;
+	}
+	*state = (struct lookup_batch_state) {.node = node, .callback = callback, .arg = arg,
+	                                      .locations = locations, .owners = owners};
+
+	// find_successors() keeps its own copy of the keys
+	vnode_activate(0);
+	find_successors((uint64_t *)keys, n_keys, lookup_batch_async_done, state);
+	return 0;
+}
@@ -0,0 +1,168 @@
+#include <stddef.h>
+#include <math.h>
+
+#include "chord_peer.h"
+#include "chord_timer.h"
+
+struct peer {
+	int in_use;
+	uint32_t address;
+	uint32_t port;
+	uint64_t srtt_us;       // 0 until a round trip was measured
+	uint64_t last_sample;   // Monotonic ms, of a round trip or a heartbeat
+
+	// Heartbeat history for the failure detector
+	uint64_t last_heard;    // Monotonic ms, 0 if never
+	double interval_mean;   // ms, exponentially weighted like srtt
+	double interval_var;
+	int n_intervals;
+};
+
+// Open addressing over a short probe window, full windows recycle their stalest peer
+static struct peer peers[PEER_TABLE_SIZE];
+
+static size_t home_slot(uint32_t address, uint32_t port) {
+	uint64_t key = ((uint64_t)address << 16) | (port & 0xffff);
+	return (key * 0x9E3779B97F4A7C15ULL) >> 54; // Fibonacci hashing, top 10 bits
+}
+
+static struct peer *find_peer(uint32_t address, uint32_t port) {
+	size_t home = home_slot(address, port);
+	for (size_t i = 0; i < PEER_PROBE_LIMIT; ++i) {
+		struct peer *peer = &peers[(home + i) & (PEER_TABLE_SIZE - 1)];
+		if (peer->in_use && peer->address == address && peer->port == port) {
+			return peer;
+		}
+	}
+	return NULL;
+}
+
+// Free slot of the probe window, else the one heard from least recently
+static struct peer *claim_slot(uint32_t address, uint32_t port) {
+	size_t home = home_slot(address, port);
+	struct peer *victim = NULL;
+	for (size_t i = 0; i < PEER_PROBE_LIMIT; ++i) {
+		struct peer *slot = &peers[(home + i) & (PEER_TABLE_SIZE - 1)];
+		if (!slot->in_use) {
+			victim = slot;
+			break;
+		}
+		if (!victim || slot->last_sample < victim->last_sample) {
+			victim = slot;
+		}
+	}
+
+	*victim = (struct peer) {.in_use = 1, .address = address, .port = port};
+	return victim;
+}
+
+static struct peer *get_peer(uint32_t address, uint32_t port) {
+	struct peer *peer = find_peer(address, port);
+	return peer ? peer : claim_slot(address, port);
+}
+
+void peer_rtt_sample(uint32_t address, uint32_t port, uint64_t rtt_us) {
+	if (rtt_us == 0) {
+		rtt_us = 1; // 0 means not measured
+	}
+
+	struct peer *peer = get_peer(address, port);
+	if (peer->srtt_us == 0) {
+		peer->srtt_us = rtt_us;
+	} else {
+		// srtt += (sample - srtt) / 8, in signed arithmetic so it can fall
+		int64_t delta = (int64_t)rtt_us - (int64_t)peer->srtt_us;
+		peer->srtt_us += delta / (1 << PEER_RTT_ALPHA_SHIFT);
+		if (peer->srtt_us == 0) {
+			peer->srtt_us = 1;
+		}
+	}
+	peer->last_sample = monotonic_ms();
+}
+
+uint64_t peer_rtt(uint32_t address, uint32_t port) {
+	struct peer *peer = find_peer(address, port);
+	return peer ? peer->srtt_us : 0;
+}
+
+void peer_heard(uint32_t address, uint32_t port) {
+	uint64_t now = monotonic_ms();
+	struct peer *peer = get_peer(address, port);
+
+	if (peer->last_heard != 0) {
+		uint64_t interval = now - peer->last_heard;
+		if (interval < PEER_HEARTBEAT_MIN_MS) {
+			return; // Same burst, the interval keeps running from its first message
+		}
+
+		double alpha = 1.0 / (1 << PEER_RTT_ALPHA_SHIFT);
+		if (peer->n_intervals == 0) {
+			peer->interval_mean = interval;
+			peer->interval_var = 0;
+		} else {
+			double delta = interval - peer->interval_mean;
+			peer->interval_mean += alpha * delta;
+			peer->interval_var = (1 - alpha) * (peer->interval_var + alpha * delta * delta);
+		}
+		peer->n_intervals++;
+	}
+
+	peer->last_heard = now;
+	peer->last_sample = now;
+}
+
+double peer_phi(uint32_t address, uint32_t port) {
+	struct peer *peer = find_peer(address, port);
+	if (!peer || peer->n_intervals < PEER_MIN_INTERVALS) {
+		return 0;
+	}
+
+	double deviation = sqrt(peer->interval_var);
+	if (deviation < PEER_MIN_DEVIATION_MS) {
+		deviation = PEER_MIN_DEVIATION_MS;
+	}
+
+	// Intervals taken as normally distributed, as in the original phi accrual detector
+	double silence = monotonic_ms() - peer->last_heard;
+	double p_later = 0.5 * erfc((silence - peer->interval_mean) / (deviation * M_SQRT2));
+	if (p_later < 1e-300) {
+		return 300;
+	}
+	return -log10(p_later);
+}
+
+enum peer_status peer_status(uint32_t address, uint32_t port) {
+	struct peer *peer = find_peer(address, port);
+	if (!peer || peer->n_intervals < PEER_MIN_INTERVALS) {
+		return PEER_SUSPECT;
+	}
+
+	double phi = peer_phi(address, port);
+	if (phi >= PEER_PHI_FAILED) {
+		return PEER_FAILED;
+	}
+	return phi >= PEER_PHI_SUSPECT ? PEER_SUSPECT : PEER_ALIVE;
+}
+
+size_t peer_export(struct peer_record *records) {
+	size_t n = 0;
+	for (size_t i = 0; i < PEER_TABLE_SIZE; ++i) {
+		if (peers[i].in_use && peers[i].srtt_us != 0) {
+			records[n++] = (struct peer_record) {peers[i].address, peers[i].port, peers[i].srtt_us};
+		}
+	}
+	return n;
+}
+
+void peer_import(const struct peer_record *records, size_t n_records) {
+	for (size_t i = 0; i < n_records; ++i) {
+		const struct peer_record *record = &records[i];
+		if (record->srtt_us == 0 || find_peer(record->address, record->port)) {
+			continue;
+		}
+
+		// Imported as heard from long ago, so live measurements displace them first
+		struct peer *peer = claim_slot(record->address, record->port);
+		peer->srtt_us = record->srtt_us;
+	}
+}
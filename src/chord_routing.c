@@ -0,0 +1,407 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+
+#include "chord.h"
+#include "chord_arg_parser.h"
+#include "chord_impl.h"
+#include "chord_routing.h"
+#include "chord_rpc.h"
+#include "chord_stats.h"
+#include "chord_vnode.h"
+#include "chord.pb-c.h"
+
+// Snapshots requests are answered from, one per virtual node, swapped
+// atomically by routing_publish()
+static struct routing_snapshot *current[VNODE_MAX];
+
+// Epoch reclamation: readers advertise the epoch they entered in, 0 when idle
+static uint64_t global_epoch = 1;
+static uint64_t reader_epochs[ROUTING_MAX_READERS];
+static int n_readers = 0;
+static __thread int reader_slot = -1;
+
+// Filled on every publish, only becomes a snapshot when the state changed
+static struct routing_snapshot *spare = NULL;
+
+// Replaced snapshots, freed once every active reader entered after their retirement
+static struct routing_snapshot *retired = NULL;
+
+static void fill_snapshot(struct routing_snapshot *snapshot, const struct vnode_state *state) {
+	memset(snapshot, 0, sizeof(*snapshot));
+
+	snapshot->hash = state->hash;
+	snapshot->self = state->self;
+	snapshot->predecessor = state->predecessor;
+	snapshot->successor = state->successor;
+	snapshot->num_successors = chord_args.num_successors;
+	memcpy(snapshot->finger_table, state->finger_table, sizeof(Node) * ROUTING_FINGERS);
+	memcpy(snapshot->successor_list, state->successor_list, sizeof(Node) * chord_args.num_successors);
+
+	for (int i = 0; i < ROUTING_CANDIDATES; ++i) {
+		const Node *node = i < ROUTING_FINGERS ? &state->finger_table[i] : &state->successor_list[i - ROUTING_FINGERS];
+		int present = i < ROUTING_FINGERS + chord_args.num_successors && node->key != 0;
+
+		snapshot->candidate_keys[i] = present ? node->key : state->hash;
+		snapshot->candidate_addresses[i] = present ? node->address : 0;
+		snapshot->candidate_ports[i] = present ? node->port : 0;
+	}
+}
+
+static int same_node(const Node *a, const Node *b) {
+	return a->key == b->key && a->address == b->address && a->port == b->port;
+}
+
+// Routing table changes, as seen between two publishes of the same virtual node
+static void count_changes(const struct routing_snapshot *old, const struct routing_snapshot *next) {
+	if (!same_node(&old->successor, &next->successor)) {
+		stats_add(STATS_SUCCESSOR_CHANGES, 1);
+	}
+	if (!same_node(&old->predecessor, &next->predecessor)) {
+		stats_add(STATS_PREDECESSOR_CHANGES, 1);
+	}
+
+	uint64_t fingers = 0;
+	for (int i = 0; i < ROUTING_FINGERS; ++i) {
+		fingers += !same_node(&old->finger_table[i], &next->finger_table[i]);
+	}
+	if (fingers) {
+		stats_add(STATS_FINGER_CHANGES, fingers);
+	}
+}
+
+static void reclaim(void) {
+	// Oldest epoch any reader may have loaded a snapshot in
+	uint64_t oldest = UINT64_MAX;
+	int readers = __atomic_load_n(&n_readers, __ATOMIC_SEQ_CST);
+	for (int i = 0; i < readers; ++i) {
+		uint64_t epoch = __atomic_load_n(&reader_epochs[i], __ATOMIC_SEQ_CST);
+		if (epoch != 0 && epoch < oldest) {
+			oldest = epoch;
+		}
+	}
+
+	struct routing_snapshot **link = &retired;
+	while (*link) {
+		struct routing_snapshot *snapshot = *link;
+
+		if (snapshot->retire_epoch < oldest) {
+			*link = snapshot->next_retired;
+			free(snapshot);
+		} else {
+			link = &snapshot->next_retired;
+		}
+	}
+}
+
+// Publishes a virtual node's state as snapshot index
+static void publish(int index) {
+	if (!spare) {
+		spare = malloc(sizeof(*spare));
+		if (!spare) {
+			return;
+		}
+	}
+	fill_snapshot(spare, vnode_get(index));
+
+	// Unchanged state keeps the current snapshot, the spare is reused next time
+	if (current[index] && memcmp(spare, current[index], offsetof(struct routing_snapshot, retire_epoch)) == 0) {
+		return;
+	}
+
+	struct routing_snapshot *next = spare;
+	struct routing_snapshot *old = current[index];
+	spare = NULL;
+	__atomic_store_n(&current[index], next, __ATOMIC_SEQ_CST);
+
+	if (old) {
+		count_changes(old, next);
+		old->retire_epoch = __atomic_fetch_add(&global_epoch, 1, __ATOMIC_SEQ_CST);
+		old->next_retired = retired;
+		retired = old;
+	}
+}
+
+void routing_publish(void) {
+	// Nodes that were never activated cannot have changed
+	int n_touched;
+	const int *touched = vnode_take_touched(&n_touched);
+
+	for (int i = 0; i < n_touched; ++i) {
+		publish(touched[i]);
+	}
+
+	reclaim();
+}
+
+const struct routing_snapshot *routing_current(void) {
+	return current[vnode_active()];
+}
+
+int routing_reader_register(void) {
+	int slot = __atomic_fetch_add(&n_readers, 1, __ATOMIC_SEQ_CST);
+	if (slot >= ROUTING_MAX_READERS) {
+		__atomic_fetch_sub(&n_readers, 1, __ATOMIC_SEQ_CST);
+		return -1;
+	}
+
+	reader_slot = slot;
+	return 0;
+}
+
+void routing_reset(void) {
+	for (int i = 0; i < VNODE_MAX; ++i) {
+		free(current[i]);
+		current[i] = NULL;
+	}
+	free(spare);
+	spare = NULL;
+
+	while (retired) {
+		struct routing_snapshot *next = retired->next_retired;
+		free(retired);
+		retired = next;
+	}
+	memset(reader_epochs, 0, sizeof(reader_epochs));
+	n_readers = 0;
+}
+
+void routing_acquire(void) {
+	// Advertise the epoch before loading, a snapshot retired from here on is kept
+	uint64_t epoch = __atomic_load_n(&global_epoch, __ATOMIC_SEQ_CST);
+	__atomic_store_n(&reader_epochs[reader_slot], epoch, __ATOMIC_SEQ_CST);
+}
+
+const struct routing_snapshot *routing_pinned(int vnode) {
+	return __atomic_load_n(&current[vnode], __ATOMIC_SEQ_CST);
+}
+
+void routing_release(void) {
+	__atomic_store_n(&reader_epochs[reader_slot], 0, __ATOMIC_SEQ_CST);
+}
+
+// Distances clockwise from n, a candidate qualifies if it lies in (n, id).
+// distance - 1 < span covers id == n (the whole ring but n) and rejects
+// n itself, which is what empty slots hold, so the loop has no branches.
+static uint64_t farthest_candidate_generic(const uint64_t *keys, uint64_t n, uint64_t span) {
+	uint64_t best = 0;
+	for (int i = 0; i < ROUTING_CANDIDATES; ++i) {
+		uint64_t distance = keys[i] - n;
+		uint64_t qualifies = -(uint64_t)(distance - 1 < span);
+		uint64_t candidate = distance & qualifies;
+		best = candidate > best ? candidate : best;
+	}
+	return best;
+}
+
+#ifdef __x86_64__
+#include <cpuid.h>
+#include <immintrin.h>
+
+// Four candidates per step, ROUTING_CANDIDATES is a multiple of four. AVX2
+// only compares signed 64-bit lanes, so both sides are offset by 2^63 first,
+// which orders them as unsigned. Optimised even in the default unoptimised
+// build, where every intrinsic would go through the stack and lose to the
+// plain loop.
+__attribute__((target("avx2"), optimize("O2")))
+static uint64_t farthest_candidate_avx2(const uint64_t *keys, uint64_t n, uint64_t span) {
+	const __m256i SIGN = _mm256_set1_epi64x((long long)0x8000000000000000ULL);
+	const __m256i ONE = _mm256_set1_epi64x(1);
+	__m256i node = _mm256_set1_epi64x((long long)n);
+	__m256i limit = _mm256_xor_si256(_mm256_set1_epi64x((long long)span), SIGN);
+	__m256i best = _mm256_setzero_si256();
+
+	for (int i = 0; i < ROUTING_CANDIDATES; i += 4) {
+		__m256i distance = _mm256_sub_epi64(_mm256_loadu_si256((const __m256i *)&keys[i]), node);
+		__m256i offset = _mm256_xor_si256(_mm256_sub_epi64(distance, ONE), SIGN);
+		__m256i candidate = _mm256_and_si256(distance, _mm256_cmpgt_epi64(limit, offset));
+		__m256i greater = _mm256_cmpgt_epi64(_mm256_xor_si256(candidate, SIGN), _mm256_xor_si256(best, SIGN));
+		best = _mm256_blendv_epi8(best, candidate, greater);
+	}
+
+	uint64_t lanes[4];
+	_mm256_storeu_si256((__m256i *)lanes, best);
+	uint64_t result = lanes[0];
+	for (int i = 1; i < 4; ++i) {
+		result = lanes[i] > result ? lanes[i] : result;
+	}
+	return result;
+}
+
+// 0 not checked yet, 1 no AVX2, 2 AVX2 and the OS saves its registers
+static int avx2_support = 0;
+
+static int have_avx2(void) {
+	int support = __atomic_load_n(&avx2_support, __ATOMIC_RELAXED);
+	if (support == 0) {
+		unsigned int eax, ebx, ecx, edx;
+		int avx = 0;
+		if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_OSXSAVE) && (ecx & bit_AVX)) {
+			unsigned int xcr0_low, xcr0_high;
+			__asm__("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+			avx = (xcr0_low & 0x6) == 0x6; // XMM and YMM state enabled
+		}
+		int avx2 = __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_AVX2);
+		support = avx && avx2 ? 2 : 1;
+		__atomic_store_n(&avx2_support, support, __ATOMIC_RELAXED);
+	}
+	return support == 2;
+}
+#endif
+
+Node routing_closest_preceding_node(const struct routing_snapshot *snapshot, uint64_t id) {
+	const uint64_t *keys = snapshot->candidate_keys;
+	uint64_t n = snapshot->hash;
+	uint64_t span = id - n - 1;
+
+#ifdef __x86_64__
+	uint64_t best = have_avx2() ? farthest_candidate_avx2(keys, n, span) : farthest_candidate_generic(keys, n, span);
+#else
+	uint64_t best = farthest_candidate_generic(keys, n, span);
+#endif
+
+	if (best == 0) {
+		return snapshot->self;
+	}
+
+	int i = 0;
+	while (keys[i] - n != best) {
+		i++;
+	}
+
+	Node node = NODE__INIT;
+	node.key = keys[i];
+	node.address = snapshot->candidate_addresses[i];
+	node.port = snapshot->candidate_ports[i];
+	return node;
+}
+
+int answer_query(ChordMessage *message, struct sockaddr_in *from, const struct routing_snapshot *snapshot) {
+	ChordMessage msg = CHORD_MESSAGE__INIT;
+	msg.version = 417;
+	msg.has_query_id = message->has_query_id;
+	msg.query_id = message->query_id;
+
+	// Find successor
+	if (message->msg_case == CHORD_MESSAGE__MSG_FIND_SUCCESSOR_REQUEST) {
+		FindSuccessorRequest *successorRequest = message->find_successor_request;
+		int owned = element_of(successorRequest->key, snapshot->hash, snapshot->successor.key, 1); // id ∈ (n, successor]
+
+		// A cached owner probed directly answers for itself while it holds the key
+		if (successorRequest->probe && snapshot->predecessor.key != 0
+			&& element_of(successorRequest->key, snapshot->predecessor.key, snapshot->hash, 1)) {
+			Node selfNode = snapshot->self;
+
+			FindSuccessorResponse successorResponse = FIND_SUCCESSOR_RESPONSE__INIT;
+			successorResponse.node = &selfNode;
+			successorResponse.has_key = 1;
+			successorResponse.key = successorRequest->key;
+
+			msg.find_successor_response = &successorResponse;
+			msg.msg_case = CHORD_MESSAGE__MSG_FIND_SUCCESSOR_RESPONSE;
+
+			send_message(from, &msg, "Error sending find successor response");
+			return 1;
+		}
+
+		if (successorRequest->requester && !owned) {
+			return 0; // Routed lookups are forwarded by the main thread
+		}
+
+		Node predNode = owned ? snapshot->successor : routing_closest_preceding_node(snapshot, successorRequest->key);
+
+		FindSuccessorResponse successorResponse = FIND_SUCCESSOR_RESPONSE__INIT;
+		successorResponse.node = &predNode;
+
+		msg.find_successor_response = &successorResponse;
+		msg.msg_case = CHORD_MESSAGE__MSG_FIND_SUCCESSOR_RESPONSE;
+
+		if (successorRequest->requester) {
+			// Final answer of a routed lookup, tagged with its key and sent straight to the requester
+			successorResponse.has_key = 1;
+			successorResponse.key = successorRequest->key;
+			send_message_to_node(successorRequest->requester, &msg, "Error sending find successor response");
+		} else {
+			send_message(from, &msg, "Error sending find successor response");
+		}
+		return 1;
+	}
+
+	// Find successors
+	if (message->msg_case == CHORD_MESSAGE__MSG_FIND_SUCCESSORS_REQUEST) {
+		FindSuccessorsRequest *successorsRequest = message->find_successors_request;
+		size_t n_keys = successorsRequest->n_keys;
+
+		// One answer per key, in request order
+		Node *nodes = message_scratch(sizeof(Node) * n_keys);
+		Node **node_ptrs = message_scratch(sizeof(Node *) * n_keys);
+		for (size_t i = 0; i < n_keys; ++i) {
+			uint64_t key = successorsRequest->keys[i];
+			nodes[i] = element_of(key, snapshot->hash, snapshot->successor.key, 1) ? snapshot->successor
+				: routing_closest_preceding_node(snapshot, key);
+			node_ptrs[i] = &nodes[i];
+		}
+
+		FindSuccessorsResponse successorsResponse = FIND_SUCCESSORS_RESPONSE__INIT;
+		successorsResponse.n_keys = n_keys;
+		successorsResponse.keys = successorsRequest->keys;
+		successorsResponse.n_nodes = n_keys;
+		successorsResponse.nodes = node_ptrs;
+
+		msg.find_successors_response = &successorsResponse;
+		msg.msg_case = CHORD_MESSAGE__MSG_FIND_SUCCESSORS_RESPONSE;
+
+		send_message(from, &msg, "Error sending find successors response");
+		return 1;
+	}
+
+	// Get predecessor
+	if (message->msg_case == CHORD_MESSAGE__MSG_GET_PREDECESSOR_REQUEST) {
+		Node predNode = snapshot->predecessor;
+
+		GetPredecessorResponse predecessorResponse = GET_PREDECESSOR_RESPONSE__INIT;
+		predecessorResponse.node = &predNode;
+
+		msg.get_predecessor_response = &predecessorResponse;
+		msg.msg_case = CHORD_MESSAGE__MSG_GET_PREDECESSOR_RESPONSE;
+
+		send_message(from, &msg, "Error sending get predecessor response");
+		return 1;
+	}
+
+	// Check predecessor
+	if (message->msg_case == CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_REQUEST) {
+		CheckPredecessorResponse checkResponse = CHECK_PREDECESSOR_RESPONSE__INIT;
+
+		msg.check_predecessor_response = &checkResponse;
+		msg.msg_case = CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_RESPONSE;
+
+		send_message(from, &msg, "Error sending check predecessor response");
+		return 1;
+	}
+
+	// Get successor list
+	if (message->msg_case == CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_REQUEST) {
+		GetSuccessorListResponse listResponse = GET_SUCCESSOR_LIST_RESPONSE__INIT;
+
+		// Copy successor list and remove last entry
+		size_t num_entries = snapshot->num_successors - 1;
+		Node **successors = message_scratch(sizeof(Node*) * num_entries);
+
+		for (size_t i = 0; i < num_entries; ++i) {
+			successors[i] = (Node *)&snapshot->successor_list[i];
+		}
+
+		listResponse.n_successors = num_entries;
+		listResponse.successors = successors;
+
+		msg.get_successor_list_response = &listResponse;
+		msg.msg_case = CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_RESPONSE;
+
+		send_message(from, &msg, "Error sending get sucessor list response");
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,736 @@
+#define _GNU_SOURCE // recvmmsg(), sendmmsg()
+
+#include <stdio.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <time.h>
+#include <sys/socket.h>
+
+#include "chord.h"
+#include "chord_impl.h"
+#include "chord_arg_parser.h"
+#include "chord_rpc.h"
+#include "chord_arena.h"
+#include "chord_peer.h"
+#include "chord_stats.h"
+#include "chord_stream.h"
+#include "chord_timer.h"
+#include "chord_vnode.h"
+#include "chord_wire.h"
+#include "chord.pb-c.h"
+
+// Initial size of the arena decoded messages live in, grows if ever exceeded
+#define MESSAGE_ARENA_SIZE (4 * MAX_DATAGRAM_SIZE)
+
+// Outbound datagrams queued between flushes, and the bytes backing them
+#define SEND_QUEUE_LEN 64
+#define SEND_POOL_SIZE (4 * MAX_DATAGRAM_SIZE)
+
+// Control messages sharing a datagram, kept within a typical path MTU
+#define COALESCE_MAX_FRAMES 8
+#define COALESCE_MAX_BYTES 1400
+
+// One queued datagram, a gather list of length-prefixed frames in send_pool
+struct outbound {
+	struct sockaddr_in addr;
+	struct sockaddr_in from;        // Sending node, only filled in for a transport
+	int coalescible;
+	size_t size;
+	size_t n_frames;
+	struct iovec frames[COALESCE_MAX_FRAMES];
+	const char *error_msg;
+};
+
+struct pending_rpc {
+	int in_use;
+	int32_t query_id;
+	struct sockaddr_in addr;
+	ChordMessage__MsgCase expected_type;
+	struct timer timeout;
+	uint64_t sent_us;               // Monotonic, when the request was queued
+	int timed;                      // Answered by the peer itself, its round trip is a sample
+	int vnode;                      // Virtual node that made the call, active again for the callback
+	rpc_callback callback;
+	void *arg;
+};
+
+// Features peers advertised, direct-mapped by address and port: the low 48
+// bits of an entry name the peer, the top 8 hold its features, 0 is empty.
+// Shared by every thread, an entry is a whole word so a racing update merely
+// costs a message in the older format.
+#define RPC_FEATURE_PEERS 256
+#define RPC_FEATURE_SHIFT 56
+static uint64_t peer_features[RPC_FEATURE_PEERS];
+
+// Pending calls, slot = query_id & (RPC_MAX_PENDING - 1), owned by the main thread
+static struct pending_rpc pending[RPC_MAX_PENDING];
+static int32_t next_query_id = 1;
+static int cancelling = 0;          // rpc_cancel_all() is failing every call, none may start
+
+// Wire buffers of one socket, each thread that does I/O owns one
+struct rpc_io {
+	int fd;
+
+	// Receive slots and the arena messages are decoded into, one message at a time
+	uint8_t (*recv_slots)[MAX_DATAGRAM_SIZE];
+	struct mmsghdr recv_msgs[RECV_BATCH];
+	struct iovec recv_iovs[RECV_BATCH];
+	struct sockaddr_in recv_addrs[RECV_BATCH];
+	uint8_t recv_control[RECV_BATCH][CMSG_SPACE(sizeof(struct timespec))];
+	uint64_t recv_stamps[RECV_BATCH]; // Wall clock nanoseconds the kernel queued each datagram
+	struct arena message_arena;
+
+	// Queued datagrams stay in order, the pool is rewound once the queue empties
+	struct outbound send_queue[SEND_QUEUE_LEN];
+	size_t send_count;
+	uint8_t send_pool[SEND_POOL_SIZE];
+	size_t send_pool_used;
+
+	// A datagram rpc_inject() left for the next recv_batch()
+	int injected;
+};
+
+static __thread struct rpc_io *io;
+
+// Replaces the socket when set, see rpc_use_transport()
+static rpc_transport transport = NULL;
+
+// Small requests that are fine to share a datagram with others to the same peer
+static int is_control_message(ChordMessage *msg) {
+	return msg->msg_case == CHORD_MESSAGE__MSG_NOTIFY_REQUEST
+		|| msg->msg_case == CHORD_MESSAGE__MSG_GET_PREDECESSOR_REQUEST
+		|| msg->msg_case == CHORD_MESSAGE__MSG_GET_SUCCESSOR_LIST_REQUEST
+		|| msg->msg_case == CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_REQUEST
+		|| msg->msg_case == CHORD_MESSAGE__MSG_STABILIZE_REQUEST;
+}
+
+// Requests the addressed peer answers on its own, so the reply time is its
+// round trip. Routed lookups and key-value operations wait on further hops.
+static int is_timed_request(ChordMessage *msg) {
+	return is_control_message(msg)
+		|| (msg->msg_case == CHORD_MESSAGE__MSG_FIND_SUCCESSOR_REQUEST && !msg->find_successor_request->requester)
+		|| msg->msg_case == CHORD_MESSAGE__MSG_FIND_SUCCESSORS_REQUEST;
+}
+
+// Requests on behalf of lookups and applications, everything else keeps the
+// ring together or answers a call of ours
+static int is_client_request(ChordMessage__MsgCase type) {
+	return type == CHORD_MESSAGE__MSG_FIND_SUCCESSOR_REQUEST
+		|| type == CHORD_MESSAGE__MSG_FIND_SUCCESSORS_REQUEST
+		|| type == CHORD_MESSAGE__MSG_START_FIND_SUCCESSOR_REQUEST
+		|| type == CHORD_MESSAGE__MSG_PUT_REQUEST
+		|| type == CHORD_MESSAGE__MSG_GET_REQUEST
+		|| type == CHORD_MESSAGE__MSG_DELETE_REQUEST;
+}
+
+static uint64_t realtime_ns(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_REALTIME, &now);
+	return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+static uint64_t peer_tag(uint32_t address, uint32_t port) {
+	return (uint64_t)address << 16 | (uint16_t)port;
+}
+
+static uint64_t *features_entry(uint64_t tag) {
+	return &peer_features[((tag + 1) * 0x9E3779B97F4A7C15ULL) >> 56];
+}
+
+uint32_t rpc_peer_features(uint32_t address, uint32_t port) {
+	uint64_t tag = peer_tag(address, port);
+	uint64_t entry = __atomic_load_n(features_entry(tag), __ATOMIC_RELAXED);
+	return entry != 0 && (entry & ((1ULL << 48) - 1)) == tag ? (uint32_t)(entry >> RPC_FEATURE_SHIFT) : 0;
+}
+
+// Evicts whichever peer held the entry, but only clears the peer's own
+static void store_features(uint32_t address, uint32_t port, uint32_t features) {
+	uint64_t tag = peer_tag(address, port);
+	uint64_t value = (features & 0xFF) ? tag | (uint64_t)(features & 0xFF) << RPC_FEATURE_SHIFT : 0;
+
+	if (value != 0 || rpc_peer_features(address, port) != 0) {
+		uint64_t *entry = features_entry(tag);
+		if (__atomic_load_n(entry, __ATOMIC_RELAXED) != value) {
+			__atomic_store_n(entry, value, __ATOMIC_RELAXED);
+		}
+	}
+}
+
+void rpc_forget_features(uint32_t address, uint32_t port, uint32_t features) {
+	uint32_t known = rpc_peer_features(address, port);
+	if (known & features) {
+		store_features(address, port, known & ~features);
+	}
+}
+
+// Notes what the sender of message accepts. Every message offers it, so
+// one that does not comes from a node that knows none of the features.
+static void learn_features(const ChordMessage *message, const struct sockaddr_in *from) {
+	if (message->has_features) {
+		store_features(from->sin_addr.s_addr, from->sin_port, message->features);
+	} else {
+		rpc_forget_features(from->sin_addr.s_addr, from->sin_port, UINT32_MAX);
+	}
+}
+
+// Offered on every message, a peer may only be sent what it has seen offered
+static void advertise_features(ChordMessage *msg) {
+	msg->has_features = 1;
+	msg->features = WIRE_FEATURE_STABILIZE | WIRE_FEATURE_COALESCE | (chord_args.compact ? WIRE_FEATURE_COMPACT : 0)
+		| (chord_args.stream ? WIRE_FEATURE_STREAM : 0);
+}
+
+// Compact if addr is known to accept it
+static int choose_compact(struct sockaddr_in *addr, ChordMessage *msg) {
+	return chord_args.compact && wire_compact_encodable(msg)
+		&& (rpc_peer_features(addr->sin_addr.s_addr, addr->sin_port) & WIRE_FEATURE_COMPACT);
+}
+
+// Bytes msg takes on the wire, length prefix included for protobuf
+static size_t frame_size(ChordMessage *msg, int compact) {
+	return compact ? wire_compact_size(msg->msg_case) : sizeof(uint64_t) + chord_message__get_packed_size(msg);
+}
+
+// Packs msg as a frame of total_size bytes at the end of the send pool,
+// protobuf behind its 8-byte length prefix unless compact
+static uint8_t *pack_chord_message(ChordMessage *msg, int compact, size_t total_size) {
+	if (total_size > MAX_DATAGRAM_SIZE) {
+		fprintf(stderr, "Message of %zu bytes does not fit in a datagram\n", total_size - sizeof(uint64_t));
+		return NULL;
+	}
+
+	if (total_size > SEND_POOL_SIZE - io->send_pool_used) {
+		return NULL;
+	}
+
+	uint8_t *buffer = io->send_pool + io->send_pool_used;
+	io->send_pool_used += total_size;
+
+	if (compact) {
+		wire_compact_pack(msg, buffer);
+		return buffer;
+	}
+
+	uint64_t networkLen = htobe64(total_size - sizeof(uint64_t));
+	memcpy(buffer, &networkLen, sizeof(networkLen));
+	chord_message__pack(msg, buffer + sizeof(networkLen));
+
+	return buffer;
+}
+
+// Finds a queued control datagram from and to the same addresses with room for one more frame
+static struct outbound *find_coalesce_target(struct sockaddr_in *addr, struct sockaddr_in *from, size_t size) {
+	for (size_t i = io->send_count; i-- > 0;) {
+		struct outbound *out = &io->send_queue[i];
+
+		if (out->coalescible && out->n_frames < COALESCE_MAX_FRAMES && out->size + size <= COALESCE_MAX_BYTES
+			&& out->addr.sin_addr.s_addr == addr->sin_addr.s_addr && out->addr.sin_port == addr->sin_port
+			&& out->from.sin_addr.s_addr == from->sin_addr.s_addr && out->from.sin_port == from->sin_port) {
+			return out;
+		}
+	}
+	return NULL;
+}
+
+// Counts the first sent datagrams of the queue as gone out
+static void count_sent(size_t sent) {
+	uint64_t bytes = 0;
+	for (size_t i = 0; i < sent; ++i) {
+		bytes += io->send_queue[i].size;
+	}
+	stats_add(STATS_DATAGRAMS_OUT, sent);
+	stats_add(STATS_BYTES_OUT, bytes);
+}
+
+static void drop_sent(size_t sent) {
+	io->send_count -= sent;
+	memmove(io->send_queue, io->send_queue + sent, sizeof(struct outbound) * io->send_count);
+
+	if (io->send_count == 0) {
+		io->send_pool_used = 0;
+	}
+}
+
+void rpc_flush(void) {
+	struct mmsghdr msgs[SEND_QUEUE_LEN];
+
+	if (transport) {
+		for (size_t i = 0; i < io->send_count; ++i) {
+			struct outbound *out = &io->send_queue[i];
+			transport(&out->from, &out->addr, out->frames, out->n_frames);
+		}
+		count_sent(io->send_count);
+		drop_sent(io->send_count);
+		return;
+	}
+
+	while (io->send_count > 0) {
+		for (size_t i = 0; i < io->send_count; ++i) {
+			msgs[i] = (struct mmsghdr) {.msg_hdr = {
+				.msg_name = &io->send_queue[i].addr,
+				.msg_namelen = sizeof(struct sockaddr_in),
+				.msg_iov = io->send_queue[i].frames,
+				.msg_iovlen = io->send_queue[i].n_frames,
+			}};
+		}
+
+		int sent = sendmmsg(io->fd, msgs, io->send_count, MSG_DONTWAIT);
+		if (sent > 0) {
+			count_sent(sent);
+			drop_sent(sent);
+		} else if (errno == EINTR) {
+			continue;
+		} else if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+			// Socket buffer is full, keep the rest queued until it drains
+			return;
+		} else {
+			// Only the head datagram failed, report it and carry on with the others
+			if (io->send_queue[0].error_msg) {
+				fprintf(stderr, "%s\n", io->send_queue[0].error_msg);
+			}
+			perror("sendmmsg()");
+			drop_sent(1);
+		}
+	}
+}
+
+int rpc_output_pending(void) {
+	return io->send_count > 0;
+}
+
+int send_message(struct sockaddr_in *addr, ChordMessage *msg, const char *error_msg) {
+	// A peer that reads one frame per datagram would lose the others
+	int coalescible = is_control_message(msg)
+		&& (rpc_peer_features(addr->sin_addr.s_addr, addr->sin_port) & WIRE_FEATURE_COALESCE);
+	advertise_features(msg);
+	int compact = choose_compact(addr, msg);
+	size_t size = frame_size(msg, compact);
+
+	// Too large for one unfragmented datagram, the peer's stream takes it
+	if (size > STREAM_MIN_FRAME && !transport && stream_available()
+		&& (rpc_peer_features(addr->sin_addr.s_addr, addr->sin_port) & WIRE_FEATURE_STREAM)
+		&& stream_send(addr, msg, size - sizeof(uint64_t)) == 0) {
+		stats_message_out(msg->msg_case);
+		return 0;
+	}
+
+	// A transport carries many nodes' traffic, each datagram names its sender
+	struct sockaddr_in from = {0};
+	if (transport) {
+		from.sin_family = AF_INET;
+		from.sin_addr.s_addr = self.address;
+		from.sin_port = self.port;
+	}
+
+	if (io->send_count == SEND_QUEUE_LEN || io->send_pool_used > SEND_POOL_SIZE - MAX_DATAGRAM_SIZE) {
+		rpc_flush();
+	}
+
+	struct outbound *out = coalescible ? find_coalesce_target(addr, &from, size) : NULL;
+	if (!out && io->send_count == SEND_QUEUE_LEN) {
+		if (error_msg) {
+			fprintf(stderr, "%s: send queue full\n", error_msg);
+		}
+		return -1;
+	}
+
+	uint8_t *buffer = pack_chord_message(msg, compact, size);
+	if (!buffer) {
+		if (error_msg) {
+			fprintf(stderr, "%s: message dropped\n", error_msg);
+		}
+		return -1;
+	}
+
+	if (!out) {
+		out = &io->send_queue[io->send_count++];
+		*out = (struct outbound) {.addr = *addr, .from = from, .coalescible = coalescible, .error_msg = error_msg};
+	}
+
+	out->frames[out->n_frames++] = (struct iovec) {.iov_base = buffer, .iov_len = size};
+	out->size += size;
+	stats_message_out(msg->msg_case);
+	return 0;
+}
+
+int rpc_init(int fd) {
+	io = calloc(1, sizeof(*io));
+	if (!io) {
+		return -1;
+	}
+
+	io->fd = fd;
+
+	// Receive times come from the kernel, so time spent in the socket buffer counts
+	int on = 1;
+	setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on));
+
+	io->recv_slots = malloc(sizeof(*io->recv_slots) * RECV_BATCH);
+	if (!io->recv_slots || arena_init(&io->message_arena, MESSAGE_ARENA_SIZE) != 0) {
+		free(io->recv_slots);
+		free(io);
+		io = NULL;
+		return -1;
+	}
+	return 0;
+}
+
+void rpc_destroy(void) {
+	if (io) {
+		arena_destroy(&io->message_arena);
+		free(io->recv_slots);
+		free(io);
+		io = NULL;
+	}
+}
+
+void rpc_use_transport(rpc_transport deliver) {
+	transport = deliver;
+}
+
+void rpc_inject(const struct sockaddr_in *from, const uint8_t *data, size_t len) {
+	if (len > MAX_DATAGRAM_SIZE) {
+		return;
+	}
+
+	memcpy(io->recv_slots[0], data, len);
+	io->recv_addrs[0] = *from;
+	io->recv_msgs[0].msg_len = len;
+	io->recv_msgs[0].msg_hdr.msg_flags = 0;
+	io->recv_stamps[0] = realtime_ns();
+	io->injected = 1;
+}
+
+static size_t count_received(size_t received) {
+	uint64_t bytes = 0;
+	for (size_t i = 0; i < received; ++i) {
+		bytes += io->recv_msgs[i].msg_len;
+	}
+	stats_add(STATS_DATAGRAMS_IN, received);
+	stats_add(STATS_BYTES_IN, bytes);
+	return received;
+}
+
+size_t recv_batch(void) {
+	if (io->injected) {
+		io->injected = 0;
+		return count_received(1);
+	}
+
+	for (int i = 0; i < RECV_BATCH; ++i) {
+		io->recv_iovs[i] = (struct iovec) {.iov_base = io->recv_slots[i], .iov_len = MAX_DATAGRAM_SIZE};
+		io->recv_msgs[i].msg_hdr = (struct msghdr) {
+			.msg_name = &io->recv_addrs[i],
+			.msg_namelen = sizeof(io->recv_addrs[i]),
+			.msg_iov = &io->recv_iovs[i],
+			.msg_iovlen = 1,
+			.msg_control = io->recv_control[i],
+			.msg_controllen = sizeof(io->recv_control[i]),
+		};
+	}
+
+	int received = recvmmsg(io->fd, io->recv_msgs, RECV_BATCH, MSG_DONTWAIT, NULL);
+	if (received <= 0) {
+		return 0;
+	}
+
+	// Datagrams the kernel did not stamp count as just received
+	uint64_t now = realtime_ns();
+	for (int i = 0; i < received; ++i) {
+		struct msghdr *hdr = &io->recv_msgs[i].msg_hdr;
+		io->recv_stamps[i] = now;
+
+		for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(hdr); cmsg; cmsg = CMSG_NXTHDR(hdr, cmsg)) {
+			if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+				struct timespec stamp;
+				memcpy(&stamp, CMSG_DATA(cmsg), sizeof(stamp));
+				io->recv_stamps[i] = (uint64_t)stamp.tv_sec * 1000000000 + stamp.tv_nsec;
+			}
+		}
+	}
+	return count_received(received);
+}
+
+int recv_frame(size_t slot, size_t *offset, struct sockaddr_in *from, const uint8_t **frame, size_t *frame_len) {
+	const uint8_t *datagram = io->recv_slots[slot];
+	size_t received = io->recv_msgs[slot].msg_len;
+
+	*from = io->recv_addrs[slot];
+
+	if (io->recv_msgs[slot].msg_hdr.msg_flags & MSG_TRUNC) {
+		return 0;
+	}
+	if (*offset >= received) {
+		return 0;
+	}
+
+	// Compact frames carry their own size, see chord_wire.h
+	if (datagram[*offset] == WIRE_COMPACT_MAGIC) {
+		size_t size = wire_compact_frame(datagram + *offset, received - *offset);
+		if (size == 0) {
+			return 0;
+		}
+		*frame = datagram + *offset;
+		*frame_len = size;
+		*offset += size;
+		return 1;
+	}
+
+	if (received - *offset < sizeof(uint64_t)) {
+		return 0;
+	}
+
+	// Length prefix comes from the datagram itself, anything it overstates is dropped
+	uint64_t messageLenSize;
+	memcpy(&messageLenSize, datagram + *offset, sizeof(messageLenSize));
+	messageLenSize = be64toh(messageLenSize);
+
+	size_t start = *offset + sizeof(uint64_t);
+	if (messageLenSize > received - start) {
+		return 0;
+	}
+
+	*frame = datagram + start;
+	*frame_len = messageLenSize;
+	*offset = start + messageLenSize;
+	return 1;
+}
+
+ChordMessage *decode_message(const uint8_t *data, size_t len) {
+	// A protobuf message starts with the tag of its version, never the magic
+	ChordMessage *message = len > 0 && data[0] == WIRE_COMPACT_MAGIC
+		? wire_compact_unpack(data, len, &io->message_arena)
+		: chord_message__unpack(&io->message_arena.allocator, len, data);
+	if (!message) {
+		arena_reset(&io->message_arena);
+	}
+	return message;
+}
+
+ChordMessage *recv_message(size_t slot, size_t *offset, struct sockaddr_in *from, enum rpc_class class) {
+	const uint8_t *frame;
+	size_t frame_len;
+
+	while (recv_frame(slot, offset, from, &frame, &frame_len)) {
+		if (rpc_frame_class(frame, frame_len) != class) {
+			continue;
+		}
+
+		ChordMessage *message = decode_message(frame, frame_len);
+		if (!message) {
+			return NULL;
+		}
+		rpc_received(message, from);
+
+		if (!rpc_shed(slot, message, from)) {
+			return message;
+		}
+		release_message();
+	}
+	return NULL;
+}
+
+enum rpc_class rpc_frame_class(const uint8_t *frame, size_t len) {
+	return is_client_request(wire_peek_type(frame, len)) ? RPC_CLASS_CLIENT : RPC_CLASS_MAINTENANCE;
+}
+
+static void send_busy(ChordMessage *request, const struct sockaddr_in *from) {
+	BusyResponse busyResponse = BUSY_RESPONSE__INIT;
+
+	ChordMessage msg = CHORD_MESSAGE__INIT;
+	msg.version = 417;
+	msg.has_query_id = request->has_query_id;
+	msg.query_id = request->query_id;
+	msg.busy_response = &busyResponse;
+	msg.msg_case = CHORD_MESSAGE__MSG_BUSY_RESPONSE;
+
+	// A routed lookup is answered to whoever started it, so is its refusal
+	if (request->msg_case == CHORD_MESSAGE__MSG_FIND_SUCCESSOR_REQUEST && request->find_successor_request->requester) {
+		send_message_to_node(request->find_successor_request->requester, &msg, "Error sending busy response");
+		return;
+	}
+
+	struct sockaddr_in addr = *from;
+	send_message(&addr, &msg, "Error sending busy response");
+}
+
+int rpc_shed(size_t slot, ChordMessage *message, const struct sockaddr_in *from) {
+	if (!is_client_request(message->msg_case)) {
+		return 0;
+	}
+
+	uint64_t now = realtime_ns();
+	uint64_t waited_ms = now > io->recv_stamps[slot] ? (now - io->recv_stamps[slot]) / 1000000 : 0;
+
+	if (waited_ms >= RPC_DEADLINE_MS) {
+		stats_add(STATS_REQUESTS_DROPPED, 1);
+		return 1;
+	}
+	if (waited_ms >= RPC_BUSY_AFTER_MS) {
+		send_busy(message, from);
+		stats_add(STATS_REQUESTS_BUSY, 1);
+		return 1;
+	}
+	return 0;
+}
+
+void rpc_received(const ChordMessage *message, const struct sockaddr_in *from) {
+	stats_message_in(message->msg_case);
+	learn_features(message, from);
+}
+
+void *message_scratch(size_t size) {
+	return arena_alloc(&io->message_arena, size);
+}
+
+void release_message(void) {
+	arena_reset(&io->message_arena);
+}
+
+int send_message_to_node(Node *node, ChordMessage *msg, const char *error_msg) {
+	struct sockaddr_in node_addr;
+	node_addr.sin_family = AF_INET;
+	node_addr.sin_port = node->port;
+	node_addr.sin_addr = (struct in_addr) {.s_addr = node->address};
+
+	msg->has_target = 1;
+	msg->target = node->key;
+	return send_message(&node_addr, msg, error_msg);
+}
+
+// Releases the slot before running the callback so it can issue the next call
+static void finish(struct pending_rpc *slot, MessageResponse *response) {
+	if (response->type != CHORD_MESSAGE__MSG__NOT_SET) {
+		uint64_t elapsed_us = monotonic_us() - slot->sent_us;
+		stats_observe(STATS_RPC_LATENCY_US, elapsed_us);
+		if (slot->timed) {
+			peer_rtt_sample(slot->addr.sin_addr.s_addr, slot->addr.sin_port, elapsed_us);
+		}
+	}
+
+	rpc_callback callback = slot->callback;
+	void *arg = slot->arg;
+
+	timer_cancel(&slot->timeout);
+	slot->in_use = 0;
+	vnode_activate(slot->vnode);
+	callback(response, arg);
+}
+
+static void rpc_timeout(void *arg) {
+	MessageResponse response = {.type = CHORD_MESSAGE__MSG__NOT_SET};
+	stats_add(STATS_RPC_TIMEOUTS, 1);
+	finish(arg, &response);
+}
+
+int rpc_call_addr(struct sockaddr_in *addr, ChordMessage *msg, ChordMessage__MsgCase expected_type,
+                  rpc_callback callback, void *arg) {
+	struct pending_rpc *slot = NULL;
+	if (cancelling) {
+		return -1;
+	}
+
+	// Skip ids whose slot is still held by an older call
+	for (int i = 0; i < RPC_MAX_PENDING; ++i) {
+		int32_t id = next_query_id++;
+		if (next_query_id <= 0) {
+			next_query_id = 1;
+		}
+
+		struct pending_rpc *candidate = &pending[id & (RPC_MAX_PENDING - 1)];
+		if (!candidate->in_use) {
+			slot = candidate;
+			slot->query_id = id;
+			break;
+		}
+	}
+
+	if (!slot) {
+		fprintf(stderr, "Too many pending requests\n");
+		return -1;
+	}
+
+	slot->in_use = 1;
+	slot->addr = *addr;
+	slot->expected_type = expected_type;
+	slot->sent_us = monotonic_us();
+	slot->timed = is_timed_request(msg);
+	slot->vnode = vnode_active();
+	slot->callback = callback;
+	slot->arg = arg;
+
+	msg->has_query_id = 1;
+	msg->query_id = slot->query_id;
+	if (send_message(addr, msg, NULL) != 0) {
+		slot->in_use = 0;
+		return -1;
+	}
+
+	timer_init(&slot->timeout, rpc_timeout, slot);
+	timer_schedule(&slot->timeout, RPC_TIMEOUT_MS);
+	stats_add(STATS_RPC_CALLS, 1);
+	return 0;
+}
+
+void rpc_cancel_all(void) {
+	MessageResponse response = {.type = CHORD_MESSAGE__MSG__NOT_SET};
+
+	cancelling = 1;
+	for (int i = 0; i < RPC_MAX_PENDING; ++i) {
+		if (pending[i].in_use) {
+			finish(&pending[i], &response);
+		}
+	}
+	cancelling = 0;
+}
+
+int rpc_call(Node *node, ChordMessage *msg, ChordMessage__MsgCase expected_type,
+             rpc_callback callback, void *arg) {
+	struct sockaddr_in node_addr;
+	node_addr.sin_family = AF_INET;
+	node_addr.sin_port = node->port;
+	node_addr.sin_addr = (struct in_addr) {.s_addr = node->address};
+
+	msg->has_target = 1;
+	msg->target = node->key;
+	return rpc_call_addr(&node_addr, msg, expected_type, callback, arg);
+}
+
+
+// A busy peer may turn down any request
+static int accepts(const struct pending_rpc *slot, const MessageResponse *response) {
+	return slot->expected_type == response->type || response->type == CHORD_MESSAGE__MSG_BUSY_RESPONSE;
+}
+
+int rpc_complete(ChordMessage *message, struct sockaddr_in *from, MessageResponse *response) {
+	if (message->has_query_id) {
+		struct pending_rpc *slot = &pending[message->query_id & (RPC_MAX_PENDING - 1)];
+
+		if (slot->in_use && slot->query_id == message->query_id && accepts(slot, response)) {
+			finish(slot, response);
+			return 1;
+		}
+		return 0;
+	}
+
+	// Peer does not echo query_id, fall back to the oldest matching call
+	struct pending_rpc *oldest = NULL;
+	for (int i = 0; i < RPC_MAX_PENDING; ++i) {
+		struct pending_rpc *slot = &pending[i];
+
+		if (slot->in_use && accepts(slot, response)
+			&& slot->addr.sin_addr.s_addr == from->sin_addr.s_addr && slot->addr.sin_port == from->sin_port
+			&& (!oldest || slot->query_id - oldest->query_id < 0)) {
+			oldest = slot;
+		}
+	}
+
+	if (oldest) {
+		finish(oldest, response);
+		return 1;
+	}
+	return 0;
+}
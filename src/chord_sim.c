@@ -0,0 +1,570 @@
+// Simulator: runs many Chord nodes in one process over a simulated network
+// and clock. Every node is a virtual node with an address of its own, the
+// handlers, stabilize(), fix_fingers() and check_predecessor() are the
+// ones the chord binary runs. Time jumps straight to the next timer or
+// delivery, so a run takes as long as its events do to process.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <arpa/inet.h>
+
+#include "chord.h"
+#include "chord_arg_parser.h"
+#include "chord_impl.h"
+#include "chord_routing.h"
+#include "chord_rpc.h"
+#include "chord_timer.h"
+#include "chord_vnode.h"
+#include "chord.pb-c.h"
+
+// Hosts are 10.0.0.1 and up, all on the same port
+#define SIM_BASE_ADDRESS 0x0A000001
+#define SIM_PORT 4000
+
+// The clock starts here, 0 reads as never to the peer table
+#define SIM_EPOCH_US 1000000
+
+struct sim_options {
+	int n_nodes;
+	double seconds;         // Simulated time to run for
+	int join_interval_ms;   // Between two of the initial joins
+	int min_latency_ms;     // One-way delay, fixed per pair of hosts
+	int max_latency_ms;
+	double loss;            // Fraction of datagrams dropped
+	double churn;           // Nodes replaced per simulated minute
+	int lookups;            // Issued per check
+	int check_interval_ms;
+	uint64_t seed;
+};
+
+struct sim_host {
+	struct sockaddr_in addr;
+	int up;                 // Started and not killed
+	struct timer stabilize;
+	struct timer fix_fingers;
+	struct timer check_predecessor;
+};
+
+// A datagram on its way, the network is a heap ordered by arrival
+struct delivery {
+	uint64_t at_us;
+	uint64_t seq;           // Ties go to the one sent first
+	int from;
+	int to;
+	size_t len;
+	uint8_t *data;
+};
+
+struct sim_stats {
+	uint64_t sent;
+	uint64_t delivered;
+	uint64_t lost;          // By the loss rate
+	uint64_t dead;          // To or from a host that is down
+	uint64_t lookups_ok;
+	uint64_t lookups_wrong;
+	uint64_t lookups_failed;
+};
+
+static struct sim_options options = {
+	.n_nodes = 1000,
+	.seconds = 120,
+	.join_interval_ms = 20,
+	.min_latency_ms = 5,
+	.max_latency_ms = 50,
+	.loss = 0,
+	.churn = 0,
+	.lookups = 100,
+	.check_interval_ms = 1000,
+	.seed = 1,
+};
+
+static uint64_t now_us = SIM_EPOCH_US;
+static uint64_t rng;
+
+static struct sim_host *hosts;
+static int n_hosts = 0;         // Capacity, initial nodes plus every replacement churn brings
+static int n_started = 0;
+
+static struct delivery *heap;
+static size_t heap_len = 0, heap_cap = 0;
+static uint64_t next_seq = 0;
+
+static struct sim_stats stats;
+
+// Keys of the joined hosts that are up, sorted, as of the last check
+static uint64_t *truth;
+static int n_truth = 0;
+
+static struct timer join_timer;
+static struct timer churn_timer;
+static struct timer check_timer;
+static double converged_successors = -1;
+static double converged_fingers = -1;
+
+static uint64_t sim_clock(void) {
+	return now_us;
+}
+
+// xorshift64*, seeded from the command line so every run can be repeated
+static uint64_t next_random(void) {
+	rng ^= rng >> 12;
+	rng ^= rng << 25;
+	rng ^= rng >> 27;
+	return rng * 0x2545F4914F6CDD1DULL;
+}
+
+static double next_uniform(void) {
+	return (next_random() >> 11) * 0x1.0p-53;
+}
+
+static int host_of(const struct sockaddr_in *addr) {
+	int64_t index = (int64_t)ntohl(addr->sin_addr.s_addr) - SIM_BASE_ADDRESS;
+	if (addr->sin_port != htons(SIM_PORT) || index < 0 || index >= n_hosts) {
+		return -1;
+	}
+	return (int)index;
+}
+
+// Symmetric and fixed per pair, so proximity routing has something to find
+static uint64_t latency_us(int a, int b) {
+	uint64_t low = a < b ? a : b, high = a < b ? b : a;
+	uint64_t mix = ((low << 32) | high) * 0x9E3779B97F4A7C15ULL;
+	mix ^= mix >> 29;
+	uint64_t span = (uint64_t)(options.max_latency_ms - options.min_latency_ms) * 1000;
+	return (uint64_t)options.min_latency_ms * 1000 + (span ? mix % (span + 1) : 0);
+}
+
+static int earlier(const struct delivery *a, const struct delivery *b) {
+	return a->at_us < b->at_us || (a->at_us == b->at_us && a->seq < b->seq);
+}
+
+static void heap_push(struct delivery delivery) {
+	if (heap_len == heap_cap) {
+		heap_cap = heap_cap ? heap_cap * 2 : 1024;
+		heap = realloc(heap, sizeof(*heap) * heap_cap);
+		if (!heap) {
+			fprintf(stderr, "Out of memory\n");
+			exit(1);
+		}
+	}
+
+	size_t i = heap_len++;
+	while (i > 0 && earlier(&delivery, &heap[(i - 1) / 2])) {
+		heap[i] = heap[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	heap[i] = delivery;
+}
+
+static struct delivery heap_pop(void) {
+	struct delivery top = heap[0];
+	struct delivery last = heap[--heap_len];
+
+	size_t i = 0;
+	for (;;) {
+		size_t child = 2 * i + 1;
+		if (child >= heap_len) {
+			break;
+		}
+		if (child + 1 < heap_len && earlier(&heap[child + 1], &heap[child])) {
+			child++;
+		}
+		if (!earlier(&heap[child], &last)) {
+			break;
+		}
+		heap[i] = heap[child];
+		i = child;
+	}
+	if (heap_len > 0) {
+		heap[i] = last;
+	}
+	return top;
+}
+
+static void transmit(const struct sockaddr_in *from, const struct sockaddr_in *to,
+                     const struct iovec *frames, size_t n_frames) {
+	int source = host_of(from), destination = host_of(to);
+	stats.sent++;
+
+	// Timeouts of a killed host still fire, whatever they send goes nowhere
+	if (source < 0 || destination < 0 || !hosts[source].up) {
+		stats.dead++;
+		return;
+	}
+	if (options.loss > 0 && next_uniform() < options.loss) {
+		stats.lost++;
+		return;
+	}
+
+	size_t len = 0;
+	for (size_t i = 0; i < n_frames; ++i) {
+		len += frames[i].iov_len;
+	}
+	uint8_t *data = malloc(len);
+	if (!data) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+	len = 0;
+	for (size_t i = 0; i < n_frames; ++i) {
+		memcpy(data + len, frames[i].iov_base, frames[i].iov_len);
+		len += frames[i].iov_len;
+	}
+
+	heap_push((struct delivery) {
+		.at_us = now_us + latency_us(source, destination),
+		.seq = next_seq++,
+		.from = source,
+		.to = destination,
+		.len = len,
+		.data = data,
+	});
+}
+
+static void deliver(struct delivery *delivery) {
+	if (hosts[delivery->to].up) {
+		stats.delivered++;
+		rpc_inject(&hosts[delivery->from].addr, delivery->data, delivery->len);
+		process_chord_msg();
+	} else {
+		stats.dead++;
+	}
+	free(delivery->data);
+}
+
+// Maintenance rounds of one host, as the chord binary schedules them
+static void stabilize_tick(void *arg) {
+	int index = (int)(intptr_t)arg;
+	if (vnode_get(index)->joined) {
+		vnode_activate(index);
+		stabilize();
+	}
+	timer_schedule(&hosts[index].stabilize, chord_args.stablize_period * 100);
+}
+
+static void fix_fingers_tick(void *arg) {
+	int index = (int)(intptr_t)arg;
+	if (vnode_get(index)->joined) {
+		vnode_activate(index);
+		fix_fingers();
+	}
+	timer_schedule(&hosts[index].fix_fingers, chord_args.fix_fingers_period * 100);
+}
+
+static void check_predecessor_tick(void *arg) {
+	int index = (int)(intptr_t)arg;
+	if (vnode_get(index)->joined) {
+		vnode_activate(index);
+		check_predecessor();
+	}
+	timer_schedule(&hosts[index].check_predecessor, chord_args.check_predecessor_period * 100);
+}
+
+static void start_host(int index) {
+	struct sim_host *host = &hosts[index];
+	host->up = 1;
+
+	vnode_activate(index);
+	if (index == 0) {
+		create();
+		successor_list[0] = successor;
+		joined = 1;
+	} else {
+		join();
+	}
+
+	// Staggered within the period, so rounds do not all land on the same tick
+	void *arg = (void *)(intptr_t)index;
+	timer_init(&host->stabilize, stabilize_tick, arg);
+	timer_init(&host->fix_fingers, fix_fingers_tick, arg);
+	timer_init(&host->check_predecessor, check_predecessor_tick, arg);
+	timer_schedule(&host->stabilize, 1 + next_random() % (chord_args.stablize_period * 100));
+	timer_schedule(&host->fix_fingers, 1 + next_random() % (chord_args.fix_fingers_period * 100));
+	timer_schedule(&host->check_predecessor, 1 + next_random() % (chord_args.check_predecessor_period * 100));
+}
+
+static void kill_host(int index) {
+	struct sim_host *host = &hosts[index];
+	host->up = 0;
+	timer_cancel(&host->stabilize);
+	timer_cancel(&host->fix_fingers);
+	timer_cancel(&host->check_predecessor);
+}
+
+static void join_tick(void *arg) {
+	(void)arg;
+	start_host(n_started++);
+	if (n_started < options.n_nodes) {
+		timer_schedule(&join_timer, options.join_interval_ms);
+	}
+}
+
+// One host leaves without warning and a new one, with a new key, joins
+static void churn_tick(void *arg) {
+	(void)arg;
+	if (n_started == n_hosts) {
+		return;
+	}
+
+	int up = 0;
+	for (int i = 1; i < n_started; ++i) {
+		up += hosts[i].up;
+	}
+	if (up > 0) {
+		// Host 0 stays, everyone joins through it
+		int victim = next_random() % up;
+		for (int i = 1; i < n_started; ++i) {
+			if (hosts[i].up && victim-- == 0) {
+				kill_host(i);
+				break;
+			}
+		}
+	}
+	start_host(n_started++);
+
+	timer_schedule(&churn_timer, (uint64_t)(60000 / options.churn));
+}
+
+static int compare_keys(const void *a, const void *b) {
+	uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+	return (x > y) - (x < y);
+}
+
+static void build_truth(void) {
+	n_truth = 0;
+	for (int i = 0; i < n_started; ++i) {
+		if (hosts[i].up && vnode_get(i)->joined) {
+			truth[n_truth++] = vnode_get(i)->hash;
+		}
+	}
+	qsort(truth, n_truth, sizeof(uint64_t), compare_keys);
+}
+
+// First key at or after id, around the ring
+static uint64_t true_owner(uint64_t id) {
+	int low = 0, high = n_truth;
+	while (low < high) {
+		int mid = low + (high - low) / 2;
+		if (truth[mid] < id) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+	return truth[low < n_truth ? low : 0];
+}
+
+static int is_live(uint64_t key) {
+	return n_truth > 0 && true_owner(key) == key;
+}
+
+// Any live node in [n + 2^j, n + 2^(j+1)) will do, proximity routing picks among them
+static int finger_valid(const struct vnode_state *state, int j) {
+	uint64_t start = state->hash + ((uint64_t)1 << j);
+	uint64_t end = j + 1 < M ? state->hash + ((uint64_t)1 << (j + 1)) : state->hash;
+	uint64_t key = state->finger_table[j].key;
+
+	if (key == true_owner(start)) {
+		return 1;
+	}
+	return is_live(key) && key - start < end - start;
+}
+
+static void lookup_done(Node *node, void *arg) {
+	uint64_t key = (uint64_t)(uintptr_t)arg;
+
+	if (!node) {
+		stats.lookups_failed++;
+	} else if (n_truth > 0 && node->key == true_owner(key)) {
+		stats.lookups_ok++;
+	} else {
+		stats.lookups_wrong++;
+	}
+}
+
+// Measures how far the tables are from the real ring, then starts the next lookups
+static void check_tick(void *arg) {
+	(void)arg;
+	build_truth();
+
+	uint64_t good_successors = 0, good_fingers = 0;
+	for (int i = 0; i < n_started && n_truth > 0; ++i) {
+		if (!hosts[i].up || !vnode_get(i)->joined) {
+			continue;
+		}
+		const struct vnode_state *state = vnode_get(i);
+
+		good_successors += state->successor.key == true_owner(state->hash + 1);
+		for (int j = 0; j < M; ++j) {
+			good_fingers += finger_valid(state, j);
+		}
+	}
+
+	double seconds = (now_us - SIM_EPOCH_US) / 1e6;
+	double successors_pct = n_truth ? 100.0 * good_successors / n_truth : 0;
+	double fingers_pct = n_truth ? 100.0 * good_fingers / ((uint64_t)n_truth * M) : 0;
+
+	// Only once every initial node is in does a correct ring count as converged
+	if (n_started >= options.n_nodes && n_truth > 0) {
+		if (converged_successors < 0 && good_successors == (uint64_t)n_truth) {
+			converged_successors = seconds;
+		}
+		if (converged_fingers < 0 && good_fingers == (uint64_t)n_truth * M) {
+			converged_fingers = seconds;
+		}
+	}
+
+	printf("t %8.1f s joined %5d successors %6.2f%% fingers %6.2f%% lookups ok %" PRIu64
+	       " wrong %" PRIu64 " failed %" PRIu64 "\n", seconds, n_truth, successors_pct, fingers_pct,
+	       stats.lookups_ok, stats.lookups_wrong, stats.lookups_failed);
+
+	for (int i = 0; i < options.lookups && n_truth > 0; ++i) {
+		int origin = next_random() % n_started;
+		if (!hosts[origin].up || !vnode_get(origin)->joined) {
+			continue;
+		}
+
+		uint64_t key = next_random();
+		vnode_activate(origin);
+		find_successor_parallel(key, chord_args.lookup_alpha, lookup_done, (void *)(uintptr_t)key);
+	}
+
+	timer_schedule(&check_timer, options.check_interval_ms);
+}
+
+static void usage(const char *name) {
+	fprintf(stderr,
+	        "Usage: %s [-n nodes] [-t seconds] [-j join interval ms] [-l min latency ms]\n"
+	        "          [-L max latency ms] [-x loss fraction] [-c churn per minute]\n"
+	        "          [-q lookups per check] [-i check interval ms] [-s seed] [-- chord options]\n", name);
+	exit(1);
+}
+
+static void parse_options(int argc, char *argv[]) {
+	int opt;
+	while ((opt = getopt(argc, argv, "n:t:j:l:L:x:c:q:i:s:h")) != -1) {
+		switch (opt) {
+		case 'n': options.n_nodes = atoi(optarg); break;
+		case 't': options.seconds = atof(optarg); break;
+		case 'j': options.join_interval_ms = atoi(optarg); break;
+		case 'l': options.min_latency_ms = atoi(optarg); break;
+		case 'L': options.max_latency_ms = atoi(optarg); break;
+		case 'x': options.loss = atof(optarg); break;
+		case 'c': options.churn = atof(optarg); break;
+		case 'q': options.lookups = atoi(optarg); break;
+		case 'i': options.check_interval_ms = atoi(optarg); break;
+		case 's': options.seed = strtoull(optarg, NULL, 10); break;
+		default: usage(argv[0]);
+		}
+	}
+
+	if (options.n_nodes < 1 || options.seconds <= 0 || options.join_interval_ms < 1
+		|| options.min_latency_ms < 0 || options.max_latency_ms < options.min_latency_ms
+		|| options.loss < 0 || options.loss >= 1 || options.churn < 0
+		|| options.lookups < 0 || options.check_interval_ms < 1) {
+		usage(argv[0]);
+	}
+
+	// Nodes take the chord binary's own options, from sensible defaults
+	char *defaults[] = {argv[0], "-p", "4000", "--sp", "5", "--ffp", "5", "--cpp", "5", "-r", "3"};
+	int n_defaults = sizeof(defaults) / sizeof(defaults[0]);
+	int n_args = n_defaults + argc - optind;
+	char **args = malloc(sizeof(char *) * (n_args + 1));
+	memcpy(args, defaults, sizeof(defaults));
+	memcpy(args + n_defaults, argv + optind, sizeof(char *) * (argc - optind));
+	args[n_args] = NULL;
+	chord_args = chord_parseopt(n_args, args);
+	free(args);
+}
+
+int main(int argc, char *argv[]) {
+	parse_options(argc, argv);
+	rng = options.seed * 0x9E3779B97F4A7C15ULL + 1;
+
+	n_hosts = options.n_nodes + (int)(options.churn * options.seconds / 60) + 1;
+	if (n_hosts > VNODE_MAX) {
+		fprintf(stderr, "At most %d nodes, churn included\n", VNODE_MAX);
+		exit(1);
+	}
+
+	hosts = calloc(n_hosts, sizeof(*hosts));
+	truth = malloc(sizeof(uint64_t) * n_hosts);
+	struct sockaddr_in *addrs = malloc(sizeof(*addrs) * n_hosts);
+	if (!hosts || !truth || !addrs) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+	for (int i = 0; i < n_hosts; ++i) {
+		addrs[i] = (struct sockaddr_in) {.sin_family = AF_INET, .sin_port = htons(SIM_PORT),
+		                                 .sin_addr.s_addr = htonl(SIM_BASE_ADDRESS + i)};
+		hosts[i].addr = addrs[i];
+	}
+
+	timer_use_clock(sim_clock);
+	rpc_use_transport(transmit);
+	if (rpc_init(-1) != 0 || vnode_init_hosts(n_hosts, addrs) != 0) {
+		fprintf(stderr, "Failed to set up the simulated nodes\n");
+		exit(1);
+	}
+	free(addrs);
+	chord_args.join_address = hosts[0].addr;
+	routing_publish();
+
+	timer_init(&join_timer, join_tick, NULL);
+	timer_init(&churn_timer, churn_tick, NULL);
+	timer_init(&check_timer, check_tick, NULL);
+	join_tick(NULL);
+	timer_schedule(&check_timer, options.check_interval_ms);
+	if (options.churn > 0) {
+		timer_schedule(&churn_timer, (uint64_t)(60000 / options.churn));
+	}
+
+	struct timespec wall_start, wall_end;
+	clock_gettime(CLOCK_MONOTONIC, &wall_start);
+
+	uint64_t end_us = SIM_EPOCH_US + (uint64_t)(options.seconds * 1e6);
+	for (;;) {
+		rpc_flush();
+		routing_publish();
+
+		// Timers are in whole ms, one due in the current ms fires on the next
+		int64_t timeout = timers_next_timeout();
+		uint64_t timer_at = timeout < 0 ? UINT64_MAX : (now_us / 1000 + (timeout > 0 ? timeout : 1)) * 1000;
+		uint64_t delivery_at = heap_len > 0 ? heap[0].at_us : UINT64_MAX;
+
+		uint64_t next = timer_at < delivery_at ? timer_at : delivery_at;
+		if (next == UINT64_MAX || next > end_us) {
+			break;
+		}
+		if (next > now_us) {
+			now_us = next;
+		}
+
+		if (delivery_at <= timer_at) {
+			struct delivery delivery = heap_pop();
+			deliver(&delivery);
+		} else {
+			timers_run();
+		}
+	}
+	now_us = end_us;
+
+	clock_gettime(CLOCK_MONOTONIC, &wall_end);
+	double wall = (wall_end.tv_sec - wall_start.tv_sec) + (wall_end.tv_nsec - wall_start.tv_nsec) / 1e9;
+
+	check_tick(NULL);
+	printf("Simulated %.1f s in %.2f s (%.0fx), %d nodes started\n",
+	       options.seconds, wall, wall > 0 ? options.seconds / wall : 0, n_started);
+	printf("Datagrams sent %" PRIu64 " delivered %" PRIu64 " lost %" PRIu64 " to or from dead hosts %" PRIu64 "\n",
+	       stats.sent, stats.delivered, stats.lost, stats.dead);
+	if (converged_successors >= 0) {
+		printf("Successors converged at %.1f s\n", converged_successors);
+	}
+	if (converged_fingers >= 0) {
+		printf("Fingers converged at %.1f s\n", converged_fingers);
+	}
+	return 0;
+}
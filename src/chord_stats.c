@@ -0,0 +1,337 @@
+#define _GNU_SOURCE // accept4(), memmem()
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include "chord_rpc.h"
+#include "chord_stats.h"
+#include "chord.pb-c.h"
+
+// Counters of one thread, written by it alone
+struct stats_shard {
+	uint64_t counters[STATS_COUNTERS];
+	uint64_t messages_in[STATS_MESSAGE_TYPES];
+	uint64_t messages_out[STATS_MESSAGE_TYPES];
+	struct stats_histogram_totals histograms[STATS_HISTOGRAMS];
+} __attribute__((aligned(64)));
+
+static struct stats_shard shards[STATS_MAX_SHARDS];
+static int n_shards = 0;
+static __thread struct stats_shard *shard = NULL;
+static __thread int shared = 0; // Counting into the last shard along with other threads
+
+static const char *counter_names[STATS_COUNTERS] = {
+	[STATS_DATAGRAMS_IN] = "chord_datagrams_in_total",
+	[STATS_DATAGRAMS_OUT] = "chord_datagrams_out_total",
+	[STATS_BYTES_IN] = "chord_bytes_in_total",
+	[STATS_BYTES_OUT] = "chord_bytes_out_total",
+	[STATS_RPC_CALLS] = "chord_rpc_calls_total",
+	[STATS_RPC_TIMEOUTS] = "chord_rpc_timeouts_total",
+	[STATS_LOOKUPS] = "chord_lookups_total",
+	[STATS_LOOKUPS_FAILED] = "chord_lookups_failed_total",
+	[STATS_STABILIZE_ROUNDS] = "chord_stabilize_rounds_total",
+	[STATS_FIX_FINGERS_ROUNDS] = "chord_fix_fingers_rounds_total",
+	[STATS_SUCCESSOR_CHANGES] = "chord_successor_changes_total",
+	[STATS_PREDECESSOR_CHANGES] = "chord_predecessor_changes_total",
+	[STATS_FINGER_CHANGES] = "chord_finger_changes_total",
+	[STATS_REQUESTS_BUSY] = "chord_requests_busy_total",
+	[STATS_REQUESTS_DROPPED] = "chord_requests_dropped_total",
+};
+
+static const char *histogram_names[STATS_HISTOGRAMS] = {
+	[STATS_RPC_LATENCY_US] = "chord_rpc_latency_us",
+	[STATS_LOOKUP_LATENCY_US] = "chord_lookup_latency_us",
+	[STATS_LOOKUP_HOPS] = "chord_lookup_hops",
+};
+
+static int is_linear(enum stats_histogram histogram) {
+	return histogram == STATS_LOOKUP_HOPS;
+}
+
+static struct stats_shard *own_shard(void) {
+	if (!shard) {
+		// The last shard is kept for threads that find the others taken
+		int slot = __atomic_fetch_add(&n_shards, 1, __ATOMIC_RELAXED);
+		if (slot >= STATS_MAX_SHARDS - 1) {
+			slot = STATS_MAX_SHARDS - 1;
+			shared = 1;
+		}
+		shard = &shards[slot];
+	}
+	return shard;
+}
+
+// A single writer needs no read-modify-write, only stores readers cannot see torn
+static void bump(uint64_t *counter, uint64_t n) {
+	if (shared) {
+		__atomic_fetch_add(counter, n, __ATOMIC_RELAXED);
+	} else {
+		__atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + n, __ATOMIC_RELAXED);
+	}
+}
+
+static int message_index(ChordMessage__MsgCase type) {
+	return type > 0 && type < STATS_MESSAGE_TYPES ? (int)type : 0;
+}
+
+void stats_add(enum stats_counter counter, uint64_t n) {
+	bump(&own_shard()->counters[counter], n);
+}
+
+void stats_message_in(ChordMessage__MsgCase type) {
+	bump(&own_shard()->messages_in[message_index(type)], 1);
+}
+
+void stats_message_out(ChordMessage__MsgCase type) {
+	bump(&own_shard()->messages_out[message_index(type)], 1);
+}
+
+void stats_observe(enum stats_histogram histogram, uint64_t value) {
+	int bucket;
+	if (is_linear(histogram)) {
+		bucket = value < STATS_BUCKETS ? (int)value : STATS_BUCKETS - 1;
+	} else {
+		bucket = value == 0 ? 0 : 64 - __builtin_clzll(value);
+		bucket = bucket < STATS_BUCKETS ? bucket : STATS_BUCKETS - 1;
+	}
+
+	struct stats_histogram_totals *totals = &own_shard()->histograms[histogram];
+	bump(&totals->buckets[bucket], 1);
+	bump(&totals->count, 1);
+	bump(&totals->sum, value);
+}
+
+static void sum(uint64_t *total, const uint64_t *counters, size_t n) {
+	for (size_t i = 0; i < n; ++i) {
+		total[i] += __atomic_load_n(&counters[i], __ATOMIC_RELAXED);
+	}
+}
+
+void stats_collect(struct stats_totals *totals) {
+	memset(totals, 0, sizeof(*totals));
+
+	// Shards no thread took are all zeros, summing them is cheaper than tracking them
+	for (int i = 0; i < STATS_MAX_SHARDS; ++i) {
+		const struct stats_shard *source = &shards[i];
+		sum(totals->counters, source->counters, STATS_COUNTERS);
+		sum(totals->messages_in, source->messages_in, STATS_MESSAGE_TYPES);
+		sum(totals->messages_out, source->messages_out, STATS_MESSAGE_TYPES);
+		for (int h = 0; h < STATS_HISTOGRAMS; ++h) {
+			sum(totals->histograms[h].buckets, source->histograms[h].buckets, STATS_BUCKETS);
+			sum(&totals->histograms[h].count, &source->histograms[h].count, 1);
+			sum(&totals->histograms[h].sum, &source->histograms[h].sum, 1);
+		}
+	}
+}
+
+// Appends to a buffer snprintf-style, counting what would not fit
+struct text {
+	char *buffer;
+	size_t size;
+	size_t len;
+};
+
+static void append(struct text *text, const char *format, ...) {
+	va_list args;
+	va_start(args, format);
+	size_t room = text->len < text->size ? text->size - text->len : 0;
+	int written = vsnprintf(text->buffer + (room ? text->len : 0), room, format, args);
+	va_end(args);
+
+	if (written > 0) {
+		text->len += written;
+	}
+}
+
+static void format_messages(struct text *text, const char *name, const char *help, const uint64_t *counts) {
+	append(text, "# HELP %s %s\n# TYPE %s counter\n", name, help, name);
+
+	// Every message field of ChordMessage is a member of the msg oneof
+	for (unsigned i = 0; i < chord_message__descriptor.n_fields; ++i) {
+		const ProtobufCFieldDescriptor *field = &chord_message__descriptor.fields[i];
+		if (field->type == PROTOBUF_C_TYPE_MESSAGE && field->id < STATS_MESSAGE_TYPES) {
+			append(text, "%s{type=\"%s\"} %" PRIu64 "\n", name, field->name, counts[field->id]);
+		}
+	}
+}
+
+static void format_histogram(struct text *text, const char *name, const struct stats_histogram_totals *histogram,
+                             int linear) {
+	append(text, "# TYPE %s histogram\n", name);
+
+	// Bucket i holds values up to i, or up to 2^i - 1, the last one is unbounded
+	uint64_t cumulative = 0;
+	for (int i = 0; i < STATS_BUCKETS - 1; ++i) {
+		cumulative += histogram->buckets[i];
+		uint64_t bound = linear ? (uint64_t)i : ((uint64_t)1 << i) - 1;
+		append(text, "%s_bucket{le=\"%" PRIu64 "\"} %" PRIu64 "\n", name, bound, cumulative);
+	}
+	append(text, "%s_bucket{le=\"+Inf\"} %" PRIu64 "\n", name, histogram->count);
+	append(text, "%s_sum %" PRIu64 "\n%s_count %" PRIu64 "\n", name, histogram->sum, name, histogram->count);
+}
+
+size_t stats_format(char *buffer, size_t size) {
+	struct stats_totals totals;
+	stats_collect(&totals);
+
+	struct text text = {buffer, size, 0};
+	if (size > 0) {
+		buffer[0] = '\0';
+	}
+
+	for (int i = 0; i < STATS_COUNTERS; ++i) {
+		append(&text, "# TYPE %s counter\n%s %" PRIu64 "\n", counter_names[i], counter_names[i], totals.counters[i]);
+	}
+	format_messages(&text, "chord_messages_in_total", "Messages decoded, by type", totals.messages_in);
+	format_messages(&text, "chord_messages_out_total", "Messages queued to send, by type", totals.messages_out);
+	for (int i = 0; i < STATS_HISTOGRAMS; ++i) {
+		format_histogram(&text, histogram_names[i], &totals.histograms[i], is_linear(i));
+	}
+	return text.len;
+}
+
+// Repeated fields stop at the last non-zero entry
+static size_t used_length(const uint64_t *values, size_t n) {
+	while (n > 0 && values[n - 1] == 0) {
+		n--;
+	}
+	return n;
+}
+
+static void fill_histogram(Histogram *message, struct stats_histogram_totals *histogram) {
+	message->n_buckets = used_length(histogram->buckets, STATS_BUCKETS);
+	message->buckets = histogram->buckets;
+	message->count = histogram->count;
+	message->sum = histogram->sum;
+}
+
+int stats_handle_request(ChordMessage *message, struct sockaddr_in *from) {
+	if (message->msg_case != CHORD_MESSAGE__MSG_STATS_REQUEST) {
+		return 0;
+	}
+
+	struct stats_totals totals;
+	stats_collect(&totals);
+
+	Histogram rpc_latency = HISTOGRAM__INIT, lookup_latency = HISTOGRAM__INIT, lookup_hops = HISTOGRAM__INIT;
+	fill_histogram(&rpc_latency, &totals.histograms[STATS_RPC_LATENCY_US]);
+	fill_histogram(&lookup_latency, &totals.histograms[STATS_LOOKUP_LATENCY_US]);
+	fill_histogram(&lookup_hops, &totals.histograms[STATS_LOOKUP_HOPS]);
+
+	Stats stats = STATS__INIT;
+	stats.n_messages_in = used_length(totals.messages_in, STATS_MESSAGE_TYPES);
+	stats.messages_in = totals.messages_in;
+	stats.n_messages_out = used_length(totals.messages_out, STATS_MESSAGE_TYPES);
+	stats.messages_out = totals.messages_out;
+	stats.datagrams_in = totals.counters[STATS_DATAGRAMS_IN];
+	stats.datagrams_out = totals.counters[STATS_DATAGRAMS_OUT];
+	stats.bytes_in = totals.counters[STATS_BYTES_IN];
+	stats.bytes_out = totals.counters[STATS_BYTES_OUT];
+	stats.rpc_calls = totals.counters[STATS_RPC_CALLS];
+	stats.rpc_timeouts = totals.counters[STATS_RPC_TIMEOUTS];
+	stats.rpc_latency_us = &rpc_latency;
+	stats.lookups = totals.counters[STATS_LOOKUPS];
+	stats.lookups_failed = totals.counters[STATS_LOOKUPS_FAILED];
+	stats.lookup_latency_us = &lookup_latency;
+	stats.lookup_hops = &lookup_hops;
+	stats.stabilize_rounds = totals.counters[STATS_STABILIZE_ROUNDS];
+	stats.fix_fingers_rounds = totals.counters[STATS_FIX_FINGERS_ROUNDS];
+	stats.successor_changes = totals.counters[STATS_SUCCESSOR_CHANGES];
+	stats.predecessor_changes = totals.counters[STATS_PREDECESSOR_CHANGES];
+	stats.finger_changes = totals.counters[STATS_FINGER_CHANGES];
+	stats.has_requests_busy = 1;
+	stats.requests_busy = totals.counters[STATS_REQUESTS_BUSY];
+	stats.has_requests_dropped = 1;
+	stats.requests_dropped = totals.counters[STATS_REQUESTS_DROPPED];
+
+	StatsResponse response = STATS_RESPONSE__INIT;
+	response.stats = &stats;
+
+	ChordMessage msg = CHORD_MESSAGE__INIT;
+	msg.version = 417;
+	msg.has_query_id = message->has_query_id;
+	msg.query_id = message->query_id;
+	msg.stats_response = &response;
+	msg.msg_case = CHORD_MESSAGE__MSG_STATS_RESPONSE;
+
+	send_message(from, &msg, "Error sending stats response");
+	return 1;
+}
+
+int stats_listen(struct sockaddr_in *addr) {
+	int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd < 0) {
+		perror("Failed to create stats socket");
+		return -1;
+	}
+
+	int opt = 1;
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+	if (bind(fd, (struct sockaddr *)addr, sizeof(*addr)) < 0 || listen(fd, 16) < 0) {
+		perror("Failed to open stats endpoint");
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+// Reads until the end of the request headers, so closing does not reset the connection
+static void read_request(int fd) {
+	char request[1024];
+	size_t len = 0;
+
+	while (len < sizeof(request)) {
+		ssize_t n = recv(fd, request + len, sizeof(request) - len, 0);
+		if (n <= 0) {
+			return;
+		}
+		len += n;
+		if (memmem(request, len, "\r\n\r\n", 4) || memmem(request, len, "\n\n", 2)) {
+			return;
+		}
+	}
+}
+
+static void send_all(int fd, const char *data, size_t len) {
+	while (len > 0) {
+		ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+		if (n <= 0) {
+			return;
+		}
+		data += n;
+		len -= n;
+	}
+}
+
+void stats_serve(int listen_fd) {
+	static char body[64 * 1024];
+
+	int fd;
+	while ((fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC)) >= 0) {
+		struct timeval timeout = {.tv_sec = 0, .tv_usec = STATS_SCRAPE_TIMEOUT_MS * 1000};
+		setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+		setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+		read_request(fd);
+
+		size_t len = stats_format(body, sizeof(body));
+		if (len >= sizeof(body)) {
+			len = sizeof(body) - 1;
+		}
+
+		char header[160];
+		int header_len = snprintf(header, sizeof(header),
+		                          "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n"
+		                          "Content-Length: %zu\r\nConnection: close\r\n\r\n", len);
+		send_all(fd, header, header_len);
+		send_all(fd, body, len);
+		close(fd);
+	}
+}
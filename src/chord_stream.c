@@ -0,0 +1,439 @@
+#define _GNU_SOURCE // accept4()
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <endian.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <netinet/in.h>
+
+#include "chord_rpc.h"
+#include "chord_stream.h"
+#include "chord_timer.h"
+#include "chord_wire.h"
+
+// How often idle connections are looked for
+#define STREAM_SWEEP_MS 10000
+
+// One connection, keyed by the address the peer receives datagrams on
+struct stream_conn {
+	int fd;                     // -1 if the entry is free
+	struct sockaddr_in peer;    // Unknown (port 0) until an inbound hello arrived
+	int connecting;             // Outbound connect() still in progress
+	int watching_output;        // EPOLLOUT is armed
+	int dispatching;            // Its messages are being handled, not to be evicted
+	uint64_t last_used;         // Monotonic ms
+
+	uint8_t *out;               // Queued bytes are [out_sent, out_len)
+	size_t out_len, out_sent, out_cap;
+
+	uint8_t *in;                // Received bytes not yet handled, [0, in_len)
+	size_t in_len, in_cap;
+};
+
+static struct stream_conn conns[STREAM_MAX_CONNS];
+static int listen_fd = -1;
+static int reactor_fd = -1;
+static __thread int owner = 0;
+static struct timer sweep_timer;
+
+static int same_peer(const struct sockaddr_in *a, const struct sockaddr_in *b) {
+	return a->sin_addr.s_addr == b->sin_addr.s_addr && a->sin_port == b->sin_port;
+}
+
+static void conn_close(struct stream_conn *conn) {
+	close(conn->fd); // Leaves the epoll set with it
+	free(conn->out);
+	free(conn->in);
+	*conn = (struct stream_conn) {.fd = -1};
+}
+
+// A free entry, or the least recently used one with nothing queued
+static struct stream_conn *conn_alloc(void) {
+	struct stream_conn *victim = NULL;
+
+	for (int i = 0; i < STREAM_MAX_CONNS; ++i) {
+		struct stream_conn *conn = &conns[i];
+		if (conn->fd < 0) {
+			return conn;
+		}
+		if (conn->out_sent == conn->out_len && !conn->dispatching && (!victim || conn->last_used < victim->last_used)) {
+			victim = conn;
+		}
+	}
+
+	if (victim) {
+		conn_close(victim);
+	}
+	return victim;
+}
+
+static struct stream_conn *conn_find(const struct sockaddr_in *peer) {
+	for (int i = 0; i < STREAM_MAX_CONNS; ++i) {
+		if (conns[i].fd >= 0 && conns[i].peer.sin_port != 0 && same_peer(&conns[i].peer, peer)) {
+			return &conns[i];
+		}
+	}
+	return NULL;
+}
+
+static int conn_watch(struct stream_conn *conn, int op, int output) {
+	struct epoll_event event = {.events = EPOLLIN | (output ? EPOLLOUT : 0), .data.fd = conn->fd};
+	conn->watching_output = output;
+	return epoll_ctl(reactor_fd, op, conn->fd, &event);
+}
+
+// Makes room for len more bytes of output, dropping what was already sent
+static uint8_t *out_reserve(struct stream_conn *conn, size_t len) {
+	if (conn->out_sent > 0) {
+		memmove(conn->out, conn->out + conn->out_sent, conn->out_len - conn->out_sent);
+		conn->out_len -= conn->out_sent;
+		conn->out_sent = 0;
+	}
+
+	if (conn->out_len + len > conn->out_cap) {
+		size_t cap = conn->out_cap ? conn->out_cap : 65536;
+		while (cap < conn->out_len + len) {
+			cap *= 2;
+		}
+		uint8_t *out = realloc(conn->out, cap);
+		if (!out) {
+			return NULL;
+		}
+		conn->out = out;
+		conn->out_cap = cap;
+	}
+
+	uint8_t *space = conn->out + conn->out_len;
+	conn->out_len += len;
+	return space;
+}
+
+static struct stream_conn *conn_open(const struct sockaddr_in *peer) {
+	struct stream_conn *conn = conn_alloc();
+	if (!conn) {
+		return NULL;
+	}
+
+	int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd < 0) {
+		perror("Failed to create stream socket");
+		return NULL;
+	}
+
+	*conn = (struct stream_conn) {.fd = fd, .peer = *peer, .last_used = monotonic_ms()};
+	if (connect(fd, (const struct sockaddr *)peer, sizeof(*peer)) < 0) {
+		if (errno != EINPROGRESS) {
+			rpc_forget_features(peer->sin_addr.s_addr, peer->sin_port, WIRE_FEATURE_STREAM);
+			conn_close(conn);
+			return NULL;
+		}
+		conn->connecting = 1;
+	}
+
+	// Our datagram port, the address the peer sees the connection come from
+	struct sockaddr_in self_addr;
+	socklen_t self_len = sizeof(self_addr);
+	uint8_t *hello = out_reserve(conn, STREAM_HELLO_SIZE);
+	if (!hello || getsockname(listen_fd, (struct sockaddr *)&self_addr, &self_len) < 0
+		|| conn_watch(conn, EPOLL_CTL_ADD, 1) < 0) {
+		conn_close(conn);
+		return NULL;
+	}
+	memcpy(hello, STREAM_HELLO_MAGIC, 4);
+	memcpy(hello + 4, &self_addr.sin_port, sizeof(self_addr.sin_port));
+	hello[6] = hello[7] = 0;
+
+	return conn;
+}
+
+static void sweep(void *arg) {
+	(void)arg;
+
+	uint64_t now = monotonic_ms();
+	for (int i = 0; i < STREAM_MAX_CONNS; ++i) {
+		struct stream_conn *conn = &conns[i];
+		if (conn->fd >= 0 && conn->out_sent == conn->out_len && now - conn->last_used >= STREAM_IDLE_MS) {
+			conn_close(conn);
+		}
+	}
+	timer_schedule(&sweep_timer, STREAM_SWEEP_MS);
+}
+
+int stream_init(const struct sockaddr_in *addr, int epfd) {
+	for (int i = 0; i < STREAM_MAX_CONNS; ++i) {
+		conns[i].fd = -1;
+	}
+
+	listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (listen_fd < 0) {
+		perror("Failed to create stream socket");
+		return -1;
+	}
+
+	int opt = 1;
+	setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+	struct epoll_event event = {.events = EPOLLIN, .data.fd = listen_fd};
+	if (bind(listen_fd, (const struct sockaddr *)addr, sizeof(*addr)) < 0 || listen(listen_fd, 64) < 0
+		|| epoll_ctl(epfd, EPOLL_CTL_ADD, listen_fd, &event) < 0) {
+		perror("Failed to open stream port");
+		close(listen_fd);
+		listen_fd = -1;
+		return -1;
+	}
+
+	reactor_fd = epfd;
+	owner = 1;
+	timer_init(&sweep_timer, sweep, NULL);
+	timer_schedule(&sweep_timer, STREAM_SWEEP_MS);
+	return 0;
+}
+
+void stream_destroy(void) {
+	if (listen_fd < 0) {
+		return;
+	}
+
+	for (int i = 0; i < STREAM_MAX_CONNS; ++i) {
+		if (conns[i].fd >= 0) {
+			conn_close(&conns[i]);
+		}
+	}
+	timer_cancel(&sweep_timer);
+	close(listen_fd);
+	listen_fd = -1;
+	owner = 0;
+}
+
+int stream_available(void) {
+	return owner;
+}
+
+int stream_send(const struct sockaddr_in *addr, ChordMessage *msg, size_t size) {
+	if (size > STREAM_MAX_FRAME) {
+		fprintf(stderr, "Message of %zu bytes is too large for a stream\n", size);
+		return -1;
+	}
+
+	struct stream_conn *conn = conn_find(addr);
+	if (!conn && !(conn = conn_open(addr))) {
+		return -1;
+	}
+
+	// A peer that stopped reading is not worth more memory
+	if (conn->out_len - conn->out_sent + sizeof(uint64_t) + size > STREAM_MAX_QUEUED) {
+		return -1;
+	}
+
+	uint8_t *frame = out_reserve(conn, sizeof(uint64_t) + size);
+	if (!frame) {
+		return -1;
+	}
+
+	uint64_t networkLen = htobe64(size);
+	memcpy(frame, &networkLen, sizeof(networkLen));
+	chord_message__pack(msg, frame + sizeof(networkLen));
+	conn->last_used = monotonic_ms();
+	return 0;
+}
+
+// Writes until the socket buffer is full, -1 if the connection broke
+static int conn_write(struct stream_conn *conn) {
+	while (conn->out_sent < conn->out_len) {
+		ssize_t n = send(conn->fd, conn->out + conn->out_sent, conn->out_len - conn->out_sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+		if (n > 0) {
+			conn->out_sent += n;
+		} else if (n < 0 && errno == EINTR) {
+			continue;
+		} else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			break;
+		} else {
+			return -1;
+		}
+	}
+
+	if (conn->out_sent == conn->out_len) {
+		conn->out_len = conn->out_sent = 0;
+	}
+
+	// Only wait for writability while a backlog is queued
+	int backlog = conn->out_sent < conn->out_len;
+	if (backlog != conn->watching_output) {
+		conn_watch(conn, EPOLL_CTL_MOD, backlog);
+	}
+	return 0;
+}
+
+void stream_flush(void) {
+	for (int i = 0; i < STREAM_MAX_CONNS; ++i) {
+		struct stream_conn *conn = &conns[i];
+		if (conn->fd >= 0 && !conn->connecting && conn->out_sent < conn->out_len && conn_write(conn) < 0) {
+			conn_close(conn);
+		}
+	}
+}
+
+static void accept_all(void) {
+	while (1) {
+		struct sockaddr_in from;
+		socklen_t from_len = sizeof(from);
+		int fd = accept4(listen_fd, (struct sockaddr *)&from, &from_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0) {
+			return;
+		}
+
+		struct stream_conn *conn = conn_alloc();
+		if (!conn) {
+			close(fd);
+			continue;
+		}
+
+		// The port stays unknown until the hello names it
+		*conn = (struct stream_conn) {.fd = fd, .peer = from, .last_used = monotonic_ms()};
+		conn->peer.sin_port = 0;
+		if (conn_watch(conn, EPOLL_CTL_ADD, 0) < 0) {
+			conn_close(conn);
+		}
+	}
+}
+
+/**
+ * @brief Handles every whole frame received so far.
+ *
+ * @return int 0 to keep the connection, -1 if the peer broke the protocol
+ */
+static int conn_dispatch(struct stream_conn *conn, stream_handler handler) {
+	size_t pos = 0;
+
+	if (conn->peer.sin_port == 0) {
+		if (conn->in_len < STREAM_HELLO_SIZE) {
+			return 0;
+		}
+		if (memcmp(conn->in, STREAM_HELLO_MAGIC, 4) != 0) {
+			return -1;
+		}
+		memcpy(&conn->peer.sin_port, conn->in + 4, sizeof(conn->peer.sin_port));
+		if (conn->peer.sin_port == 0) {
+			return -1;
+		}
+
+		// One connection per peer, a newer one replaces the older
+		struct stream_conn *older = conn_find(&conn->peer);
+		if (older && older != conn && older->out_sent == older->out_len) {
+			conn_close(older);
+		}
+		pos = STREAM_HELLO_SIZE;
+	}
+
+	while (conn->in_len - pos >= sizeof(uint64_t)) {
+		uint64_t len;
+		memcpy(&len, conn->in + pos, sizeof(len));
+		len = be64toh(len);
+		if (len > STREAM_MAX_FRAME) {
+			return -1;
+		}
+		if (conn->in_len - pos - sizeof(uint64_t) < len) {
+			break;
+		}
+
+		const uint8_t *frame = conn->in + pos + sizeof(uint64_t);
+		pos += sizeof(uint64_t) + len;
+
+		ChordMessage *message = decode_message(frame, len);
+		if (!message) {
+			return -1;
+		}
+		rpc_received(message, &conn->peer);
+		conn->dispatching = 1;
+		handler(message, conn->peer);
+		conn->dispatching = 0;
+		release_message();
+	}
+
+	memmove(conn->in, conn->in + pos, conn->in_len - pos);
+	conn->in_len -= pos;
+	return 0;
+}
+
+// Reads at most STREAM_READ_BUDGET, -1 once the connection is done
+static int conn_read(struct stream_conn *conn, stream_handler handler) {
+	size_t budget = STREAM_READ_BUDGET;
+
+	while (budget > 0) {
+		// Whole frames are handled as they complete, so this stays within one frame and a read
+		if (conn->in_cap - conn->in_len < 65536) {
+			size_t cap = conn->in_cap ? conn->in_cap * 2 : 2 * 65536;
+			uint8_t *in = realloc(conn->in, cap);
+			if (!in) {
+				return -1;
+			}
+			conn->in = in;
+			conn->in_cap = cap;
+		}
+
+		size_t want = conn->in_cap - conn->in_len < budget ? conn->in_cap - conn->in_len : budget;
+		ssize_t n = recv(conn->fd, conn->in + conn->in_len, want, MSG_DONTWAIT);
+		if (n > 0) {
+			conn->in_len += n;
+			budget -= n;
+			if (conn_dispatch(conn, handler) < 0) {
+				return -1;
+			}
+		} else if (n < 0 && errno == EINTR) {
+			continue;
+		} else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			break;
+		} else {
+			return -1;
+		}
+	}
+
+	conn->last_used = monotonic_ms();
+	return 0;
+}
+
+int stream_handle(int fd, uint32_t events, stream_handler handler) {
+	if (fd < 0) {
+		return 0;
+	}
+	if (fd == listen_fd) {
+		accept_all();
+		return 1;
+	}
+
+	struct stream_conn *conn = NULL;
+	for (int i = 0; i < STREAM_MAX_CONNS && !conn; ++i) {
+		if (conns[i].fd == fd) {
+			conn = &conns[i];
+		}
+	}
+	if (!conn) {
+		return 0;
+	}
+
+	if (conn->connecting && (events & (EPOLLOUT | EPOLLERR | EPOLLHUP))) {
+		int error = 0;
+		socklen_t len = sizeof(error);
+		if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len) < 0 || error != 0) {
+			// Peer does not take streams after all, its queued messages are lost and
+			// the retries go out as datagrams
+			rpc_forget_features(conn->peer.sin_addr.s_addr, conn->peer.sin_port, WIRE_FEATURE_STREAM);
+			conn_close(conn);
+			return 1;
+		}
+		conn->connecting = 0;
+	}
+
+	if ((events & (EPOLLIN | EPOLLHUP | EPOLLERR)) && conn_read(conn, handler) < 0) {
+		conn_close(conn);
+		return 1;
+	}
+	if (!conn->connecting && (events & EPOLLOUT) && conn_write(conn) < 0) {
+		conn_close(conn);
+	}
+	return 1;
+}
@@ -0,0 +1,208 @@
+#include <stdlib.h>
+#include <time.h>
+
+#include "chord_timer.h"
+
+// 4 levels of 64 slots with 1 ms ticks cover ~4.6 hours, longer timers re-cascade
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS (1 << WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS 4
+#define WHEEL_RANGE (1ULL << (WHEEL_BITS * WHEEL_LEVELS))
+
+static struct timer *wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+static uint64_t occupied[WHEEL_LEVELS]; // Bit per non-empty slot
+static uint64_t wheel_now;              // Last tick processed
+static int wheel_started = 0;
+static size_t n_timers = 0;
+
+// Replaces CLOCK_MONOTONIC when set, see timer_use_clock()
+static uint64_t (*clock_us)(void) = NULL;
+
+uint64_t monotonic_ms(void) {
+	if (clock_us) {
+		return clock_us() / 1000;
+	}
+
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+uint64_t monotonic_us(void) {
+	if (clock_us) {
+		return clock_us();
+	}
+
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+void timer_use_clock(uint64_t (*now_us)(void)) {
+	clock_us = now_us;
+}
+
+static void wheel_unlink(struct timer *timer) {
+	if (timer->prev) {
+		timer->prev->next = timer->next;
+	} else {
+		wheel[timer->level][timer->slot] = timer->next;
+		if (!timer->next) {
+			occupied[timer->level] &= ~(1ULL << timer->slot);
+		}
+	}
+	if (timer->next) {
+		timer->next->prev = timer->prev;
+	}
+
+	timer->level = -1;
+	timer->next = timer->prev = NULL;
+	n_timers--;
+}
+
+// Level by distance from wheel_now, slot by the expiry bits of that level
+static void wheel_insert(struct timer *timer) {
+	uint64_t expires = timer->expires > wheel_now ? timer->expires : wheel_now + 1;
+	uint64_t delta = expires - wheel_now;
+
+	if (delta >= WHEEL_RANGE) {
+		expires = wheel_now + WHEEL_RANGE - 1;
+		delta = WHEEL_RANGE - 1;
+	}
+
+	int level = 0;
+	while (delta >= (1ULL << (WHEEL_BITS * (level + 1)))) {
+		level++;
+	}
+	int slot = (expires >> (WHEEL_BITS * level)) & WHEEL_MASK;
+
+	timer->level = level;
+	timer->slot = slot;
+	timer->prev = NULL;
+	timer->next = wheel[level][slot];
+	if (timer->next) {
+		timer->next->prev = timer;
+	}
+	wheel[level][slot] = timer;
+	occupied[level] |= 1ULL << slot;
+	n_timers++;
+}
+
+// Moves a higher-level slot down now that its block of time has come up
+static void cascade(int level, int slot) {
+	struct timer *timer;
+
+	while ((timer = wheel[level][slot])) {
+		wheel_unlink(timer);
+		wheel_insert(timer);
+	}
+}
+
+static void tick(void) {
+	for (int level = WHEEL_LEVELS - 1; level > 0; --level) {
+		if ((wheel_now & ((1ULL << (WHEEL_BITS * level)) - 1)) == 0) {
+			cascade(level, (wheel_now >> (WHEEL_BITS * level)) & WHEEL_MASK);
+		}
+	}
+
+	// Taken one at a time, a callback may cancel others in the same slot
+	int slot = wheel_now & WHEEL_MASK;
+	struct timer *timer;
+	while ((timer = wheel[0][slot])) {
+		wheel_unlink(timer);
+		timer->callback(timer->arg);
+	}
+}
+
+void timer_init(struct timer *timer, timer_callback callback, void *arg) {
+	timer->expires = 0;
+	timer->callback = callback;
+	timer->arg = arg;
+	timer->level = -1;
+	timer->slot = 0;
+	timer->next = timer->prev = NULL;
+}
+
+void timer_schedule(struct timer *timer, uint64_t delay_ms) {
+	uint64_t now = monotonic_ms();
+
+	// An idle wheel has nothing to catch up on
+	if (!wheel_started || n_timers == 0) {
+		wheel_now = now;
+		wheel_started = 1;
+	}
+
+	timer_cancel(timer);
+	timer->expires = now + delay_ms;
+	wheel_insert(timer);
+}
+
+void timer_cancel(struct timer *timer) {
+	if (timer->level >= 0) {
+		wheel_unlink(timer);
+	}
+}
+
+int timer_pending(struct timer *timer) {
+	return timer->level >= 0;
+}
+
+void timers_run(void) {
+	uint64_t now = monotonic_ms();
+
+	while (wheel_now < now && n_timers > 0) {
+		// Nothing due on level 0, skip ahead to the next cascade point
+		if (!occupied[0]) {
+			uint64_t boundary = wheel_now | WHEEL_MASK;
+			if (boundary >= now) {
+				wheel_now = now;
+				break;
+			}
+			wheel_now = boundary;
+		}
+
+		wheel_now++;
+		tick();
+	}
+
+	if (wheel_now < now && n_timers == 0) {
+		wheel_now = now;
+	}
+}
+
+int64_t timers_next_timeout(void) {
+	if (n_timers == 0) {
+		return -1;
+	}
+
+	// The first occupied slot after the current one holds each level's earliest timers
+	uint64_t next = UINT64_MAX;
+	for (int level = 0; level < WHEEL_LEVELS; ++level) {
+		if (!occupied[level]) {
+			continue;
+		}
+
+		int current = (wheel_now >> (WHEEL_BITS * level)) & WHEEL_MASK;
+		for (int i = 1; i <= WHEEL_SLOTS; ++i) {
+			int slot = (current + i) & WHEEL_MASK;
+			if (occupied[level] & (1ULL << slot)) {
+				// Level 0 slots fire on their own tick, no need to walk them
+				uint64_t slot_start = ((wheel_now >> (WHEEL_BITS * level)) + i) << (WHEEL_BITS * level);
+				if (level == 0 || slot_start >= next) {
+					next = slot_start < next ? slot_start : next;
+					break;
+				}
+				for (struct timer *timer = wheel[level][slot]; timer; timer = timer->next) {
+					if (timer->expires < next) {
+						next = timer->expires;
+					}
+				}
+				break;
+			}
+		}
+	}
+
+	uint64_t now = monotonic_ms();
+	return next > now ? (int64_t)(next - now) : 0;
+}
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <endian.h>
+#include <sys/stat.h>
+#include <arpa/inet.h>
+
+#include "chord_impl.h"
+#include "chord_trace.h"
+
+static int trace_fd = -1;
+static double trace_rate = 0;
+static uint64_t rng = 0;
+
+static uint64_t realtime_us(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+// xorshift64*, seeded per process so trace ids of different nodes do not collide
+static uint64_t next_random(void) {
+	rng ^= rng >> 12;
+	rng ^= rng << 25;
+	rng ^= rng >> 27;
+	return rng * 0x2545F4914F6CDD1DULL;
+}
+
+int trace_open(const char *path, double rate) {
+	trace_fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+	if (trace_fd < 0) {
+		perror("Failed to open trace log");
+		return -1;
+	}
+
+	struct stat st;
+	if (fstat(trace_fd, &st) == 0 && st.st_size == 0
+		&& write(trace_fd, TRACE_MAGIC, TRACE_MAGIC_LEN) != TRACE_MAGIC_LEN) {
+		perror("Failed to write trace log");
+		close(trace_fd);
+		trace_fd = -1;
+		return -1;
+	}
+
+	trace_rate = rate;
+	rng = realtime_us() ^ ((uint64_t)getpid() << 32) ^ 0x9E3779B97F4A7C15ULL;
+	return 0;
+}
+
+void trace_close(void) {
+	if (trace_fd >= 0) {
+		close(trace_fd);
+		trace_fd = -1;
+	}
+}
+
+uint64_t trace_sample(void) {
+	if (trace_fd < 0 || (next_random() >> 11) * 0x1.0p-53 >= trace_rate) {
+		return 0;
+	}
+
+	uint64_t id;
+	while ((id = next_random()) == 0) {
+	}
+	return id;
+}
+
+void trace_attach(ChordMessage *msg, TraceContext *context, uint64_t trace_id, int hop) {
+	*context = (TraceContext) TRACE_CONTEXT__INIT;
+	context->trace_id = trace_id;
+	context->hop = hop;
+	context->sent_us = realtime_us();
+	msg->trace = context;
+}
+
+// One write() per record, appends of this size are not interleaved between threads
+static void write_record(uint64_t trace_id, enum trace_event event, int hop, uint64_t key, uint64_t node,
+                         uint64_t sent_us, uint32_t peer_address, uint32_t peer_port) {
+	struct trace_record record = {
+		.trace_id = htole64(trace_id),
+		.time_us = htole64(realtime_us()),
+		.key = htole64(key),
+		.node = htole64(node),
+		.sent_us = htole64(sent_us),
+		.peer_address = peer_address,
+		.peer_port = (uint16_t)peer_port,
+		.event = event,
+		.hop = hop < 255 ? hop : 255,
+	};
+
+	if (write(trace_fd, &record, sizeof(record)) != sizeof(record)) {
+		perror("Failed to write trace log");
+	}
+}
+
+void trace_log(uint64_t trace_id, enum trace_event event, int hop, uint64_t key, const Node *peer) {
+	if (trace_fd < 0 || trace_id == 0) {
+		return;
+	}
+	write_record(trace_id, event, hop, key, self.key, 0, peer ? peer->address : 0, peer ? peer->port : 0);
+}
+
+void trace_received(ChordMessage *message, const struct sockaddr_in *from, uint64_t node) {
+	if (trace_fd < 0 || !message->trace) {
+		return;
+	}
+
+	uint64_t key = message->msg_case == CHORD_MESSAGE__MSG_FIND_SUCCESSOR_REQUEST
+		? message->find_successor_request->key : 0;
+	write_record(message->trace->trace_id, TRACE_RECEIVED, message->trace->hop, key, node,
+	             message->trace->sent_us, from->sin_addr.s_addr, from->sin_port);
+}
@@ -0,0 +1,270 @@
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+
+#include "chord.h"
+#include "chord_arg_parser.h"
+#include "chord_impl.h"
+#include "chord_vnode.h"
+#include "hash.h"
+#include "chord.pb-c.h"
+
+static struct vnode_state *vnodes = NULL;
+static int n_vnodes = 0;
+static int active = 0;
+
+// Indices ordered by key for vnode_find(), fixed once set up
+static int *by_key = NULL;
+
+// Activated since vnode_take_touched() last ran, as a list and as flags
+static int *touched = NULL;
+static int *taken = NULL;
+static unsigned char *is_touched = NULL;
+static int n_touched = 0;
+
+static void touch(int index) {
+	if (!is_touched[index]) {
+		is_touched[index] = 1;
+		touched[n_touched++] = index;
+	}
+}
+
+// Copies the globals in and out of a virtual node's slot. Keys never change,
+// saving leaves them alone so other threads may read them with vnode_find()
+static void save(struct vnode_state *state) {
+	state->predecessor = predecessor;
+	state->successor = successor;
+	state->finger_table = finger_table;
+	state->successor_list = successor_list;
+	state->fixIndex = fixIndex;
+	state->succListIndex = succListIndex;
+	state->joined = joined;
+	state->stabilize_in_flight = stabilize_in_flight;
+	state->fix_fingers_in_flight = fix_fingers_in_flight;
+	state->check_predecessor_in_flight = check_predecessor_in_flight;
+	state->checked_predecessor = checked_predecessor;
+}
+
+static void load(const struct vnode_state *state) {
+	hash = state->hash;
+	self = state->self;
+	predecessor = state->predecessor;
+	successor = state->successor;
+	finger_table = state->finger_table;
+	successor_list = state->successor_list;
+	fixIndex = state->fixIndex;
+	succListIndex = state->succListIndex;
+	joined = state->joined;
+	stabilize_in_flight = state->stabilize_in_flight;
+	fix_fingers_in_flight = state->fix_fingers_in_flight;
+	check_predecessor_in_flight = state->check_predecessor_in_flight;
+	checked_predecessor = state->checked_predecessor;
+}
+
+// Virtual node i > 0 hashes the same address as node 0 with its index as salt
+static uint64_t salted_hash(struct sockaddr_in *addr, int index) {
+	// The salt goes first, as a salted sha1sum context would hash it
+	uint8_t buffer[10] = {index >> 24, index >> 16, index >> 8, index};
+	memcpy(buffer + 4, &addr->sin_addr.s_addr, 4);
+	memcpy(buffer + 8, &addr->sin_port, 2);
+
+	return sha1sum_head(buffer, sizeof(buffer));
+}
+
+static const struct vnode_state *sort_vnodes = NULL;
+
+static int compare_keys(const void *a, const void *b) {
+	uint64_t x = sort_vnodes[*(const int *)a].hash, y = sort_vnodes[*(const int *)b].hash;
+	return (x > y) - (x < y);
+}
+
+// Everything but the keys and addresses, which the callers fill in first
+static int setup(int count) {
+	by_key = malloc(sizeof(int) * count);
+	touched = malloc(sizeof(int) * count);
+	taken = malloc(sizeof(int) * count);
+	is_touched = calloc(count, 1);
+	if (!by_key || !touched || !taken || !is_touched) {
+		return -1;
+	}
+
+	for (int i = 0; i < count; ++i) {
+		struct vnode_state *state = &vnodes[i];
+		if (state->hash == 0) {
+			return -1;
+		}
+		by_key[i] = i;
+
+		state->self.key = state->hash;
+		state->predecessor = (Node) NODE__INIT;
+		state->successor = (Node) NODE__INIT;
+		state->checked_predecessor = (Node) NODE__INIT;
+		state->succListIndex = 1;
+
+		state->finger_table = malloc(sizeof(Node) * M);
+		state->successor_list = malloc(sizeof(Node) * chord_args.num_successors);
+		if (!state->finger_table || !state->successor_list) {
+			return -1;
+		}
+		for (int j = 0; j < M; ++j) {
+			state->finger_table[j] = (Node) NODE__INIT;
+		}
+		for (int j = 0; j < chord_args.num_successors; ++j) {
+			state->successor_list[j] = (Node) NODE__INIT;
+		}
+	}
+
+	sort_vnodes = vnodes;
+	qsort(by_key, count, sizeof(int), compare_keys);
+
+	// Every node needs a first snapshot before it can answer anything
+	for (int i = 0; i < count; ++i) {
+		touch(i);
+	}
+
+	active = 0;
+	load(&vnodes[0]);
+	return 0;
+}
+
+int vnode_init(int count, struct sockaddr_in *addr, uint64_t key) {
+	vnodes = calloc(count, sizeof(struct vnode_state));
+	if (!vnodes) {
+		return -1;
+	}
+	n_vnodes = count;
+
+	for (int i = 0; i < count; ++i) {
+		vnodes[i].hash = i == 0 ? key : salted_hash(addr, i);
+		vnodes[i].self = (Node) NODE__INIT;
+		vnodes[i].self.address = addr->sin_addr.s_addr;
+		vnodes[i].self.port = addr->sin_port;
+	}
+	return setup(count);
+}
+
+int vnode_init_hosts(int count, const struct sockaddr_in *addrs) {
+	vnodes = calloc(count, sizeof(struct vnode_state));
+	if (!vnodes) {
+		return -1;
+	}
+	n_vnodes = count;
+
+	for (int i = 0; i < count; ++i) {
+		struct sockaddr_in addr = addrs[i];
+		vnodes[i].hash = get_hash(&addr);
+		vnodes[i].self = (Node) NODE__INIT;
+		vnodes[i].self.address = addr.sin_addr.s_addr;
+		vnodes[i].self.port = addr.sin_port;
+	}
+	return setup(count);
+}
+
+void vnode_destroy(void) {
+	if (!vnodes || !finger_table) {
+		return;
+	}
+
+	// The keys stay, workers may still be looking them up while we exit
+	save(&vnodes[active]);
+	for (int i = 0; i < n_vnodes; ++i) {
+		free(vnodes[i].finger_table);
+		free(vnodes[i].successor_list);
+		vnodes[i].finger_table = vnodes[i].successor_list = NULL;
+	}
+	finger_table = NULL;
+	successor_list = NULL;
+}
+
+void vnode_reset(void) {
+	// A setup that ran out of memory leaves some tables behind
+	for (int i = 0; vnodes && i < n_vnodes; ++i) {
+		free(vnodes[i].finger_table);
+		free(vnodes[i].successor_list);
+	}
+	free(vnodes);
+	free(by_key);
+	free(touched);
+	free(taken);
+	free(is_touched);
+	vnodes = NULL;
+	by_key = touched = taken = NULL;
+	is_touched = NULL;
+	n_vnodes = n_touched = active = 0;
+	finger_table = NULL;
+	successor_list = NULL;
+}
+
+int vnode_count(void) {
+	return n_vnodes;
+}
+
+int vnode_active(void) {
+	return active;
+}
+
+void vnode_activate(int index) {
+	if (index == active) {
+		return;
+	}
+
+	save(&vnodes[active]);
+	load(&vnodes[index]);
+	active = index;
+	touch(index);
+}
+
+int vnode_find(uint64_t key) {
+	int low = 0, high = n_vnodes;
+	while (low < high) {
+		int mid = low + (high - low) / 2;
+		if (vnodes[by_key[mid]].hash < key) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+	return low < n_vnodes && vnodes[by_key[low]].hash == key ? by_key[low] : -1;
+}
+
+int vnode_for_message(ChordMessage *message) {
+	int index = message->has_target ? vnode_find(message->target) : 0;
+	return index >= 0 ? index : 0;
+}
+
+int vnode_is_local(const Node *node) {
+	// Every virtual node shares the address, node 0's copy never changes
+	return node->address == vnodes[0].self.address && node->port == vnodes[0].self.port;
+}
+
+const struct vnode_state *vnode_get(int index) {
+	save(&vnodes[active]);
+	return &vnodes[index];
+}
+
+const int *vnode_take_touched(int *n) {
+	save(&vnodes[active]);
+
+	// The list handed out becomes the spare, a fresh one starts with the active node
+	int *list = touched;
+	*n = n_touched;
+	for (int i = 0; i < n_touched; ++i) {
+		is_touched[list[i]] = 0;
+	}
+
+	touched = taken;
+	taken = list;
+	n_touched = 0;
+	touch(active);
+	return list;
+}
+
+int vnode_all_joined(void) {
+	save(&vnodes[active]);
+	for (int i = 0; i < n_vnodes; ++i) {
+		if (!vnodes[i].joined) {
+			return 0;
+		}
+	}
+	return 1;
+}
@@ -0,0 +1,303 @@
+#include <string.h>
+#include <endian.h>
+
+#include "chord_wire.h"
+
+static size_t body_size(int type) {
+	switch (type) {
+	case CHORD_MESSAGE__MSG_NOTIFY_REQUEST:
+	case CHORD_MESSAGE__MSG_GET_PREDECESSOR_RESPONSE:
+		return WIRE_NODE_SIZE;
+	case CHORD_MESSAGE__MSG_FIND_SUCCESSOR_REQUEST:
+	case CHORD_MESSAGE__MSG_FIND_SUCCESSOR_RESPONSE:
+		return sizeof(uint64_t) + WIRE_NODE_SIZE;
+	case CHORD_MESSAGE__MSG_NOTIFY_RESPONSE:
+	case CHORD_MESSAGE__MSG_GET_PREDECESSOR_REQUEST:
+	case CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_REQUEST:
+	case CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_RESPONSE:
+		return 0;
+	default:
+		return SIZE_MAX;
+	}
+}
+
+size_t wire_compact_size(ChordMessage__MsgCase type) {
+	size_t body = body_size(type);
+	return body == SIZE_MAX ? 0 : WIRE_HEADER_SIZE + body;
+}
+
+int wire_compact_encodable(const ChordMessage *msg) {
+	// Traced requests keep their context, which only protobuf carries
+	return msg->version == 417 && !msg->trace && wire_compact_size(msg->msg_case) != 0;
+}
+
+static void put_u64(uint8_t *out, uint64_t value) {
+	value = htobe64(value);
+	memcpy(out, &value, sizeof(value));
+}
+
+static uint64_t get_u64(const uint8_t *in) {
+	uint64_t value;
+	memcpy(&value, in, sizeof(value));
+	return be64toh(value);
+}
+
+static void put_node(uint8_t *out, const Node *node) {
+	uint16_t port = (uint16_t)node->port;
+
+	put_u64(out, node->key);
+	memcpy(out + 8, &node->address, sizeof(uint32_t));
+	memcpy(out + 12, &port, sizeof(port));
+}
+
+static void get_node(const uint8_t *in, Node *node) {
+	uint16_t port;
+
+	*node = (Node) NODE__INIT;
+	node->key = get_u64(in);
+	memcpy(&node->address, in + 8, sizeof(uint32_t));
+	memcpy(&port, in + 12, sizeof(port));
+	node->port = port;
+}
+
+void wire_compact_pack(const ChordMessage *msg, uint8_t *out) {
+	uint8_t flags = (msg->has_query_id ? WIRE_FLAG_QUERY_ID : 0) | (msg->has_target ? WIRE_FLAG_TARGET : 0);
+	uint32_t query_id = htobe32((uint32_t)msg->query_id);
+	uint8_t *body = out + WIRE_HEADER_SIZE;
+
+	switch (msg->msg_case) {
+	case CHORD_MESSAGE__MSG_NOTIFY_REQUEST:
+		put_node(body, msg->notify_request->node);
+		break;
+	case CHORD_MESSAGE__MSG_GET_PREDECESSOR_RESPONSE:
+		put_node(body, msg->get_predecessor_response->node);
+		break;
+	case CHORD_MESSAGE__MSG_FIND_SUCCESSOR_REQUEST: {
+		const FindSuccessorRequest *request = msg->find_successor_request;
+		Node none = NODE__INIT;
+
+		flags |= (request->requester ? WIRE_FLAG_REQUESTER : 0) | (request->has_probe && request->probe ? WIRE_FLAG_PROBE : 0);
+		put_u64(body, request->key);
+		put_node(body + 8, request->requester ? request->requester : &none);
+		break;
+	}
+	case CHORD_MESSAGE__MSG_FIND_SUCCESSOR_RESPONSE: {
+		const FindSuccessorResponse *response = msg->find_successor_response;
+
+		flags |= response->has_key ? WIRE_FLAG_KEY : 0;
+		put_node(body, response->node);
+		put_u64(body + WIRE_NODE_SIZE, response->has_key ? response->key : 0);
+		break;
+	}
+	default:
+		break;
+	}
+
+	out[0] = WIRE_COMPACT_MAGIC;
+	out[1] = (uint8_t)msg->msg_case;
+	out[2] = flags;
+	out[3] = msg->has_features ? (uint8_t)msg->features : 0;
+	memcpy(out + 4, &query_id, sizeof(query_id));
+	put_u64(out + 8, msg->has_target ? msg->target : 0);
+}
+
+size_t wire_compact_frame(const uint8_t *data, size_t len) {
+	if (len < WIRE_HEADER_SIZE || data[0] != WIRE_COMPACT_MAGIC) {
+		return 0;
+	}
+
+	size_t size = wire_compact_size(data[1]);
+	return size != 0 && size <= len ? size : 0;
+}
+
+ChordMessage *wire_compact_unpack(const uint8_t *frame, size_t len, struct arena *arena) {
+	if (wire_compact_frame(frame, len) != len) {
+		return NULL;
+	}
+
+	ChordMessage *message = arena_alloc(arena, sizeof(*message));
+	if (!message) {
+		return NULL;
+	}
+	*message = (ChordMessage) CHORD_MESSAGE__INIT;
+
+	uint8_t flags = frame[2];
+	uint32_t query_id;
+	memcpy(&query_id, frame + 4, sizeof(query_id));
+
+	message->has_query_id = (flags & WIRE_FLAG_QUERY_ID) != 0;
+	message->query_id = (int32_t)be32toh(query_id);
+	message->has_target = (flags & WIRE_FLAG_TARGET) != 0;
+	message->target = get_u64(frame + 8);
+	message->has_features = 1;
+	message->features = frame[3];
+	message->msg_case = frame[1];
+
+	const uint8_t *body = frame + WIRE_HEADER_SIZE;
+	Node *node = NULL;
+	if (body_size(message->msg_case) >= WIRE_NODE_SIZE) {
+		node = arena_alloc(arena, sizeof(*node));
+		if (!node) {
+			return NULL;
+		}
+	}
+
+	switch (message->msg_case) {
+	case CHORD_MESSAGE__MSG_NOTIFY_REQUEST: {
+		NotifyRequest *request = arena_alloc(arena, sizeof(*request));
+		if (!request) {
+			return NULL;
+		}
+		*request = (NotifyRequest) NOTIFY_REQUEST__INIT;
+		get_node(body, node);
+		request->node = node;
+		message->notify_request = request;
+		break;
+	}
+	case CHORD_MESSAGE__MSG_GET_PREDECESSOR_RESPONSE: {
+		GetPredecessorResponse *response = arena_alloc(arena, sizeof(*response));
+		if (!response) {
+			return NULL;
+		}
+		*response = (GetPredecessorResponse) GET_PREDECESSOR_RESPONSE__INIT;
+		get_node(body, node);
+		response->node = node;
+		message->get_predecessor_response = response;
+		break;
+	}
+	case CHORD_MESSAGE__MSG_FIND_SUCCESSOR_REQUEST: {
+		FindSuccessorRequest *request = arena_alloc(arena, sizeof(*request));
+		if (!request) {
+			return NULL;
+		}
+		*request = (FindSuccessorRequest) FIND_SUCCESSOR_REQUEST__INIT;
+		request->key = get_u64(body);
+		if (flags & WIRE_FLAG_REQUESTER) {
+			get_node(body + 8, node);
+			request->requester = node;
+		}
+		if (flags & WIRE_FLAG_PROBE) {
+			request->has_probe = 1;
+			request->probe = 1;
+		}
+		message->find_successor_request = request;
+		break;
+	}
+	case CHORD_MESSAGE__MSG_FIND_SUCCESSOR_RESPONSE: {
+		FindSuccessorResponse *response = arena_alloc(arena, sizeof(*response));
+		if (!response) {
+			return NULL;
+		}
+		*response = (FindSuccessorResponse) FIND_SUCCESSOR_RESPONSE__INIT;
+		get_node(body, node);
+		response->node = node;
+		if (flags & WIRE_FLAG_KEY) {
+			response->has_key = 1;
+			response->key = get_u64(body + WIRE_NODE_SIZE);
+		}
+		message->find_successor_response = response;
+		break;
+	}
+	case CHORD_MESSAGE__MSG_NOTIFY_RESPONSE: {
+		NotifyResponse *response = arena_alloc(arena, sizeof(*response));
+		if (!response) {
+			return NULL;
+		}
+		*response = (NotifyResponse) NOTIFY_RESPONSE__INIT;
+		message->notify_response = response;
+		break;
+	}
+	case CHORD_MESSAGE__MSG_GET_PREDECESSOR_REQUEST: {
+		GetPredecessorRequest *request = arena_alloc(arena, sizeof(*request));
+		if (!request) {
+			return NULL;
+		}
+		*request = (GetPredecessorRequest) GET_PREDECESSOR_REQUEST__INIT;
+		message->get_predecessor_request = request;
+		break;
+	}
+	case CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_REQUEST: {
+		CheckPredecessorRequest *request = arena_alloc(arena, sizeof(*request));
+		if (!request) {
+			return NULL;
+		}
+		*request = (CheckPredecessorRequest) CHECK_PREDECESSOR_REQUEST__INIT;
+		message->check_predecessor_request = request;
+		break;
+	}
+	case CHORD_MESSAGE__MSG_CHECK_PREDECESSOR_RESPONSE: {
+		CheckPredecessorResponse *response = arena_alloc(arena, sizeof(*response));
+		if (!response) {
+			return NULL;
+		}
+		*response = (CheckPredecessorResponse) CHECK_PREDECESSOR_RESPONSE__INIT;
+		message->check_predecessor_response = response;
+		break;
+	}
+	default:
+		return NULL;
+	}
+
+	return message;
+}
+
+// Reads the varint at *pos, 0 if it runs past the end
+static int get_varint(const uint8_t *data, size_t len, size_t *pos, uint64_t *value) {
+	*value = 0;
+	for (int shift = 0; shift < 64 && *pos < len; shift += 7) {
+		uint8_t byte = data[(*pos)++];
+		*value |= (uint64_t)(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+ChordMessage__MsgCase wire_peek_type(const uint8_t *frame, size_t len) {
+	if (len > 0 && frame[0] == WIRE_COMPACT_MAGIC) {
+		return len >= WIRE_HEADER_SIZE ? frame[1] : CHORD_MESSAGE__MSG__NOT_SET;
+	}
+
+	// The first top-level field that belongs to the oneof is the message
+	size_t pos = 0;
+	while (pos < len) {
+		uint64_t tag, skip;
+		if (!get_varint(frame, len, &pos, &tag) || tag >> 3 > UINT32_MAX) {
+			break;
+		}
+
+		const ProtobufCFieldDescriptor *field =
+			protobuf_c_message_descriptor_get_field(&chord_message__descriptor, (unsigned)(tag >> 3));
+		if (field && (field->flags & PROTOBUF_C_FIELD_FLAG_ONEOF)) {
+			return field->id;
+		}
+
+		switch (tag & 7) {
+		case PROTOBUF_C_WIRE_TYPE_VARINT:
+			if (!get_varint(frame, len, &pos, &skip)) {
+				return CHORD_MESSAGE__MSG__NOT_SET;
+			}
+			continue;
+		case PROTOBUF_C_WIRE_TYPE_64BIT:
+			skip = 8;
+			break;
+		case PROTOBUF_C_WIRE_TYPE_32BIT:
+			skip = 4;
+			break;
+		case PROTOBUF_C_WIRE_TYPE_LENGTH_PREFIXED:
+			if (!get_varint(frame, len, &pos, &skip)) {
+				return CHORD_MESSAGE__MSG__NOT_SET;
+			}
+			break;
+		default:
+			return CHORD_MESSAGE__MSG__NOT_SET;
+		}
+
+		if (skip > len - pos) {
+			break;
+		}
+		pos += skip;
+	}
+	return CHORD_MESSAGE__MSG__NOT_SET;
+}
@@ -0,0 +1,256 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+
+#include "chord_worker.h"
+#include "chord_routing.h"
+#include "chord_rpc.h"
+#include "chord_trace.h"
+#include "chord_vnode.h"
+#include "chord.pb-c.h"
+
+// A frame a worker could not answer, queued for the main thread
+struct handoff {
+	struct handoff *next;
+	struct sockaddr_in from;
+	size_t len;
+	uint8_t data[];
+};
+
+struct worker {
+	pthread_t thread;
+	int fd;
+};
+
+static struct worker *workers;
+static int n_running = 0;
+static int wake_fd = -1;
+static int stop_fd = -1;            // Readable once workers_stop() asks every worker to exit
+
+// FIFO of handed off frames, guarded by handoff_lock
+static pthread_mutex_t handoff_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct handoff *handoff_head, *handoff_tail;
+
+static void hand_off(struct sockaddr_in *from, const uint8_t *frame, size_t frame_len) {
+	struct handoff *item = malloc(sizeof(*item) + frame_len);
+	if (!item) {
+		return;
+	}
+
+	item->next = NULL;
+	item->from = *from;
+	item->len = frame_len;
+	memcpy(item->data, frame, frame_len);
+
+	pthread_mutex_lock(&handoff_lock);
+	int was_empty = handoff_head == NULL;
+	if (handoff_tail) {
+		handoff_tail->next = item;
+	} else {
+		handoff_head = item;
+	}
+	handoff_tail = item;
+	pthread_mutex_unlock(&handoff_lock);
+
+	// The main thread takes the whole queue per wakeup, one signal per batch is enough
+	if (was_empty) {
+		uint64_t one = 1;
+		if (write(wake_fd, &one, sizeof(one)) < 0) {
+			perror("Error waking main thread");
+		}
+	}
+}
+
+static void *worker_main(void *arg) {
+	struct worker *worker = arg;
+
+	if (rpc_init(worker->fd) != 0 || routing_reader_register() != 0) {
+		fprintf(stderr, "Failed to set up worker\n");
+		return NULL;
+	}
+
+	int epfd = epoll_create1(0);
+	struct epoll_event event = {.events = EPOLLIN, .data.fd = worker->fd};
+	epoll_ctl(epfd, EPOLL_CTL_ADD, worker->fd, &event);
+	struct epoll_event stop_event = {.events = EPOLLIN, .data.fd = stop_fd};
+	epoll_ctl(epfd, EPOLL_CTL_ADD, stop_fd, &stop_event);
+	int want_output = 0;
+
+	while (1) {
+		// Only wait for writability while a backlog is queued
+		if (rpc_output_pending() != want_output) {
+			want_output = !want_output;
+			event.events = EPOLLIN | (want_output ? EPOLLOUT : 0);
+			epoll_ctl(epfd, EPOLL_CTL_MOD, worker->fd, &event);
+		}
+
+		struct epoll_event ready;
+		if (epoll_wait(epfd, &ready, 1, -1) < 0) {
+			continue;
+		}
+		if (ready.data.fd == stop_fd) {
+			break; // Never read, so it wakes every worker
+		}
+
+		// The whole batch is answered from one set of pinned snapshots
+		size_t received = recv_batch();
+		routing_acquire();
+
+		// In class order like the main thread, a shed request is not handed off either
+		for (int class = 0; class < RPC_CLASSES; ++class) {
+			for (size_t i = 0; i < received; ++i) {
+				struct sockaddr_in from;
+				const uint8_t *frame;
+				size_t frame_len;
+				size_t offset = 0;
+
+				while (recv_frame(i, &offset, &from, &frame, &frame_len)) {
+					if (rpc_frame_class(frame, frame_len) != (enum rpc_class)class) {
+						continue;
+					}
+
+					ChordMessage *message = decode_message(frame, frame_len);
+					if (!message) {
+						break;
+					}
+					rpc_received(message, &from); // Once, frames handed off are not counted again
+
+					if (rpc_shed(i, message, &from)) {
+						release_message();
+						continue;
+					}
+
+					const struct routing_snapshot *snapshot = routing_pinned(vnode_for_message(message));
+					if (answer_query(message, &from, snapshot)) {
+						trace_received(message, &from, snapshot->self.key);
+					} else {
+						hand_off(&from, frame, frame_len);
+					}
+					release_message();
+				}
+			}
+		}
+
+		routing_release();
+		rpc_flush();
+	}
+
+	close(epfd);
+	rpc_destroy();
+	return NULL;
+}
+
+int workers_start(int n_workers, struct sockaddr_in *addr) {
+	wake_fd = eventfd(0, EFD_NONBLOCK);
+	stop_fd = eventfd(0, EFD_NONBLOCK);
+	if (wake_fd < 0 || stop_fd < 0) {
+		perror("Failed to create eventfd");
+		return -1;
+	}
+
+	workers = calloc(n_workers, sizeof(struct worker));
+	if (!workers) {
+		return -1;
+	}
+
+	for (int i = 0; i < n_workers; ++i) {
+		int fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		if (fd == -1) {
+			perror("Failed to create worker socket");
+			return -1;
+		}
+
+		int opt = 1;
+		setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+		setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt));
+
+		int flags = fcntl(fd, F_GETFL, 0);
+		fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+		if (bind(fd, (struct sockaddr *)addr, sizeof(*addr)) < 0) {
+			perror("Worker bind failed");
+			close(fd);
+			return -1;
+		}
+
+		workers[i].fd = fd;
+		if (pthread_create(&workers[i].thread, NULL, worker_main, &workers[i]) != 0) {
+			fprintf(stderr, "Failed to start worker thread\n");
+			close(fd);
+			return -1;
+		}
+		n_running++;
+	}
+
+	return 0;
+}
+
+void workers_stop(void) {
+	if (stop_fd >= 0) {
+		uint64_t one = 1;
+		if (write(stop_fd, &one, sizeof(one)) < 0) {
+			perror("Error stopping workers");
+		}
+	}
+
+	for (int i = 0; i < n_running; ++i) {
+		pthread_join(workers[i].thread, NULL);
+		close(workers[i].fd);
+	}
+	n_running = 0;
+	free(workers);
+	workers = NULL;
+
+	// Frames handed off and not yet drained are dropped, their senders retry
+	struct handoff *item = handoff_head;
+	while (item) {
+		struct handoff *next = item->next;
+		free(item);
+		item = next;
+	}
+	handoff_head = handoff_tail = NULL;
+
+	if (wake_fd >= 0) {
+		close(wake_fd);
+		wake_fd = -1;
+	}
+	if (stop_fd >= 0) {
+		close(stop_fd);
+		stop_fd = -1;
+	}
+}
+
+int workers_wake_fd(void) {
+	return n_running > 0 ? wake_fd : -1;
+}
+
+void workers_drain(handoff_handler handler) {
+	// Clears the signal, the queue is checked either way
+	uint64_t count;
+	ssize_t ignored = read(wake_fd, &count, sizeof(count));
+	(void)ignored;
+
+	pthread_mutex_lock(&handoff_lock);
+	struct handoff *item = handoff_head;
+	handoff_head = handoff_tail = NULL;
+	pthread_mutex_unlock(&handoff_lock);
+
+	while (item) {
+		struct handoff *next = item->next;
+
+		ChordMessage *message = decode_message(item->data, item->len);
+		if (message) {
+			handler(message, item->from);
+			release_message();
+		}
+
+		free(item);
+		item = next;
+	}
+}
@@ -96,3 +96,189 @@ uint64_t sha1sum_truncated_head(uint8_t *sha1_hash)
     return be64toh(truncated_sha1);
 }
 
+
+/* Self-contained SHA-1 for the context-free calls below. OpenSSL needs a
+ * heap-allocated EVP context per hash; keys are short enough that setting
+ * one up costs more than compressing them. */
+
+#ifdef __x86_64__
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+static inline uint32_t rol32(uint32_t x, int n) {
+	return (x << n) | (x >> (32 - n));
+}
+
+static void sha1_blocks_generic(uint32_t *state, const uint8_t *data, size_t blocks) {
+	for (; blocks > 0; --blocks, data += 64) {
+		uint32_t w[80];
+		for (int i = 0; i < 16; ++i) {
+			w[i] = (uint32_t)data[4 * i] << 24 | (uint32_t)data[4 * i + 1] << 16
+				| (uint32_t)data[4 * i + 2] << 8 | data[4 * i + 3];
+		}
+		for (int i = 16; i < 80; ++i) {
+			w[i] = rol32(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+		}
+
+		uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+		for (int i = 0; i < 80; ++i) {
+			uint32_t f, k;
+			if (i < 20) {
+				f = (b & c) | (~b & d);
+				k = 0x5A827999;
+			} else if (i < 40) {
+				f = b ^ c ^ d;
+				k = 0x6ED9EBA1;
+			} else if (i < 60) {
+				f = (b & c) | (b & d) | (c & d);
+				k = 0x8F1BBCDC;
+			} else {
+				f = b ^ c ^ d;
+				k = 0xCA62C1D6;
+			}
+			uint32_t t = rol32(a, 5) + f + e + k + w[i];
+			e = d;
+			d = c;
+			c = rol32(b, 30);
+			b = a;
+			a = t;
+		}
+
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+		state[4] += e;
+	}
+}
+
+#ifdef __x86_64__
+/* Four rounds per step: g is the step, 0 to 19. Each step consumes the
+ * schedule word MSG[g % 4] and advances the schedule of the ones after it. */
+#define SHA1_STEP(g, X, NEXT1, NEXT2, NEXT3, E_IN, E_OUT) do { \
+		E_IN = _mm_sha1nexte_epu32(E_IN, X); \
+		E_OUT = ABCD; \
+		if ((g) <= 18) NEXT1 = _mm_sha1msg2_epu32(NEXT1, X); \
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E_IN, (g) / 5); \
+		if ((g) <= 16) NEXT3 = _mm_sha1msg1_epu32(NEXT3, X); \
+		if ((g) <= 17) NEXT2 = _mm_xor_si128(NEXT2, X); \
+	} while (0)
+
+__attribute__((target("sha,sse4.1")))
+static void sha1_blocks_shani(uint32_t *state, const uint8_t *data, size_t blocks) {
+	const __m128i BSWAP = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+	__m128i ABCD = _mm_loadu_si128((const __m128i *)state);
+	__m128i E0 = _mm_set_epi32(state[4], 0, 0, 0);
+	ABCD = _mm_shuffle_epi32(ABCD, 0x1B);
+
+	for (; blocks > 0; --blocks, data += 64) {
+		__m128i ABCD_SAVE = ABCD, E0_SAVE = E0, E1;
+		__m128i MSG0, MSG1, MSG2, MSG3;
+
+		// Rounds 0-11, loading the block as the schedule starts
+		MSG0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 0)), BSWAP);
+		E0 = _mm_add_epi32(E0, MSG0);
+		E1 = ABCD;
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 0);
+
+		MSG1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16)), BSWAP);
+		E1 = _mm_sha1nexte_epu32(E1, MSG1);
+		E0 = ABCD;
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E1, 0);
+		MSG0 = _mm_sha1msg1_epu32(MSG0, MSG1);
+
+		MSG2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 32)), BSWAP);
+		E0 = _mm_sha1nexte_epu32(E0, MSG2);
+		E1 = ABCD;
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 0);
+		MSG1 = _mm_sha1msg1_epu32(MSG1, MSG2);
+		MSG0 = _mm_xor_si128(MSG0, MSG2);
+
+		MSG3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 48)), BSWAP);
+
+		// Rounds 12-79
+		SHA1_STEP(3, MSG3, MSG0, MSG1, MSG2, E1, E0);
+		SHA1_STEP(4, MSG0, MSG1, MSG2, MSG3, E0, E1);
+		SHA1_STEP(5, MSG1, MSG2, MSG3, MSG0, E1, E0);
+		SHA1_STEP(6, MSG2, MSG3, MSG0, MSG1, E0, E1);
+		SHA1_STEP(7, MSG3, MSG0, MSG1, MSG2, E1, E0);
+		SHA1_STEP(8, MSG0, MSG1, MSG2, MSG3, E0, E1);
+		SHA1_STEP(9, MSG1, MSG2, MSG3, MSG0, E1, E0);
+		SHA1_STEP(10, MSG2, MSG3, MSG0, MSG1, E0, E1);
+		SHA1_STEP(11, MSG3, MSG0, MSG1, MSG2, E1, E0);
+		SHA1_STEP(12, MSG0, MSG1, MSG2, MSG3, E0, E1);
+		SHA1_STEP(13, MSG1, MSG2, MSG3, MSG0, E1, E0);
+		SHA1_STEP(14, MSG2, MSG3, MSG0, MSG1, E0, E1);
+		SHA1_STEP(15, MSG3, MSG0, MSG1, MSG2, E1, E0);
+		SHA1_STEP(16, MSG0, MSG1, MSG2, MSG3, E0, E1);
+		SHA1_STEP(17, MSG1, MSG2, MSG3, MSG0, E1, E0);
+		SHA1_STEP(18, MSG2, MSG3, MSG0, MSG1, E0, E1);
+		SHA1_STEP(19, MSG3, MSG0, MSG1, MSG2, E1, E0);
+
+		E0 = _mm_sha1nexte_epu32(E0, E0_SAVE);
+		ABCD = _mm_add_epi32(ABCD, ABCD_SAVE);
+	}
+
+	ABCD = _mm_shuffle_epi32(ABCD, 0x1B);
+	_mm_storeu_si128((__m128i *)state, ABCD);
+	state[4] = _mm_extract_epi32(E0, 3);
+}
+#undef SHA1_STEP
+
+// 0 not checked yet, 1 no SHA extensions, 2 SHA extensions
+static int shani_support = 0;
+
+static int have_shani(void) {
+	int support = __atomic_load_n(&shani_support, __ATOMIC_RELAXED);
+	if (support == 0) {
+		unsigned int eax, ebx, ecx, edx;
+		int sse = __get_cpuid(1, &eax, &ebx, &ecx, &edx)
+			&& (ecx & bit_SSSE3) && (ecx & bit_SSE4_1);
+		int sha = __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_SHA);
+		support = sse && sha ? 2 : 1;
+		__atomic_store_n(&shani_support, support, __ATOMIC_RELAXED);
+	}
+	return support == 2;
+}
+#endif
+
+static void sha1_blocks(uint32_t *state, const uint8_t *data, size_t blocks) {
+#ifdef __x86_64__
+	if (have_shani()) {
+		sha1_blocks_shani(state, data, blocks);
+		return;
+	}
+#endif
+	sha1_blocks_generic(state, data, blocks);
+}
+
+uint64_t sha1sum_head(const uint8_t *payload, size_t len) {
+	uint32_t state[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+	size_t full = len / 64;
+	sha1_blocks(state, payload, full);
+
+	// Padding: 0x80, zeros, then the length in bits, in one or two blocks
+	uint8_t tail[128] = {0};
+	size_t rest = len - full * 64;
+	if (rest) {
+		memcpy(tail, payload + full * 64, rest);
+	}
+	tail[rest] = 0x80;
+	size_t tail_len = rest + 9 <= 64 ? 64 : 128;
+	uint64_t bits = (uint64_t)len * 8;
+	for (int i = 0; i < 8; ++i) {
+		tail[tail_len - 1 - i] = bits >> (8 * i);
+	}
+	sha1_blocks(state, tail, tail_len / 64);
+
+	return (uint64_t)state[0] << 32 | state[1];
+}
+
+void sha1sum_heads(const uint8_t *const *payloads, const size_t *lens, size_t n, uint64_t *out) {
+	for (size_t i = 0; i < n; ++i) {
+		out[i] = sha1sum_head(payloads[i], lens[i]);
+	}
+}
@@ -0,0 +1,242 @@
+// Trace stitcher: merges the trace logs of several nodes and prints every
+// sampled lookup as a timeline of its hops, slowest lookups first with -n.
+// Times are the wall clocks of the nodes that logged them, so events of
+// different nodes are only as well ordered as those clocks agree.
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <endian.h>
+#include <arpa/inet.h>
+
+#include "chord_trace.h"
+
+struct lookup {
+	size_t first;           // Records [first, first + n) of the sorted log
+	size_t n;
+	uint64_t start_us;      // Originator's clock, earliest record if it is missing
+	uint64_t duration_us;
+	enum trace_event outcome; // TRACE_LOOKUP_DONE, TRACE_LOOKUP_FAILED or 0 if not logged
+};
+
+static struct trace_record *records;
+static size_t n_records = 0, records_cap = 0;
+
+static void usage(const char *name) {
+	fprintf(stderr, "Usage: %s [-s min ms] [-n slowest] trace_log...\n", name);
+	exit(1);
+}
+
+static int read_log(const char *path) {
+	FILE *file = fopen(path, "rb");
+	if (!file) {
+		perror(path);
+		return -1;
+	}
+
+	char magic[TRACE_MAGIC_LEN];
+	if (fread(magic, 1, sizeof(magic), file) != sizeof(magic) || memcmp(magic, TRACE_MAGIC, TRACE_MAGIC_LEN) != 0) {
+		fprintf(stderr, "%s: not a trace log\n", path);
+		fclose(file);
+		return -1;
+	}
+
+	struct trace_record record;
+	while (fread(&record, sizeof(record), 1, file) == 1) {
+		if (n_records == records_cap) {
+			records_cap = records_cap ? records_cap * 2 : 4096;
+			records = realloc(records, sizeof(*records) * records_cap);
+			if (!records) {
+				fprintf(stderr, "Out of memory\n");
+				exit(1);
+			}
+		}
+
+		record.trace_id = le64toh(record.trace_id);
+		record.time_us = le64toh(record.time_us);
+		record.key = le64toh(record.key);
+		record.node = le64toh(record.node);
+		record.sent_us = le64toh(record.sent_us);
+		records[n_records++] = record;
+	}
+
+	fclose(file);
+	return 0;
+}
+
+static int by_trace_and_time(const void *a, const void *b) {
+	const struct trace_record *x = a, *y = b;
+	if (x->trace_id != y->trace_id) {
+		return x->trace_id < y->trace_id ? -1 : 1;
+	}
+	return (x->time_us > y->time_us) - (x->time_us < y->time_us);
+}
+
+static int by_duration(const void *a, const void *b) {
+	const struct lookup *x = a, *y = b;
+	return (x->duration_us < y->duration_us) - (x->duration_us > y->duration_us);
+}
+
+static struct lookup summarize(size_t first, size_t n) {
+	struct lookup lookup = {.first = first, .n = n, .start_us = records[first].time_us};
+	uint64_t end_us = records[first + n - 1].time_us;
+
+	for (size_t i = first; i < first + n; ++i) {
+		if (records[i].event == TRACE_LOOKUP_START) {
+			lookup.start_us = records[i].time_us;
+		} else if (records[i].event == TRACE_LOOKUP_DONE || records[i].event == TRACE_LOOKUP_FAILED) {
+			lookup.outcome = records[i].event;
+			end_us = records[i].time_us;
+		}
+	}
+	lookup.duration_us = end_us > lookup.start_us ? end_us - lookup.start_us : 0;
+	return lookup;
+}
+
+static const char *peer_name(const struct trace_record *record, char *buffer, size_t size) {
+	char ip[INET_ADDRSTRLEN];
+	struct in_addr addr = {.s_addr = record->peer_address};
+	inet_ntop(AF_INET, &addr, ip, sizeof(ip));
+	snprintf(buffer, size, "%s:%u", ip, ntohs(record->peer_port));
+	return buffer;
+}
+
+// Request the reply or timeout at index answers, sent by the same node to the same peer
+static const struct trace_record *request_of(const struct lookup *lookup, size_t index) {
+	const struct trace_record *answer = &records[index];
+	for (size_t i = index; i-- > lookup->first;) {
+		const struct trace_record *record = &records[i];
+		if (record->event == TRACE_HOP_SENT && record->node == answer->node && record->hop == answer->hop
+			&& record->peer_address == answer->peer_address && record->peer_port == answer->peer_port) {
+			return record;
+		}
+	}
+	return NULL;
+}
+
+static void print_lookup(const struct lookup *lookup) {
+	const struct trace_record *first = &records[lookup->first];
+	const char *outcome = lookup->outcome == TRACE_LOOKUP_DONE ? "found"
+		: lookup->outcome == TRACE_LOOKUP_FAILED ? "failed" : "incomplete";
+
+	printf("Trace %016" PRIx64 " key %" PRIu64 " %s in %.3f ms\n",
+	       first->trace_id, first->key, outcome, lookup->duration_us / 1000.0);
+
+	// The hop that waited longest on its peer is the one to look at
+	size_t slowest = SIZE_MAX;
+	uint64_t slowest_us = 0;
+	for (size_t i = lookup->first; i < lookup->first + lookup->n; ++i) {
+		const struct trace_record *request;
+		if ((records[i].event == TRACE_HOP_REPLY || records[i].event == TRACE_HOP_TIMEOUT
+			 || records[i].event == TRACE_HOP_BUSY)
+			&& (request = request_of(lookup, i)) && records[i].time_us - request->time_us >= slowest_us) {
+			slowest = i;
+			slowest_us = records[i].time_us - request->time_us;
+		}
+	}
+
+	for (size_t i = lookup->first; i < lookup->first + lookup->n; ++i) {
+		const struct trace_record *record = &records[i];
+		char peer[32];
+		double at_ms = ((int64_t)(record->time_us - lookup->start_us)) / 1000.0;
+
+		printf("  %+10.3f ms  %20" PRIu64 "  ", at_ms, record->node);
+		switch (record->event) {
+		case TRACE_LOOKUP_START:
+			printf("start\n");
+			break;
+		case TRACE_HOP_SENT:
+			printf("hop %u sent to %s\n", record->hop, peer_name(record, peer, sizeof(peer)));
+			break;
+		case TRACE_HOP_REPLY:
+		case TRACE_HOP_TIMEOUT:
+		case TRACE_HOP_BUSY: {
+			const struct trace_record *request = request_of(lookup, i);
+			printf("hop %u %s %s", record->hop, record->event == TRACE_HOP_REPLY ? "reply from"
+			       : record->event == TRACE_HOP_BUSY ? "busy reply from" : "timed out on",
+			       peer_name(record, peer, sizeof(peer)));
+			if (request) {
+				printf(" after %.3f ms", (record->time_us - request->time_us) / 1000.0);
+			}
+			printf("%s\n", i == slowest ? "  <- slowest" : "");
+			break;
+		}
+		case TRACE_RECEIVED:
+			printf("hop %u received from %s, %.3f ms after it was sent\n", record->hop,
+			       peer_name(record, peer, sizeof(peer)), ((int64_t)(record->time_us - record->sent_us)) / 1000.0);
+			break;
+		case TRACE_FORWARDED:
+			printf("hop %u forwarded to %s\n", record->hop, peer_name(record, peer, sizeof(peer)));
+			break;
+		case TRACE_LOOKUP_DONE:
+			printf("owner is %s after %u requests\n", peer_name(record, peer, sizeof(peer)), record->hop);
+			break;
+		case TRACE_LOOKUP_FAILED:
+			printf("failed after %u requests\n", record->hop);
+			break;
+		default:
+			printf("unknown event %u\n", record->event);
+		}
+	}
+	printf("\n");
+}
+
+int main(int argc, char *argv[]) {
+	double min_ms = 0;
+	size_t slowest = 0;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "s:n:h")) != -1) {
+		switch (opt) {
+		case 's': min_ms = atof(optarg); break;
+		case 'n': slowest = strtoul(optarg, NULL, 10); break;
+		default: usage(argv[0]);
+		}
+	}
+	if (optind >= argc) {
+		usage(argv[0]);
+	}
+
+	for (int i = optind; i < argc; ++i) {
+		if (read_log(argv[i]) != 0) {
+			return 1;
+		}
+	}
+	if (n_records == 0) {
+		return 0;
+	}
+	qsort(records, n_records, sizeof(*records), by_trace_and_time);
+
+	struct lookup *lookups = malloc(sizeof(*lookups) * n_records);
+	size_t n_lookups = 0;
+	if (!lookups) {
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	for (size_t first = 0, i = 1; i <= n_records; ++i) {
+		if (i == n_records || records[i].trace_id != records[first].trace_id) {
+			struct lookup lookup = summarize(first, i - first);
+			if (lookup.duration_us >= min_ms * 1000) {
+				lookups[n_lookups++] = lookup;
+			}
+			first = i;
+		}
+	}
+
+	if (slowest > 0) {
+		qsort(lookups, n_lookups, sizeof(*lookups), by_duration);
+		if (n_lookups > slowest) {
+			n_lookups = slowest;
+		}
+	}
+	for (size_t i = 0; i < n_lookups; ++i) {
+		print_lookup(&lookups[i]);
+	}
+
+	free(lookups);
+	free(records);
+	return 0;
+}